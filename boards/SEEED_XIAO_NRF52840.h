@@ -53,6 +53,12 @@ extern "C" {
 #define LEDS_ACTIVE_STATE           0  // XIAO LEDs are active low
 #define LED_BUILTIN                 LED_1  // Default built-in LED is the red one
 
+// LED sequencer patterns, bsp_board LED index per pattern
+#define LED_SEQ_BOOT_LED            0  // Red
+#define LED_SEQ_HEARTBEAT_LED       1  // Blue
+#define LED_SEQ_ANT_RX_LED          2  // Green
+#define LED_SEQ_DATA_LED            2  // Green
+
 // Button Definitions
 #define BUTTONS_NUMBER              0  // No built-in buttons on XIAO
 #define BUTTONS_LIST                {} // Empty as no buttons
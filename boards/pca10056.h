@@ -67,6 +67,12 @@ extern "C" {
 #define BSP_LED_2      15
 #define BSP_LED_3      16
 
+// LED sequencer patterns, bsp_board LED index per pattern
+#define LED_SEQ_BOOT_LED       0
+#define LED_SEQ_HEARTBEAT_LED  1
+#define LED_SEQ_ANT_RX_LED     3
+#define LED_SEQ_DATA_LED       3
+
 #define BUTTONS_NUMBER 4
 
 #define BUTTON_1       11
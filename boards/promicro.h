@@ -25,6 +25,13 @@ extern "C" {
 #define LED_3 BSP_LED_2
 #define LED_4 BSP_LED_3
 
+// LED sequencer patterns: one physical LED, the flashes share it with the
+// boot pattern and the heartbeat is left out
+#define LED_SEQ_BOOT_LED       0
+#define LED_SEQ_HEARTBEAT_LED  0xFF  // LED_SEQ_LED_NONE
+#define LED_SEQ_ANT_RX_LED     0
+#define LED_SEQ_DATA_LED       0
+
 // -----------------------------------------------------------------------------
 // Buttons (none onboard)
 // -----------------------------------------------------------------------------
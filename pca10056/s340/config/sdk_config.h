@@ -178,6 +178,10 @@
 // Keep timer settings (if used elsewhere)
 #define NRFX_TIMER_ENABLED 1
 #define NRFX_TIMER4_ENABLED 1  // Keep only if TIMER4 is needed
+#define NRFX_TIMER1_ENABLED 1  // Reed sensor debounce
+#define NRFX_TIMER2_ENABLED 1  // Reed sensor pulse counter
+#define NRFX_TIMER3_ENABLED 1  // Reed sensor pulse timestamps
+#define NRFX_PPI_ENABLED 1     // Reed sensor GPIOTE -> TIMER routing
 
 // Power bike profile related
 
@@ -4710,7 +4714,7 @@
 //==========================================================
 // <o> NRF_SDH_ANT_TOTAL_CHANNELS_ALLOCATED - Allocated ANT channels. 
 #ifndef NRF_SDH_ANT_TOTAL_CHANNELS_ALLOCATED
-#define NRF_SDH_ANT_TOTAL_CHANNELS_ALLOCATED 2
+#define NRF_SDH_ANT_TOTAL_CHANNELS_ALLOCATED 9
 #endif
 
 // <o> NRF_SDH_ANT_ENCRYPTED_CHANNELS - Encrypted ANT channels. 
@@ -4842,14 +4846,14 @@
 
 // <o> NRF_SDH_BLE_CENTRAL_LINK_COUNT - Maximum number of central links. 
 #ifndef NRF_SDH_BLE_CENTRAL_LINK_COUNT
-#define NRF_SDH_BLE_CENTRAL_LINK_COUNT 0
+#define NRF_SDH_BLE_CENTRAL_LINK_COUNT 1
 #endif
 
 // <o> NRF_SDH_BLE_TOTAL_LINK_COUNT - Total link count. 
 // <i> Maximum number of total concurrent connections using the default configuration.
 
 #ifndef NRF_SDH_BLE_TOTAL_LINK_COUNT
-#define NRF_SDH_BLE_TOTAL_LINK_COUNT 1
+#define NRF_SDH_BLE_TOTAL_LINK_COUNT 2
 #endif
 
 // <o> NRF_SDH_BLE_GAP_EVENT_LENGTH - GAP event length. 
@@ -0,0 +1,387 @@
+/**
+ * @file ant_aggregator.c
+ * @brief Implementation of the ANT+ Multi-Bike Aggregator
+ */
+
+#include "ant_aggregator.h"
+#include <string.h>
+#include "nrf_sdh_ant.h"
+#include "ant_parameters.h"
+#include "ant_interface.h"
+#include "ant_bpwr.h"
+#include "app_timer.h"
+#include "includes/timer_ticks.h"
+#include "nrf_log.h"
+#include "app_error.h"
+#include "ble_custom_config.h"
+#include "includes/deadline_timer.h"
+#include "includes/ble_bridge.h"
+
+#define TORQUE_POWER_NUM  40212u  // 128 * pi * 100, power = 128 pi * torque delta / period delta
+#define TORQUE_POWER_DEN  100u
+
+// Per-bike state
+static ant_agg_bike_t m_bikes[ANT_AGG_MAX_BIKES];
+static ant_bpwr_profile_t m_profiles[ANT_AGG_MAX_BIKES];
+static ant_bpwr_disp_cb_t m_disp_cbs[ANT_AGG_MAX_BIKES];
+
+static bool m_running = false;
+static uint8_t m_updated_mask = 0;
+
+// Single-shot retry for channels closed after search timeout
+static deadline_timer_id_t m_reopen_timer;
+
+static void ant_agg_evt_handler(ant_evt_t * p_ant_evt, void * p_context);
+static void ant_agg_bpwr_evt_handler(ant_bpwr_profile_t * p_profile, ant_bpwr_evt_t event);
+
+// One observer for all aggregator channels, dispatches by channel number
+NRF_SDH_ANT_OBSERVER(m_ant_agg_observer, ANT_BPWR_ANT_OBSERVER_PRIO, ant_agg_evt_handler, NULL);
+
+/**
+ * @brief Map an ANT channel to an aggregator slot
+ *
+ * @return Slot index, or ANT_AGG_MAX_BIKES if the channel is not ours
+ */
+static uint8_t slot_from_channel(uint8_t channel) {
+    if (channel < ANT_AGG_FIRST_CHANNEL || channel >= ANT_AGG_FIRST_CHANNEL + ANT_AGG_MAX_BIKES) {
+        return ANT_AGG_MAX_BIKES;
+    }
+    return channel - ANT_AGG_FIRST_CHANNEL;
+}
+
+/**
+ * @brief Open the channel of one slot
+ */
+static void open_slot(uint8_t slot) {
+    uint32_t err_code = ant_bpwr_disp_open(&m_profiles[slot]);
+    if (err_code != NRF_SUCCESS) {
+        NRF_LOG_ERROR("🚨 Aggregator: Failed to open channel for device %d: 0x%08X",
+                      m_bikes[slot].device_id, err_code);
+        return;
+    }
+    m_bikes[slot].channel_open = true;
+}
+
+/**
+ * @brief Timer handler reopening channels that timed out
+ *
+ * Runs once per closed channel event, and again only while a reopen fails.
+ */
+static void reopen_timer_handler(void * p_context) {
+    if (!m_running) {
+        return;
+    }
+
+    bool retry = false;
+    for (uint8_t slot = 0; slot < ANT_AGG_MAX_BIKES; slot++) {
+        if (m_bikes[slot].device_id != 0 && !m_bikes[slot].channel_open) {
+            NRF_LOG_INFO("🔄 Aggregator: Reopening channel for device %d", m_bikes[slot].device_id);
+            open_slot(slot);
+            retry |= !m_bikes[slot].channel_open;
+        }
+    }
+
+    if (retry) {
+        deadline_timer_start(m_reopen_timer, ANT_AGG_REOPEN_MS, NULL);
+    }
+}
+
+/**
+ * @brief Feed one power sample into the pipeline of a slot
+ */
+static void bike_sample(uint8_t slot, uint16_t power, uint8_t cadence) {
+    ant_agg_bike_t *p_bike = &m_bikes[slot];
+
+    cycling_data_pipeline_update(&p_bike->pipeline, power, cadence);
+    p_bike->last_rx_ticks = app_timer_cnt_get();
+    p_bike->has_data = true;
+    m_updated_mask |= (1 << slot);
+    ble_bridge_keep_alive();
+
+    NRF_LOG_DEBUG("🚴 Aggregator slot %d: %d W, %d RPM", slot,
+                  p_bike->pipeline.data.average_power, p_bike->pipeline.data.average_cadence);
+}
+
+/**
+ * @brief Average power between two wheel (0x11) or crank (0x12) torque pages
+ *
+ * Both pages use the same formula: power = 128 pi * delta torque / delta period,
+ * with torque in 1/32 Nm and period in 1/2048 s. The counters roll over.
+ *
+ * @return true if the page is a new event and p_power was set
+ */
+static bool torque_page_power(ant_agg_bike_t *p_bike, const ant_bpwr_page_torque_data_t *p_page,
+                              uint16_t *p_power) {
+    uint8_t d_events = (uint8_t)(p_page->update_event_count - p_bike->torque_event_count);
+    uint16_t d_period = (uint16_t)(p_page->period - p_bike->torque_period);
+    uint16_t d_torque = (uint16_t)(p_page->accumulated_torque - p_bike->torque_accumulated);
+    bool had_torque = p_bike->has_torque;
+
+    p_bike->torque_event_count = p_page->update_event_count;
+    p_bike->torque_period = p_page->period;
+    p_bike->torque_accumulated = p_page->accumulated_torque;
+    p_bike->has_torque = true;
+
+    if (!had_torque || d_events == 0) {
+        return false;  // First page, or a repeat of the last event
+    }
+
+    // Events without rotation, the rider is coasting
+    *p_power = (d_period == 0) ? 0 :
+               (uint16_t)(((uint32_t)d_torque * TORQUE_POWER_NUM) / ((uint32_t)d_period * TORQUE_POWER_DEN));
+    return true;
+}
+
+/**
+ * @brief BPWR profile event handler, shared by all slots
+ *
+ * Power-only meters send page 0x10, torque meters may send only the wheel
+ * (0x11) or crank (0x12) torque page. Power is taken from page 0x10 when the
+ * meter sends it, otherwise computed from consecutive torque pages.
+ */
+static void ant_agg_bpwr_evt_handler(ant_bpwr_profile_t * p_profile, ant_bpwr_evt_t event) {
+    uint8_t slot = (uint8_t)(p_profile - m_profiles);
+    if (slot >= ANT_AGG_MAX_BIKES) {
+        return;
+    }
+
+    ant_agg_bike_t *p_bike = &m_bikes[slot];
+    uint16_t power;
+
+    switch (event) {
+        case ANT_BPWR_PAGE_16_UPDATED:
+            p_bike->has_power_page = true;
+            bike_sample(slot, p_profile->page_16.instantaneous_power, p_profile->common.instantaneous_cadence);
+            break;
+
+        case ANT_BPWR_PAGE_17_UPDATED:
+            if (!p_bike->has_power_page && torque_page_power(p_bike, &p_profile->page_17, &power)) {
+                bike_sample(slot, power, p_profile->common.instantaneous_cadence);
+            }
+            break;
+
+        case ANT_BPWR_PAGE_18_UPDATED:
+            if (!p_bike->has_power_page && torque_page_power(p_bike, &p_profile->page_18, &power)) {
+                bike_sample(slot, power, p_profile->common.instantaneous_cadence);
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief ANT event handler for all aggregator channels
+ */
+static void ant_agg_evt_handler(ant_evt_t * p_ant_evt, void * p_context) {
+    uint8_t slot = slot_from_channel(p_ant_evt->channel);
+    if (!m_running || slot >= ANT_AGG_MAX_BIKES || m_bikes[slot].device_id == 0) {
+        return;
+    }
+
+    // Let the profile decode the page first
+    ant_bpwr_disp_evt_handler(p_ant_evt, &m_profiles[slot]);
+
+    switch (p_ant_evt->event) {
+        case EVENT_RX_SEARCH_TIMEOUT:
+            NRF_LOG_WARNING("⚠️ Aggregator: Search timeout for device %d", m_bikes[slot].device_id);
+            break;
+
+        case EVENT_CHANNEL_CLOSED:
+            m_bikes[slot].channel_open = false;
+            m_bikes[slot].has_torque = false;
+            NRF_LOG_WARNING("⚠️ Aggregator: Channel closed for device %d", m_bikes[slot].device_id);
+            deadline_timer_start(m_reopen_timer, ANT_AGG_REOPEN_MS, NULL);
+            break;
+
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Initialize the aggregator from the stored device list
+ */
+static bool ant_agg_init(data_source_config_t* config) {
+    if (config == NULL || config->type != DATA_SOURCE_ANT_AGGREGATOR) {
+        NRF_LOG_ERROR("Invalid ANT+ aggregator configuration");
+        return false;
+    }
+
+    memset(m_bikes, 0, sizeof(m_bikes));
+    m_updated_mask = 0;
+
+    uint8_t configured = 0;
+    for (uint8_t slot = 0; slot < ANT_AGG_MAX_BIKES; slot++) {
+        m_bikes[slot].device_id = m_ant_agg_device_ids[slot];
+        cycling_data_pipeline_reset(&m_bikes[slot].pipeline);
+        if (m_bikes[slot].device_id != 0) {
+            configured++;
+        }
+    }
+
+    if (configured == 0) {
+        NRF_LOG_WARNING("🚫 Aggregator: No ANT+ device IDs configured");
+        return false;
+    }
+
+    uint32_t err_code = deadline_timer_create(&m_reopen_timer, DEADLINE_TIMER_MODE_SINGLE_SHOT,
+                                              ANT_AGG_REOPEN_SLACK_MS, reopen_timer_handler);
+    APP_ERROR_CHECK(err_code);
+
+    NRF_LOG_INFO("ANT+ Aggregator: Initialized with %d power meters", configured);
+    return true;
+}
+
+/**
+ * @brief Open one BPWR display channel per configured bike
+ */
+static bool ant_agg_start(void) {
+    uint32_t err_code = sd_ant_network_address_set(ANTPLUS_NETWORK_NUMBER, ANT_PLUS_NETWORK_KEY);
+    if (err_code != NRF_SUCCESS) {
+        NRF_LOG_ERROR("🚨 Failed to set ANT+ network key! Error: 0x%08X", err_code);
+        return false;
+    }
+
+    for (uint8_t slot = 0; slot < ANT_AGG_MAX_BIKES; slot++) {
+        if (m_bikes[slot].device_id == 0) {
+            continue;
+        }
+
+        ant_channel_config_t channel_config = {
+            .channel_number    = ANT_AGG_FIRST_CHANNEL + slot,
+            .channel_type      = BPWR_DISP_CHANNEL_TYPE,
+            .ext_assign        = BPWR_EXT_ASSIGN,
+            .rf_freq           = BPWR_ANTPLUS_RF_FREQ,
+            .transmission_type = ANT_BPWR_TRANS_TYPE,
+            .device_type       = 11, // ANT+ Bike Power
+            .device_number     = m_bikes[slot].device_id,
+            .channel_period    = BPWR_MSG_PERIOD,
+            .network_number    = ANTPLUS_NETWORK_NUMBER,
+        };
+
+        ant_bpwr_disp_config_t disp_config = {
+            .p_cb        = &m_disp_cbs[slot],
+            .evt_handler = ant_agg_bpwr_evt_handler,
+        };
+
+        err_code = ant_bpwr_disp_init(&m_profiles[slot], &channel_config, &disp_config);
+        if (err_code != NRF_SUCCESS) {
+            NRF_LOG_ERROR("🚨 Aggregator: ant_bpwr_disp_init failed for device %d: 0x%08X",
+                          m_bikes[slot].device_id, err_code);
+            continue;
+        }
+
+        open_slot(slot);
+        NRF_LOG_INFO("📡 Aggregator: Channel %d -> device %d",
+                     channel_config.channel_number, m_bikes[slot].device_id);
+    }
+
+    m_running = true;
+
+    // Channels that failed to open are retried like timed-out ones
+    for (uint8_t slot = 0; slot < ANT_AGG_MAX_BIKES; slot++) {
+        if (m_bikes[slot].device_id != 0 && !m_bikes[slot].channel_open) {
+            deadline_timer_start(m_reopen_timer, ANT_AGG_REOPEN_MS, NULL);
+            break;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Close all aggregator channels
+ */
+static void ant_agg_stop(void) {
+    m_running = false;
+    deadline_timer_stop(m_reopen_timer);
+
+    for (uint8_t slot = 0; slot < ANT_AGG_MAX_BIKES; slot++) {
+        if (m_bikes[slot].channel_open) {
+            (void)sd_ant_channel_close(ANT_AGG_FIRST_CHANNEL + slot);
+            m_bikes[slot].channel_open = false;
+        }
+    }
+
+    NRF_LOG_INFO("🛑 ANT+ Aggregator: Stopped");
+}
+
+/**
+ * @brief Aggregator is active while any bike delivers data
+ */
+static bool ant_agg_is_active(void) {
+    return m_running && ant_aggregator_active_count() > 0;
+}
+
+const ant_agg_bike_t* ant_aggregator_get_bike(uint8_t slot) {
+    if (slot >= ANT_AGG_MAX_BIKES) {
+        return NULL;
+    }
+    return &m_bikes[slot];
+}
+
+uint8_t ant_aggregator_active_count(void) {
+    uint32_t now = app_timer_cnt_get();
+    uint8_t count = 0;
+
+    for (uint8_t slot = 0; slot < ANT_AGG_MAX_BIKES; slot++) {
+        if (m_bikes[slot].has_data &&
+            TICKS_TO_MS(app_timer_cnt_diff_compute(now, m_bikes[slot].last_rx_ticks)) < ANT_AGG_STALE_MS) {
+            count++;
+        }
+    }
+    return count;
+}
+
+uint8_t ant_aggregator_take_updated(void) {
+    uint8_t mask = m_updated_mask;
+    m_updated_mask = 0;
+    return mask;
+}
+
+uint16_t ant_aggregator_encode_record(uint8_t slot, uint8_t *p_buf, uint32_t now_ticks) {
+    if (slot >= ANT_AGG_MAX_BIKES || m_bikes[slot].device_id == 0) {
+        return 0;
+    }
+
+    const ant_agg_bike_t *p_bike = &m_bikes[slot];
+    uint16_t power = 0;
+    uint8_t cadence = 0;
+    uint8_t age = ANT_AGG_AGE_NEVER;
+
+    if (p_bike->has_data) {
+        uint32_t age_ms = TICKS_TO_MS(app_timer_cnt_diff_compute(now_ticks, p_bike->last_rx_ticks));
+        age = (age_ms / ANT_AGG_AGE_UNIT_MS > 0xFE) ? 0xFE : (uint8_t)(age_ms / ANT_AGG_AGE_UNIT_MS);
+
+        // Stale bikes are reported as stopped
+        if (age_ms < ANT_AGG_STALE_MS) {
+            power = p_bike->pipeline.data.average_power;
+            cadence = p_bike->pipeline.data.average_cadence;
+        }
+    }
+
+    p_buf[0] = slot;
+    p_buf[1] = (uint8_t)(p_bike->device_id & 0xFF);
+    p_buf[2] = (uint8_t)(p_bike->device_id >> 8);
+    p_buf[3] = (uint8_t)(power & 0xFF);
+    p_buf[4] = (uint8_t)(power >> 8);
+    p_buf[5] = cadence;
+    p_buf[6] = age;
+
+    return ANT_AGG_RECORD_LEN;
+}
+
+// Define the ANT+ aggregator data source interface
+static const data_source_interface_t ant_agg_interface = {
+    .init = ant_agg_init,
+    .start = ant_agg_start,
+    .stop = ant_agg_stop,
+    .is_active = ant_agg_is_active
+};
+
+// Public function to get the ANT+ aggregator interface
+const data_source_interface_t* ant_aggregator_get_interface(void) {
+    return &ant_agg_interface;
+}
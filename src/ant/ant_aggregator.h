@@ -0,0 +1,81 @@
+/**
+ * @file ant_aggregator.h
+ * @brief ANT+ Multi-Bike Aggregator
+ *
+ * Opens one BPWR display channel per configured power meter so a single
+ * bridge can serve several bikes. Each bike has its own profile instance
+ * and smoothing pipeline.
+ */
+
+#ifndef ANT_AGGREGATOR_H
+#define ANT_AGGREGATOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "includes/data_source.h"
+#include "includes/cycling_data_model.h"
+#include "common_definitions.h"
+
+#define ANT_AGG_STALE_MS        3000   // Bike reported with zero power after this long without data
+#define ANT_AGG_REOPEN_MS       10000  // Delay before reopening a channel closed by search timeout
+#define ANT_AGG_REOPEN_SLACK_MS 2000   // The retry may run this much later
+
+// Per-bike record used by the aggregator GATT service
+#define ANT_AGG_RECORD_LEN      7      // Slot (1) + Device ID (2) + Power (2) + Cadence (1) + Age (1)
+#define ANT_AGG_AGE_UNIT_MS     100    // Age field resolution, saturates at 0xFE
+#define ANT_AGG_AGE_NEVER       0xFF   // No data received yet
+
+/**
+ * @brief State of one aggregated bike
+ */
+typedef struct {
+    uint16_t device_id;                 /**< ANT+ device number, 0 when the slot is unused */
+    cycling_data_pipeline_t pipeline;   /**< Smoothed data for this bike */
+    uint32_t last_rx_ticks;             /**< app_timer counter at the last power sample */
+    uint8_t torque_event_count;         /**< Event count of the last torque page */
+    uint16_t torque_period;             /**< Accumulated period of the last torque page, 1/2048 s */
+    uint16_t torque_accumulated;        /**< Accumulated torque of the last torque page, 1/32 Nm */
+    bool channel_open;                  /**< ANT channel currently open */
+    bool has_data;                      /**< At least one page received */
+    bool has_torque;                    /**< torque_* hold a previous torque page */
+    bool has_power_page;                /**< The meter sends page 0x10, its torque pages are ignored */
+} ant_agg_bike_t;
+
+/**
+ * @brief Get the ANT+ aggregator data source interface
+ *
+ * @return data_source_interface_t* Pointer to the aggregator interface
+ */
+const data_source_interface_t* ant_aggregator_get_interface(void);
+
+/**
+ * @brief Get a bike slot
+ *
+ * @param slot Slot index, below ANT_AGG_MAX_BIKES
+ * @return const ant_agg_bike_t* Bike state, or NULL if the slot is out of range
+ */
+const ant_agg_bike_t* ant_aggregator_get_bike(uint8_t slot);
+
+/**
+ * @brief Number of bikes that delivered data within ANT_AGG_STALE_MS
+ */
+uint8_t ant_aggregator_active_count(void);
+
+/**
+ * @brief Take the set of slots updated since the last call
+ *
+ * @return uint8_t Bit mask, bit n set when slot n has new data
+ */
+uint8_t ant_aggregator_take_updated(void);
+
+/**
+ * @brief Encode one bike record for the aggregator service
+ *
+ * @param slot Slot index
+ * @param p_buf Output buffer, at least ANT_AGG_RECORD_LEN bytes
+ * @param now_ticks Current app_timer counter, used for the age field
+ * @return uint16_t Number of bytes written, 0 if the slot is unused
+ */
+uint16_t ant_aggregator_encode_record(uint8_t slot, uint8_t *p_buf, uint32_t now_ticks);
+
+#endif /* ANT_AGGREGATOR_H */
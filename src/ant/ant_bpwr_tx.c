@@ -0,0 +1,196 @@
+/**
+ * @file ant_bpwr_tx.c
+ * @brief Implementation of the ANT+ Bike Power Transmitter
+ */
+
+#include "ant_bpwr_tx.h"
+#include "common_definitions.h"
+#include "includes/data_bus.h"
+
+#include "nrf_sdh_ant.h"
+#include "ant_parameters.h"
+#include "ant_interface.h"
+#include "ant_bpwr.h"
+#include "app_timer.h"
+#include "includes/timer_ticks.h"
+#include "nrf_log.h"
+#include "app_error.h"
+
+// ANT+ BPWR sensor profile instance
+static ant_bpwr_profile_t m_ant_bpwr_tx;
+static ant_bpwr_sens_cb_t m_ant_bpwr_tx_cb;
+
+static bool m_tx_active = false;
+static cycling_data_t m_tx_data;          // Copy of the last sample from the data bus
+static uint32_t m_tx_data_ticks = 0;
+static uint32_t m_tx_data_version = 0;    // Bus version of m_tx_data
+static uint32_t m_tx_sent_version = 0;    // Bus version carried by the last power event
+
+static void ant_bpwr_tx_evt_handler(ant_bpwr_profile_t * p_profile, ant_bpwr_evt_t event);
+static void ant_bpwr_tx_calib_handler(ant_bpwr_profile_t * p_profile, ant_bpwr_page1_data_t * p_page1);
+static void ant_bpwr_tx_ant_evt_handler(ant_evt_t * p_ant_evt, void * p_context);
+
+NRF_SDH_ANT_OBSERVER(m_ant_bpwr_tx_observer, ANT_BPWR_ANT_OBSERVER_PRIO, ant_bpwr_tx_ant_evt_handler, &m_ant_bpwr_tx);
+
+static const ant_bpwr_sens_config_t m_ant_bpwr_tx_config = {
+    .p_cb          = &m_ant_bpwr_tx_cb,
+    .evt_handler   = ant_bpwr_tx_evt_handler,
+    .calib_handler = ant_bpwr_tx_calib_handler,
+};
+
+/**
+ * @brief Update the power event for the page the profile encodes next
+ *
+ * A new sample is a new power event: the event count advances by one and
+ * the accumulated power by the instantaneous power, so head units can
+ * average correctly across missed messages. Without a new sample the page
+ * is repeated unchanged. Once the data times out every page is an event
+ * with zero power, so head units drop to zero instead of holding the last
+ * value.
+ */
+static void ant_bpwr_tx_page_16_update(ant_bpwr_profile_t * p_profile) {
+    uint16_t power = 0;
+    uint8_t cadence = 0;
+
+    uint32_t age_ms = TICKS_TO_MS(app_timer_cnt_diff_compute(app_timer_cnt_get(), m_tx_data_ticks));
+    if (m_tx_data.data_available && age_ms < ANT_BPWR_TX_DATA_TIMEOUT_MS) {
+        if (m_tx_data_version == m_tx_sent_version) {
+            return;  // No new power event since the last page
+        }
+        power = m_tx_data.instantaneous_power;
+        cadence = m_tx_data.instantaneous_cadence;
+    }
+
+    m_tx_sent_version = m_tx_data_version;
+
+    p_profile->page_16.update_event_count++;
+    p_profile->page_16.accumulated_power += power;  // Rolls over at 65536 W as per the profile
+    p_profile->page_16.instantaneous_power = power;
+    p_profile->common.instantaneous_cadence = cadence;
+}
+
+/**
+ * @brief Only forward events from the transmit channel to the profile
+ *
+ * On EVENT_TX the profile encodes and queues the next page, and only then
+ * calls its event handler. The power event is updated here first so the
+ * page carries the current sample rather than the previous one. When the
+ * next page is a common page the event rides along unseen, the following
+ * page 16 still has consistent event count and accumulated power.
+ */
+static void ant_bpwr_tx_ant_evt_handler(ant_evt_t * p_ant_evt, void * p_context) {
+    if (!m_tx_active || p_ant_evt->channel != ANT_BPWR_TX_CHANNEL) {
+        return;
+    }
+    if (p_ant_evt->event == EVENT_TX) {
+        ant_bpwr_tx_page_16_update((ant_bpwr_profile_t *)p_context);
+    }
+    ant_bpwr_sens_evt_handler(p_ant_evt, p_context);
+}
+
+/**
+ * @brief Called by the profile after each page has been encoded
+ *
+ * Nothing to do, the page data is set on EVENT_TX before encoding.
+ */
+static void ant_bpwr_tx_evt_handler(ant_bpwr_profile_t * p_profile, ant_bpwr_evt_t event) {
+    UNUSED_PARAMETER(p_profile);
+    UNUSED_PARAMETER(event);
+}
+
+/**
+ * @brief Calibration request handler
+ *
+ * The bridged bikes report calibrated power, answer manual zero with success.
+ */
+static void ant_bpwr_tx_calib_handler(ant_bpwr_profile_t * p_profile, ant_bpwr_page1_data_t * p_page1) {
+    if (p_page1->calibration_id == ANT_BPWR_CALIB_ID_MANUAL) {
+        p_profile->page_1.calibration_id = ANT_BPWR_CALIB_ID_MANUAL_SUCCESS;
+        p_profile->page_1.general_calib_data = 0;
+    } else {
+        p_profile->page_1.calibration_id = ANT_BPWR_CALIB_ID_FAILED;
+    }
+    p_profile->page_1.auto_zero_status = ANT_BPWR_AUTO_ZERO_NOT_SUPPORTED;
+
+    NRF_LOG_INFO("ANT+ TX: Calibration request 0x%02X", p_page1->calibration_id);
+}
+
+/**
+ * @brief Data bus handler, the sample is sent on the next page 16
+ *
+ * The snapshot is only valid during the call, keep a copy.
+ */
+static void ant_bpwr_tx_data_handler(const data_bus_snapshot_t *p_snapshot, uint8_t topics) {
+    m_tx_data = p_snapshot->cycling;
+    m_tx_data_ticks = p_snapshot->timestamp_ticks;
+    m_tx_data_version = p_snapshot->version;
+}
+
+bool ant_bpwr_tx_start(uint16_t device_number) {
+    uint32_t err_code;
+
+    if (device_number == 0) {
+        NRF_LOG_WARNING("🚫 ANT+ TX: No device number, transmitter disabled");
+        return false;
+    }
+
+    err_code = sd_ant_network_address_set(ANTPLUS_NETWORK_NUMBER, ANT_PLUS_NETWORK_KEY);
+    if (err_code != NRF_SUCCESS) {
+        NRF_LOG_ERROR("🚨 ANT+ TX: Failed to set network key: 0x%08X", err_code);
+        return false;
+    }
+
+    ant_channel_config_t channel_config = {
+        .channel_number    = ANT_BPWR_TX_CHANNEL,
+        .channel_type      = BPWR_SENS_CHANNEL_TYPE,  // ANT+ Master
+        .ext_assign        = BPWR_EXT_ASSIGN,
+        .rf_freq           = BPWR_ANTPLUS_RF_FREQ,
+        .transmission_type = ANT_BPWR_TX_TRANS_TYPE,
+        .device_type       = 11, // ANT+ Bike Power
+        .device_number     = device_number,
+        .channel_period    = BPWR_MSG_PERIOD,  // 8182 counts, 4.005 Hz
+        .network_number    = ANTPLUS_NETWORK_NUMBER,
+    };
+
+    err_code = ant_bpwr_sens_init(&m_ant_bpwr_tx, &channel_config, &m_ant_bpwr_tx_config);
+    if (err_code != NRF_SUCCESS) {
+        NRF_LOG_ERROR("🚨 ANT+ TX: ant_bpwr_sens_init FAILED: 0x%08X", err_code);
+        return false;
+    }
+
+    // Power-only sensor without pedal balance
+    m_ant_bpwr_tx.page_16.pedal_power.byte = 0xFF;
+    m_ant_bpwr_tx.page_16.update_event_count = 0;
+    m_ant_bpwr_tx.page_16.accumulated_power = 0;
+
+    err_code = ant_bpwr_sens_open(&m_ant_bpwr_tx);
+    if (err_code != NRF_SUCCESS) {
+        NRF_LOG_ERROR("🚨 ANT+ TX: ant_bpwr_sens_open FAILED: 0x%08X", err_code);
+        return false;
+    }
+
+    // The channel runs at 4 Hz independently of the update rate
+    (void)data_bus_subscribe(ant_bpwr_tx_data_handler, DATA_BUS_TOPIC_POWER | DATA_BUS_TOPIC_CADENCE, 0);
+
+    m_tx_active = true;
+    NRF_LOG_INFO("✅ ANT+ TX: Transmitting bike power as device %d", device_number);
+    return true;
+}
+
+void ant_bpwr_tx_stop(void) {
+    if (!m_tx_active) {
+        return;
+    }
+
+    data_bus_unsubscribe(ant_bpwr_tx_data_handler);
+
+    uint32_t err_code = sd_ant_channel_close(ANT_BPWR_TX_CHANNEL);
+    if (err_code != NRF_SUCCESS) {
+        NRF_LOG_WARNING("⚠️ ANT+ TX: Channel was already closed or error.");
+    }
+    m_tx_active = false;
+}
+
+bool ant_bpwr_tx_is_active(void) {
+    return m_tx_active;
+}
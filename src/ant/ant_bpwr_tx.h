@@ -0,0 +1,38 @@
+/**
+ * @file ant_bpwr_tx.h
+ * @brief ANT+ Bike Power Transmitter
+ *
+ * Re-broadcasts the cycling data model as an ANT+ bicycle power sensor
+ * (master channel) so ANT+ head units can follow a BLE-only bike.
+ */
+
+#ifndef ANT_BPWR_TX_H
+#define ANT_BPWR_TX_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define ANT_BPWR_TX_TRANS_TYPE      5     // Independent power-only sensor
+#define ANT_BPWR_TX_DATA_TIMEOUT_MS 3000  // Transmit zero power when the model has not updated for this long
+
+/**
+ * @brief Initialize and open the ANT+ power transmitter
+ * 
+ * Subscribes to power and cadence on the data bus while open.
+ * 
+ * @param device_number ANT+ device number to transmit as
+ * @return true if the channel was opened, false otherwise
+ */
+bool ant_bpwr_tx_start(uint16_t device_number);
+
+/**
+ * @brief Close the ANT+ power transmitter
+ */
+void ant_bpwr_tx_stop(void);
+
+/**
+ * @brief Check if the transmitter is open
+ */
+bool ant_bpwr_tx_is_active(void);
+
+#endif /* ANT_BPWR_TX_H */
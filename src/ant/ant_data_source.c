@@ -16,6 +16,42 @@
 #include "app_error.h"
 #include "bsp.h"
 #include "includes/ble_bridge.h"
+#include "includes/profiler.h"
+#include "includes/diagnostics.h"
+#include "includes/trace_log.h"
+#include "includes/led_sequencer.h"
+#include "includes/deadline_timer.h"
+#include "includes/boot_profile.h"
+#include "app_util.h"
+
+// Search tuning, timeouts in 2.5 s units
+#define REACQ_HP_SEARCH_TIMEOUT  2                      // 5 s high priority, finds a pedalling meter at once
+#define REACQ_LP_SEARCH_TIMEOUT  6                      // 15 s low priority, shares the radio with BLE
+#define REACQ_PROX_THRESHOLD     PROXIMITY_THRESHOLD_3  // About -52 dBm, the bike the bridge is mounted on
+#define REACQ_RETRY_SLACK_MS     500                    // Reopening need not be punctual
+
+#define ANT_CACHE_MAGIC          0xA27CAC4E
+#define ANT_TRANS_TYPE_WILDCARD  0
+
+// Reopen backoff schedule, the last entry repeats
+static const uint32_t m_reacq_backoff_ms[] = {1000, 2000, 5000, 10000, 30000};
+
+/**
+ * @brief Channel ID of the last acquired meter
+ *
+ * Kept in no-init RAM, retained through System OFF, so a wake from the reed
+ * switch searches for the exact channel ID. The transmission type carries
+ * the upper four bits of 20-bit device numbers, a wildcard search is only
+ * needed for the first pairing.
+ */
+typedef struct {
+    uint32_t magic;
+    uint16_t device_id;
+    uint8_t trans_type;
+    uint8_t check;  // Complement of trans_type
+} ant_channel_cache_t;
+
+static ant_channel_cache_t m_channel_cache __attribute__((section(".app_noinit")));
 
 // ANT+ BPWR profile instance
 static ant_bpwr_profile_t m_ant_bpwr;
@@ -29,13 +65,22 @@ static void ant_bpwr_disp_evt_handler_filtered(ant_evt_t * p_ant_evt, void * p_c
 static bool m_ant_active = false;
 static bool m_data_source_lost_notified = false;  // Track if we've already notified about data source loss
 
-// ANT+ restart timer
-APP_TIMER_DEF(m_ant_restart_timer);
+// Reacquisition state
+static deadline_timer_id_t m_ant_restart_timer;
+static bool m_running = false;        // Between start and stop, a channel close is a lost meter
+static bool m_acquired = false;       // Meter received since the last open
+static bool m_first_search = false;   // Next open is the first after start
+static uint8_t m_backoff_index = 0;
 
 // Data source callbacks
 static data_update_callback_t m_data_callback = NULL;
 static uint16_t m_device_id = 0;
 
+#define RTC_COUNTER_MASK 0x00FFFFFF  // RTC1 counts 24 bits
+
+// RX time of the message being decoded, RTC1 ticks like app_timer_cnt_get()
+static uint32_t m_rx_ticks = 0;
+
 // Register the ANT event handlers
 NRF_SDH_ANT_OBSERVER(m_ant_observer, APP_ANT_OBSERVER_PRIO, ant_evt_handler, NULL);
 NRF_SDH_ANT_OBSERVER(m_ant_bpwr_observer, ANT_BPWR_ANT_OBSERVER_PRIO, ant_bpwr_disp_evt_handler_filtered, &m_ant_bpwr);
@@ -49,25 +94,136 @@ static const ant_bpwr_disp_config_t m_ant_bpwr_profile_bpwr_disp_config = {
     .evt_handler = ant_bpwr_evt_handler,
 };
 
+/**
+ * @brief Whether the cache holds the channel ID of the configured meter
+ */
+static bool channel_cache_valid(void) {
+    return m_channel_cache.magic == ANT_CACHE_MAGIC &&
+           m_channel_cache.device_id == m_device_id &&
+           m_channel_cache.check == (uint8_t)~m_channel_cache.trans_type;
+}
+
+/**
+ * @brief Remember the channel ID the search matched, call once the meter is received
+ */
+static void channel_cache_store(void) {
+    uint16_t device_number;
+    uint8_t device_type;
+    uint8_t trans_type;
+
+    if (sd_ant_channel_id_get(ANT_BPWR_ANT_CHANNEL, &device_number, &device_type, &trans_type) != NRF_SUCCESS ||
+        device_number != m_device_id) {
+        return;
+    }
+    if (channel_cache_valid() && m_channel_cache.trans_type == trans_type) {
+        return;
+    }
+
+    m_channel_cache.device_id = device_number;
+    m_channel_cache.trans_type = trans_type;
+    m_channel_cache.check = (uint8_t)~trans_type;
+    m_channel_cache.magic = ANT_CACHE_MAGIC;
+    NRF_LOG_INFO("💾 ANT+ channel ID cached: device %d, trans type 0x%02X", device_number, trans_type);
+}
+
+/**
+ * @brief Open the assigned channel with the reacquisition search settings
+ *
+ * A short high priority search finds a meter that is already transmitting,
+ * the low priority search continues in the gaps of the BLE radio activity.
+ * The proximity threshold only holds for one search, it is set for the first
+ * search after start so the meter on this bike wins, a retry searches at full
+ * range.
+ */
+static uint32_t reacq_open(void) {
+    (void)sd_ant_channel_search_timeout_set(ANT_BPWR_ANT_CHANNEL, REACQ_HP_SEARCH_TIMEOUT);
+    (void)sd_ant_channel_low_priority_rx_search_timeout_set(ANT_BPWR_ANT_CHANNEL, REACQ_LP_SEARCH_TIMEOUT);
+    if (m_first_search) {
+        (void)sd_ant_prox_search_set(ANT_BPWR_ANT_CHANNEL, REACQ_PROX_THRESHOLD, 0);
+        m_first_search = false;
+    }
+
+    m_acquired = false;
+    return ant_bpwr_disp_open(&m_ant_bpwr);
+}
+
+/**
+ * @brief Reopen after the next entry of the backoff schedule
+ *
+ * The bridge only hears about a lost meter once the schedule is exhausted,
+ * a single search timeout is not a loss of data.
+ */
+static void reacq_schedule(void) {
+    uint32_t delay_ms = m_reacq_backoff_ms[m_backoff_index];
+
+    if (m_backoff_index < ARRAY_SIZE(m_reacq_backoff_ms) - 1) {
+        m_backoff_index++;
+    } else if (!m_data_source_lost_notified) {
+        m_data_source_lost_notified = true;
+        // Notify BLE Bridge that data source is lost
+        ble_bridge_data_source_lost();
+    }
+
+    NRF_LOG_INFO("🔄 ANT+ search again in %d ms", delay_ms);
+    deadline_timer_start(m_ant_restart_timer, delay_ms, NULL);
+}
+
 /**
  * @brief Timer handler for ANT+ restart
  */
 static void ant_restart_timer_handler(void *p_context) {
+    if (!m_running) {
+        return;
+    }
+
     NRF_LOG_INFO("🔄 Timer expired - Restarting ANT+...");
-    uint32_t err_code = ant_bpwr_disp_open(&m_ant_bpwr);
+    uint32_t err_code = reacq_open();
     if (err_code != NRF_SUCCESS) {
         NRF_LOG_ERROR("🚨 ant_bpwr_disp_open FAILED: 0x%08X", err_code);
+        reacq_schedule();
         return;
     }
     m_ant_active = true;
     NRF_LOG_INFO("✅ ant_bpwr_disp_open SUCCESS!");
 }
 
+/**
+ * @brief RX time of a message
+ *
+ * The SoftDevice stamps received messages with RTC1, the app_timer clock,
+ * when the time stamp is enabled. The stamp follows the device ID and RSSI
+ * fields, which the scanner may have enabled as well.
+ */
+static uint32_t ant_rx_ticks(ANT_MESSAGE * p_message) {
+    if (!p_message->ANT_MESSAGE_stExtMesgBF.bANTTimeStamp) {
+        return app_timer_cnt_get();
+    }
+
+    uint8_t offset = 0;
+    if (p_message->ANT_MESSAGE_stExtMesgBF.bANTDeviceID) {
+        offset += ANT_EXT_MESG_DEVICE_ID_FIELD_SIZE;
+    }
+    if (p_message->ANT_MESSAGE_stExtMesgBF.bANTRssi) {
+        offset += ANT_EXT_MESG_RSSI_FIELD_SIZE;
+    }
+
+    uint8_t * p_stamp = &p_message->ANT_MESSAGE_aucExtData[offset];
+    uint32_t ticks = (uint32_t)p_stamp[0] | ((uint32_t)p_stamp[1] << 8) |
+                     ((uint32_t)p_stamp[2] << 16) | ((uint32_t)p_stamp[3] << 24);
+
+    return ticks & RTC_COUNTER_MASK;
+}
+
 /**
  * @brief Custom filtering wrapper for ANT+ events
  */
 static void ant_bpwr_disp_evt_handler_filtered(ant_evt_t * p_ant_evt, void * p_context) {
     if (p_ant_evt->channel == ANT_BPWR_ANT_CHANNEL) {
+        // Page decoding below reports the sample with this message's RX time
+        if (p_ant_evt->event == EVENT_RX) {
+            m_rx_ticks = ant_rx_ticks((ANT_MESSAGE *)&p_ant_evt->message);
+        }
+
         // Only forward events from ANT_BPWR_ANT_CHANNEL to Nordic's handler
         ant_bpwr_disp_evt_handler(p_ant_evt, p_context);
     } else {
@@ -86,16 +242,22 @@ static void ant_bpwr_evt_handler(ant_bpwr_profile_t * p_profile, ant_bpwr_evt_t
         return;
     }
 
+    PROFILE_BEGIN(PROFILE_ANT_BPWR_EVT);
+
     switch (event) {
         case ANT_BPWR_PAGE_16_UPDATED: {
             uint16_t power = p_profile->page_16.instantaneous_power;
             uint8_t cadence = p_profile->common.instantaneous_cadence;
             
-            NRF_LOG_DEBUG("🚴 Raw Power: %d W, Cadence: %d RPM", power, cadence);
+            TRACE_LOG2("ANT+: Raw power %u W, cadence %u RPM", power, cadence);
+
+            if (power > 0) {
+                boot_profile_mark(BOOT_PHASE_FIRST_WATT);
+            }
             
             // Call the data update callback
             if (m_data_callback != NULL) {
-                m_data_callback(power, cadence);
+                m_data_callback(power, cadence, m_rx_ticks);
             }
             break;
         }
@@ -130,6 +292,8 @@ static void ant_bpwr_evt_handler(ant_bpwr_profile_t * p_profile, ant_bpwr_evt_t
             NRF_LOG_WARNING("⚠️ Unknown ANT+ Page Update: %d", event);
             break;
     }
+
+    PROFILE_END(PROFILE_ANT_BPWR_EVT);
 }
 
 /**
@@ -145,43 +309,44 @@ void ant_evt_handler(ant_evt_t * p_ant_evt, void * p_context) {
 
     // Flash LED for any ANT+ message received (in debug mode)
     if (p_ant_evt->event == EVENT_RX) {
-        #if defined(DEBUG) && !defined(RELEASE) 
-            bsp_board_led_invert(3);       // Toggle LED4
-        #endif
+        LED_SEQ_DEBUG_PLAY(LED_SEQ_ANT_RX);
     }
 
     switch (p_ant_evt->event) {
         case EVENT_RX:
+            DIAG_INC(DIAG_ANT_RX);
             m_ant_active = true;
             m_data_source_lost_notified = false;  // Reset the notification flag when we get data
+            if (!m_acquired) {
+                m_acquired = true;
+                m_backoff_index = 0;
+                channel_cache_store();
+            }
             break;
 
         case EVENT_RX_SEARCH_TIMEOUT:
+            DIAG_INC(DIAG_ANT_SEARCH_TIMEOUT);
             m_ant_active = false;
             NRF_LOG_WARNING("⚠️ ANT+ channel search timeout");
-            if (!m_data_source_lost_notified) {
-                m_data_source_lost_notified = true;
-                // Notify BLE Bridge that data source is lost
-                ble_bridge_data_source_lost();
-            }
             break;
 
         case EVENT_CHANNEL_CLOSED:
             m_ant_active = false;
             NRF_LOG_WARNING("⚠️ ANT+ channel closed");
-            if (!m_data_source_lost_notified) {
-                m_data_source_lost_notified = true;
-                // Notify BLE Bridge that data source is lost
-                ble_bridge_data_source_lost();
+            // The channel closes after every search timeout, ant_source_stop() closes it too
+            if (m_running) {
+                reacq_schedule();
             }
             break;
 
         case EVENT_RX_FAIL:
-            NRF_LOG_WARNING("⚠️ ANT+ RX Fail: %d", p_ant_evt->event);
+            DIAG_INC(DIAG_ANT_RX_FAIL);
+            TRACE_LOG0("ANT+: RX fail");
             break;
 
         case EVENT_RX_DATA_OVERFLOW:
-            NRF_LOG_WARNING("⚠️ ANT+ RX Data Overflow: %d", p_ant_evt->event);
+            DIAG_INC(DIAG_ANT_RX_OVERFLOW);
+            TRACE_LOG0("ANT+: RX data overflow");
             break;
 
         default:
@@ -207,7 +372,8 @@ static bool ant_source_init(data_source_config_t* config) {
     m_data_source_lost_notified = false;  // Reset notification flag on init
     
     // Create the ANT+ restart timer
-    err_code = app_timer_create(&m_ant_restart_timer, APP_TIMER_MODE_SINGLE_SHOT, ant_restart_timer_handler);
+    err_code = deadline_timer_create(&m_ant_restart_timer, DEADLINE_TIMER_MODE_SINGLE_SHOT,
+                                     REACQ_RETRY_SLACK_MS, ant_restart_timer_handler);
     APP_ERROR_CHECK(err_code);
     
     NRF_LOG_INFO("ANT+ Data Source: Initialized with device ID %d", m_device_id);
@@ -236,13 +402,30 @@ static bool ant_source_start(void) {
     }
     NRF_LOG_INFO("✅ ANT+ Network Key Set Successfully!");
 
+    // Stamp received messages with RTC1 so samples carry their RX time
+    ANT_TIME_STAMP_CONFIG time_stamp_config = {
+        .ucTimeBase = ANT_TIME_BASE_ALT1,
+        .bTimeStampEnabled = true,
+    };
+    err_code = sd_ant_time_stamp_config_set(&time_stamp_config);
+    if (err_code == NRF_SUCCESS) {
+        // The library config is shared with the scanner, only add our bit
+        uint8_t lib_config = 0;
+        (void)sd_ant_lib_config_get(&lib_config);
+        err_code = sd_ant_lib_config_set(lib_config | ANT_LIB_CONFIG_MESG_OUT_INC_TIME_STAMP);
+    }
+    if (err_code != NRF_SUCCESS) {
+        // Samples fall back to the time the handler runs
+        NRF_LOG_WARNING("⚠️ ANT+ RX time stamps not available: 0x%08X", err_code);
+    }
+
     // Configure the ANT+ channel
     static ant_channel_config_t bpwr_channel_config = {
         .channel_number    = ANT_BPWR_ANT_CHANNEL,
         .channel_type      = BPWR_DISP_CHANNEL_TYPE,  // ANT+ Receiver
         .ext_assign        = BPWR_EXT_ASSIGN,
         .rf_freq           = BPWR_ANTPLUS_RF_FREQ,   // Default ANT+ Frequency
-        .transmission_type = ANT_BPWR_TRANS_TYPE,  
+        .transmission_type = ANT_TRANS_TYPE_WILDCARD,  // Updated from the channel cache
         .device_type       = 11, // ANT+ Bike Power
         .device_number     = 0,  // Placeholder, updated with m_device_id
         .channel_period    = BPWR_MSG_PERIOD,
@@ -253,6 +436,14 @@ static bool ant_source_start(void) {
     bpwr_channel_config.device_number = m_device_id;
     NRF_LOG_INFO("Setting ANT+ Device ID to %d", m_device_id);
 
+    // Search for the exact channel ID of the last session, any transmission type when pairing
+    if (channel_cache_valid()) {
+        bpwr_channel_config.transmission_type = m_channel_cache.trans_type;
+        NRF_LOG_INFO("💾 Using cached ANT+ trans type 0x%02X", m_channel_cache.trans_type);
+    } else {
+        bpwr_channel_config.transmission_type = ANT_TRANS_TYPE_WILDCARD;
+    }
+
     // Initialize the ANT BPWR channel
     NRF_LOG_INFO("📡 Calling ant_bpwr_disp_init...");
     err_code = ant_bpwr_disp_init(&m_ant_bpwr, &bpwr_channel_config, &m_ant_bpwr_profile_bpwr_disp_config);
@@ -264,13 +455,16 @@ static bool ant_source_start(void) {
 
     // Open the ANT+ BPWR channel
     NRF_LOG_INFO("📡 Calling ant_bpwr_disp_open...");
-    err_code = ant_bpwr_disp_open(&m_ant_bpwr);
+    m_first_search = true;
+    m_backoff_index = 0;
+    err_code = reacq_open();
     if (err_code != NRF_SUCCESS) {
         NRF_LOG_ERROR("🚨 ant_bpwr_disp_open FAILED: 0x%08X", err_code);
         return false;
     }
     
     m_ant_active = true;
+    m_running = true;
     m_data_source_lost_notified = false;  // Reset notification flag on start
     NRF_LOG_INFO("✅ ant_bpwr_disp_open SUCCESS!");
     
@@ -282,6 +476,9 @@ static bool ant_source_start(void) {
  */
 static void ant_source_stop(void) {
     NRF_LOG_INFO("🛑 Closing ANT+ Channel...");
+    m_running = false;
+    deadline_timer_stop(m_ant_restart_timer);
+
     uint32_t err_code = sd_ant_channel_close(ANT_BPWR_ANT_CHANNEL);
     if (err_code == NRF_SUCCESS) {
         NRF_LOG_INFO("✅ ANT+ Channel Closed Successfully");
@@ -311,4 +508,13 @@ static const data_source_interface_t ant_source_interface = {
 // Public function to get the ANT+ data source interface
 const data_source_interface_t* ant_data_source_get_interface(void) {
     return &ant_source_interface;
-} 
\ No newline at end of file
+} 
+
+bool ant_data_source_cached_channel(uint16_t *p_device_id, uint8_t *p_trans_type) {
+    if (m_device_id == 0 || !channel_cache_valid()) {
+        return false;
+    }
+    *p_device_id = m_channel_cache.device_id;
+    *p_trans_type = m_channel_cache.trans_type;
+    return true;
+}
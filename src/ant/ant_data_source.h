@@ -17,4 +17,14 @@
  */
 const data_source_interface_t* ant_data_source_get_interface(void);
 
+/**
+ * @brief Channel ID of the configured meter from the last session
+ *
+ * @param p_device_id Device number
+ * @param p_trans_type Transmission type
+ * @return true if the meter was acquired before, false until then or when
+ *         the ANT+ source is not configured
+ */
+bool ant_data_source_cached_channel(uint16_t *p_device_id, uint8_t *p_trans_type);
+
 #endif /* ANT_DATA_SOURCE_H */ 
\ No newline at end of file
@@ -7,6 +7,7 @@
 #include "nrf_log.h"
 #include "common_definitions.h"
 #include "app_timer.h"
+#include "includes/deadline_timer.h"
 #include "nrf_delay.h"
 
 #define ANTPLUS_NETWORK_NUMBER     0  // Use network 0
@@ -27,7 +28,7 @@ static uint8_t m_num_found_devices = 0;
 static bool m_scanning_active = false;
 static bool m_channels_closing = false;
 static uint8_t m_channels_to_close = 0;
-APP_TIMER_DEF(m_scan_timer);
+static deadline_timer_id_t m_scan_timer;
 static bool m_timer_created = false;
 
 // Forward declarations
@@ -105,13 +106,7 @@ static void scan_ant_evt_handler(ant_evt_t * p_ant_evt, void * p_context)
                 }
                 
                 // Start scan timeout timer
-                err_code = app_timer_start(m_scan_timer, APP_TIMER_TICKS(MAX_SCAN_DURATION_MS), NULL);
-                if (err_code != NRF_SUCCESS)
-                {
-                    NRF_LOG_ERROR("Failed to start scan timer: 0x%08X", err_code);
-                    m_scanning_active = false;  // Ensure we don't get stuck in scanning state
-                    return;
-                }
+                deadline_timer_start(m_scan_timer, MAX_SCAN_DURATION_MS, NULL);
 
                 m_scanning_active = true;
                 NRF_LOG_INFO("ANT Scanner: Started scanning");
@@ -169,7 +164,8 @@ uint32_t ant_scanner_init(ant_device_callback_t callback)
     // Create timer only once
     if (!m_timer_created)
     {
-        err_code = app_timer_create(&m_scan_timer, APP_TIMER_MODE_SINGLE_SHOT, scan_timer_handler);
+        err_code = deadline_timer_create(&m_scan_timer, DEADLINE_TIMER_MODE_SINGLE_SHOT,
+                                         SCAN_DURATION_SLACK_MS, scan_timer_handler);
         if (err_code != NRF_SUCCESS)
         {
             NRF_LOG_ERROR("Failed to create ANT scan timer: 0x%08X", err_code);
@@ -179,7 +175,7 @@ uint32_t ant_scanner_init(ant_device_callback_t callback)
     }
 
     // Close all channels first (ANT+ requirement for scanning)
-    for (uint8_t channel = 0; channel < 5; channel++)  // ANT+ supports up to 2 channels
+    for (uint8_t channel = 0; channel < NRF_SDH_ANT_TOTAL_CHANNELS_ALLOCATED; channel++)
     {
         err_code = sd_ant_channel_close(channel);
         if (err_code != NRF_SUCCESS && err_code != NRF_ERROR_INVALID_PARAM)
@@ -219,7 +215,11 @@ uint32_t ant_scanner_init(ant_device_callback_t callback)
     }
 
     // Enable extended data: Device ID, Device Type, Transmission Type, RSSI
+    // The library config is shared, keep the RX time stamp the data source may use
+    uint8_t lib_config = 0;
+    (void)sd_ant_lib_config_get(&lib_config);
     err_code = sd_ant_lib_config_set(
+        lib_config |
         ANT_LIB_CONFIG_MESG_OUT_INC_DEVICE_ID |  // 0x80 (device ID)
         ANT_LIB_CONFIG_MESG_OUT_INC_RSSI         // 0x40 (RSSI)
     );
@@ -249,7 +249,7 @@ uint32_t ant_scanner_start(void)
     m_channels_closing = true;
     m_channels_to_close = 0;
     
-    for (uint8_t channel = 0; channel < 5; channel++)  // ANT+ supports up to 2 channels
+    for (uint8_t channel = 0; channel < NRF_SDH_ANT_TOTAL_CHANNELS_ALLOCATED; channel++)
     {
         err_code = sd_ant_channel_close(channel);
         if (err_code == NRF_SUCCESS)
@@ -273,13 +273,7 @@ uint32_t ant_scanner_start(void)
         }
 
         // Start scan timeout timer
-        err_code = app_timer_start(m_scan_timer, APP_TIMER_TICKS(MAX_SCAN_DURATION_MS), NULL);
-        if (err_code != NRF_SUCCESS)
-        {
-            err_code = sd_ant_channel_close(SCAN_CHANNEL_NUMBER);  // Stop scanning
-            APP_ERROR_CHECK(err_code);
-            return err_code;
-        }
+        deadline_timer_start(m_scan_timer, MAX_SCAN_DURATION_MS, NULL);
 
         m_scanning_active = true;
         NRF_LOG_INFO("ANT Scanner: Started scanning");
@@ -296,7 +290,7 @@ void ant_scanner_stop(void)
     }
 
     // Stop the scan timeout timer
-    app_timer_stop(m_scan_timer);
+    deadline_timer_stop(m_scan_timer);
 
     // Stop background scanning mode
     uint32_t err_code = sd_ant_channel_close(SCAN_CHANNEL_NUMBER);  // Stop scanning
@@ -13,6 +13,9 @@ typedef void (*ant_device_callback_t)(uint16_t device_id, int8_t rssi);
 // Maximum scan duration in milliseconds
 #define MAX_SCAN_DURATION_MS 10000
 
+// The scan may end this much later
+#define SCAN_DURATION_SLACK_MS 1000
+
 /**@brief Initialize the ANT scanner service.
  * 
  * This function initializes the ANT scanner service and registers the callback
@@ -0,0 +1,136 @@
+#include "ble_ant_agg_service.h"
+#include "ble_srv_common.h"
+#include "nrf_log.h"
+#include "app_error.h"
+#include "app_timer.h"
+#include "nrf_sdh_ble.h"
+#include "common_definitions.h"
+#include "ant/ant_aggregator.h"
+
+#define BIKES_VALUE_MAX_LEN (ANT_AGG_MAX_BIKES * ANT_AGG_RECORD_LEN)
+
+ble_ant_agg_t m_ant_agg_service;
+
+static uint8_t m_bikes_value[BIKES_VALUE_MAX_LEN];  // Characteristic value, stored in application RAM
+static uint8_t m_notify_pending = 0;               // Slots still to notify, one bit per slot
+
+static void ble_ant_agg_service_on_ble_evt(ble_evt_t const *p_ble_evt, void *p_context);
+NRF_SDH_BLE_OBSERVER(m_ant_agg_service_observer, APP_BLE_OBSERVER_PRIO, ble_ant_agg_service_on_ble_evt, NULL);
+
+/**@brief Notify pending bikes, one record per notification, until the TX queue is full */
+static void send_pending(void) {
+    if (m_ant_agg_service.conn_handle == BLE_CONN_HANDLE_INVALID) {
+        m_notify_pending = 0;
+        return;
+    }
+
+    uint32_t now = app_timer_cnt_get();
+
+    for (uint8_t slot = 0; slot < ANT_AGG_MAX_BIKES && m_notify_pending != 0; slot++) {
+        if ((m_notify_pending & (1 << slot)) == 0) continue;
+
+        uint8_t record[ANT_AGG_RECORD_LEN];
+        uint16_t len = ant_aggregator_encode_record(slot, record, now);
+        if (len == 0) {
+            m_notify_pending &= ~(1 << slot);
+            continue;
+        }
+
+        ble_gatts_hvx_params_t hvx_params = {0};
+        hvx_params.handle = m_ant_agg_service.bikes_handles.value_handle;
+        hvx_params.type   = BLE_GATT_HVX_NOTIFICATION;
+        hvx_params.p_data = record;
+        hvx_params.p_len  = &len;
+
+        uint32_t err_code = sd_ble_gatts_hvx(m_ant_agg_service.conn_handle, &hvx_params);
+        if (err_code == NRF_ERROR_RESOURCES) {
+            return;  // Queue full, continued on the next TX complete
+        }
+        if (err_code != NRF_SUCCESS) {
+            // Not subscribed or link busy, drop this round
+            m_notify_pending = 0;
+            return;
+        }
+
+        m_notify_pending &= ~(1 << slot);
+    }
+}
+
+/**@brief Function for handling BLE events in the ANT+ Aggregator Service */
+static void ble_ant_agg_service_on_ble_evt(ble_evt_t const *p_ble_evt, void *p_context) {
+    switch (p_ble_evt->header.evt_id) {
+        case BLE_GAP_EVT_CONNECTED:
+            if (p_ble_evt->evt.gap_evt.params.connected.role != BLE_GAP_ROLE_PERIPH) break;
+            m_ant_agg_service.conn_handle = p_ble_evt->evt.gap_evt.conn_handle;
+            m_notify_pending = 0;
+            break;
+
+        case BLE_GAP_EVT_DISCONNECTED:
+            if (p_ble_evt->evt.gap_evt.conn_handle != m_ant_agg_service.conn_handle) break;
+            m_ant_agg_service.conn_handle = BLE_CONN_HANDLE_INVALID;
+            m_notify_pending = 0;
+            break;
+
+        case BLE_GATTS_EVT_HVN_TX_COMPLETE:
+            send_pending();
+            break;
+
+        default:
+            break;
+    }
+}
+
+void ble_ant_agg_service_update(void) {
+    uint32_t now = app_timer_cnt_get();
+
+    // ✅ Refresh the readable table with all configured bikes
+    uint16_t len = 0;
+    for (uint8_t slot = 0; slot < ANT_AGG_MAX_BIKES; slot++) {
+        len += ant_aggregator_encode_record(slot, &m_bikes_value[len], now);
+    }
+
+    // Encoded in place in application RAM, only the length is set (p_value NULL)
+    ble_gatts_value_t value = {
+        .len = len,
+        .offset = 0,
+        .p_value = NULL
+    };
+    uint32_t err_code = sd_ble_gatts_value_set(BLE_CONN_HANDLE_INVALID, m_ant_agg_service.bikes_handles.value_handle, &value);
+    if (err_code != NRF_SUCCESS) {
+        NRF_LOG_WARNING("⚠️ ANT+ Aggregator: Failed to set bike table: 0x%08X", err_code);
+    }
+
+    // ✅ Notify only bikes that received new pages
+    m_notify_pending |= ant_aggregator_take_updated();
+    send_pending();
+}
+
+/**@brief Function to initialize the ANT+ Aggregator Service */
+void ble_ant_agg_service_init(void) {
+    ble_uuid_t ble_uuid;
+    ble_uuid.type = BLE_UUID_TYPE_BLE;
+    ble_uuid.uuid = ANT_AGG_SERVICE_UUID;
+    m_ant_agg_service.conn_handle = BLE_CONN_HANDLE_INVALID;
+    m_notify_pending = 0;
+
+    uint32_t err_code = sd_ble_gatts_service_add(BLE_GATTS_SRVC_TYPE_PRIMARY, &ble_uuid, &m_ant_agg_service.service_handle);
+    APP_ERROR_CHECK(err_code);
+
+    // ✅ Bikes Characteristic (Read + Notify), value kept in application RAM to spare the attribute table
+    ble_add_char_params_t bikes_params = {0};
+    bikes_params.uuid = ANT_AGG_BIKES_CHAR_UUID;
+    bikes_params.uuid_type = BLE_UUID_TYPE_BLE;
+    bikes_params.init_len = 0;
+    bikes_params.max_len = BIKES_VALUE_MAX_LEN;
+    bikes_params.is_var_len = true;
+    bikes_params.is_value_user = true;
+    bikes_params.p_init_value = m_bikes_value;
+    bikes_params.char_props.read = 1;
+    bikes_params.char_props.notify = 1;
+    bikes_params.read_access = SEC_OPEN;
+    bikes_params.cccd_write_access = SEC_OPEN;
+    err_code = characteristic_add(m_ant_agg_service.service_handle, &bikes_params, &m_ant_agg_service.bikes_handles);
+    APP_ERROR_CHECK(err_code);
+
+    NRF_LOG_INFO("✅ ANT+ Aggregator Service Initialized");
+}
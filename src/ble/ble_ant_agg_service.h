@@ -0,0 +1,26 @@
+#ifndef BLE_ANT_AGG_SERVICE_H__
+#define BLE_ANT_AGG_SERVICE_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ble.h"
+#include "ble_srv_common.h"
+
+#define ANT_AGG_SERVICE_UUID     0x1620
+#define ANT_AGG_BIKES_CHAR_UUID  0x1621
+
+typedef struct {
+    uint16_t service_handle;
+    ble_gatts_char_handles_t bikes_handles;
+    uint16_t conn_handle;
+} ble_ant_agg_t;
+
+extern ble_ant_agg_t m_ant_agg_service;
+
+/**@brief Function to initialize the ANT+ Aggregator Service */
+void ble_ant_agg_service_init(void);
+
+/**@brief Refresh the bike table and notify bikes with new data. Call periodically. */
+void ble_ant_agg_service_update(void);
+
+#endif // BLE_ANT_AGG_SERVICE_H__
@@ -12,6 +12,8 @@
 #include <stdlib.h>  // ✅ Required for rand()
 #include "ant_scanner.h"
 #include "includes/ble_bridge.h"  // ✅ Include for ble_bridge_set_ant_scan_mode
+#include "includes/profiler.h"
+#include "includes/boot_profile.h"
 //#include <nrf_bootloader.h>
 #include <nrf_bootloader_info.h>
 #include "nrf_power.h"
@@ -19,7 +21,6 @@
 
 #define ANT_LIB_CONFIG_MESG_OUT_FIELDS_ENABLE  0x01
 #define ANT_LIB_CONFIG_RSSI_MASK               0xC0
-#define ANT_LIB_CONFIG_RX_TIMESTAMP            0x20
 
 // MAX_ANT_DEVICES is defined in ant_scanner.h
 
@@ -199,6 +200,17 @@ static void on_write(ble_evt_t const *p_ble_evt) {
                 nrf_delay_ms(100);  // ✅ Delay to ensure all logs are sent before reboot
                 NVIC_SystemReset();  // ✅ Trigger a system reset
                 break;
+
+            case 0x07:  // 📊 Dump Profiling Sections and Boot Phases to RTT
+                NRF_LOG_INFO("📊 BLE Request: Dump Profiling (0x07)");
+                profiler_log();
+                boot_profile_log();
+                break;
+
+            case 0x08:  // 🧹 Reset Profiling Sections
+                NRF_LOG_INFO("🧹 BLE Request: Reset Profiling (0x08)");
+                profiler_reset();
+                break;
         
             default:
                 NRF_LOG_WARNING("⚠️ Unknown Command: 0x%02X", command);
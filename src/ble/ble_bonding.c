@@ -0,0 +1,132 @@
+#ifdef BONDING_ENABLE
+
+#include "ble_bonding.h"
+#include <string.h>
+#include "ble.h"
+#include "peer_manager.h"
+#include "peer_manager_handler.h"
+#include "nrf_log.h"
+#include "app_error.h"
+#include "common_definitions.h"
+
+/**@brief Function for handling Peer Manager events. */
+static void pm_evt_handler(pm_evt_t const * p_evt)
+{
+    pm_handler_on_pm_evt(p_evt);
+    pm_handler_disconnect_on_sec_failure(p_evt);
+    pm_handler_flash_clean(p_evt);
+
+    switch (p_evt->evt_id)
+    {
+        case PM_EVT_BONDED_PEER_CONNECTED:
+            NRF_LOG_INFO("🔐 Bonded central %d reconnected, notifications restored", p_evt->peer_id);
+            break;
+
+        case PM_EVT_CONN_SEC_SUCCEEDED:
+            NRF_LOG_INFO("🔐 Link secured with central %d (procedure %d)",
+                         p_evt->peer_id, p_evt->params.conn_sec_succeeded.procedure);
+            break;
+
+        case PM_EVT_CONN_SEC_CONFIG_REQ:
+        {
+            // The default handler rejects it, a phone that forgot the bond would be locked out
+            pm_conn_sec_config_t config = {.allow_repairing = true};
+            pm_conn_sec_config_reply(p_evt->conn_handle, &config);
+        } break;
+
+        case PM_EVT_PEERS_DELETE_SUCCEEDED:
+            NRF_LOG_INFO("🗑️ All bonds deleted");
+            break;
+
+        default:
+            break;
+    }
+}
+
+void peer_manager_init(bool erase_bonds)
+{
+    ble_gap_sec_params_t sec_param;
+    ret_code_t           err_code;
+
+    // FDS is already up, the Peer Manager registers as one more user
+    err_code = pm_init();
+    APP_ERROR_CHECK(err_code);
+
+    if (erase_bonds)
+    {
+        err_code = pm_peers_delete();
+        APP_ERROR_CHECK(err_code);
+    }
+
+    memset(&sec_param, 0, sizeof(ble_gap_sec_params_t));
+
+    // Just Works bonding, the keys and the CCCDs of the central are kept
+    sec_param.bond           = SEC_PARAM_BOND;
+    sec_param.mitm           = SEC_PARAM_MITM;
+    sec_param.lesc           = 0;
+    sec_param.keypress       = 0;
+    sec_param.io_caps        = SEC_PARAM_IO_CAPABILITIES;
+    sec_param.oob            = SEC_PARAM_OOB;
+    sec_param.min_key_size   = SEC_PARAM_MIN_KEY_SIZE;
+    sec_param.max_key_size   = SEC_PARAM_MAX_KEY_SIZE;
+    sec_param.kdist_own.enc  = 1;
+    sec_param.kdist_own.id   = 1;
+    sec_param.kdist_peer.enc = 1;
+    sec_param.kdist_peer.id  = 1;  // The IRK resolves the random addresses of phones
+
+    err_code = pm_sec_params_set(&sec_param);
+    APP_ERROR_CHECK(err_code);
+
+    err_code = pm_register(pm_evt_handler);
+    APP_ERROR_CHECK(err_code);
+
+    NRF_LOG_INFO("🔐 Peer Manager ready, %d bonded centrals", pm_peer_count());
+}
+
+void ble_bonding_conn_secure(uint16_t conn_handle)
+{
+    ret_code_t err_code = pm_conn_secure(conn_handle, false);
+
+    // Busy when the central already started encryption on its own
+    if (err_code != NRF_SUCCESS && err_code != NRF_ERROR_BUSY)
+    {
+        NRF_LOG_WARNING("⚠️ Failed to secure the link: 0x%08X", err_code);
+    }
+}
+
+uint32_t ble_bonding_whitelist_apply(void)
+{
+    pm_peer_id_t peers[BLE_GAP_WHITELIST_ADDR_MAX_COUNT];
+    uint32_t     peer_count = BLE_GAP_WHITELIST_ADDR_MAX_COUNT;
+    pm_peer_id_t irk_peers[BLE_GAP_DEVICE_IDENTITIES_MAX_COUNT];
+    uint32_t     irk_peer_count = BLE_GAP_DEVICE_IDENTITIES_MAX_COUNT;
+    ret_code_t   err_code;
+
+    err_code = pm_peer_id_list(peers, &peer_count, PM_PEER_ID_INVALID, PM_PEER_ID_LIST_SKIP_NO_ID_ADDR);
+    if (err_code != NRF_SUCCESS || peer_count == 0)
+    {
+        return 0;
+    }
+
+    // Phones connect from resolvable addresses, the identities let the SoftDevice match them
+    err_code = pm_peer_id_list(irk_peers, &irk_peer_count, PM_PEER_ID_INVALID, PM_PEER_ID_LIST_SKIP_NO_IRK);
+    if (err_code == NRF_SUCCESS)
+    {
+        err_code = pm_device_identities_list_set(irk_peers, irk_peer_count);
+    }
+    if (err_code == NRF_SUCCESS)
+    {
+        err_code = pm_whitelist_set(peers, peer_count);
+    }
+
+    // In use by a scanner, the caller advertises to all instead
+    if (err_code != NRF_SUCCESS)
+    {
+        NRF_LOG_WARNING("⚠️ Whitelist not available: 0x%08X", err_code);
+        return 0;
+    }
+
+    return peer_count;
+}
+
+#endif // BONDING_ENABLE
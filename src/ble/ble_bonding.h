@@ -0,0 +1,26 @@
+#ifndef BLE_BONDING_H__
+#define BLE_BONDING_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**@brief Initialize the Peer Manager, call once FDS is ready and before advertising starts.
+ *
+ * @details Bonds keep the keys and the CCCD system attributes of each central in FDS, a bonded
+ *          central gets its notifications back on reconnect without writing the CCCDs or
+ *          rediscovering the services. Only built with BONDING=1.
+ *
+ * @param[in] erase_bonds  Delete all bonds first.
+ */
+void peer_manager_init(bool erase_bonds);
+
+/**@brief Secure a new peripheral link, encrypts with a bonded central and pairs a new one. */
+void ble_bonding_conn_secure(uint16_t conn_handle);
+
+/**@brief Put the bonded centrals in the SoftDevice whitelist, advertising must be stopped.
+ *
+ * @return Number of centrals in the whitelist, 0 if there are none or it could not be set.
+ */
+uint32_t ble_bonding_whitelist_apply(void);
+
+#endif // BLE_BONDING_H__
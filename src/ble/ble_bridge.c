@@ -4,41 +4,71 @@
  */
 
 #include "includes/ble_bridge.h"
+#include "includes/data_bus.h"
+#include "includes/resampler.h"
+#include "includes/latency_trace.h"
+#include "includes/virtual_speed.h"
+#include "includes/diagnostics.h"
+#include "includes/deadline_timer.h"
+#include "includes/led_sequencer.h"
 #include "ble/ble_setup.h"
 #include "ble/ble_ftms.h"
 #include "ble/ble_cps.h"
+#include "ble/ble_keiser_gym_service.h"
+#include "ble/ble_ant_agg_service.h"
+#include "ble/ble_ride_stats_service.h"
+#include "ble/ble_diagnostics_service.h"
 #include "common_definitions.h"
 #include "nrf_log.h"
 #include "app_timer.h"
+#include "includes/timer_ticks.h"
 #include "boards.h"
 
 // Forward declaration of sleep function from main
 extern void enter_deep_sleep(void);
 
 // BLE update timer
-APP_TIMER_DEF(m_ble_update_timer);
+static deadline_timer_id_t m_ble_update_timer;
 // Inactivity timer for power saving
-APP_TIMER_DEF(m_inactivity_timer);
+static deadline_timer_id_t m_inactivity_timer;
 
 // Constants
 #define INACTIVITY_TIMEOUT_MS  20000  // 20 seconds inactivity before sleep
 #define INACTIVITY_CHECK_MS    2000   // Check inactivity every second
+#define INACTIVITY_SLACK_MS    1000   // The check may ride along on another wake-up
 #define DATA_TIMEOUT_MS        3000   // 3 seconds without data before zeroing values
-#define APP_TIMER_PRESCALER    0      // Timer prescaler value
-#define APP_TIMER_CLOCK_FREQ   32768  // Timer clock frequency in Hz
+#define OUTPUT_PERIOD_MS       250    // Rider data is sent at 4 Hz whatever rate the source has
+#define OUTPUT_RESAMPLER_MODE  RESAMPLER_ZOH
+#define OUTPUT_DELAY_MS        0      // Linear interpolation needs about one input period (ANT+ 250 ms, Keiser 320 ms)
+#define SLOW_UPDATE_PERIOD_MS  1000   // Gym, aggregator and ride statistics tables
 
 // State tracking
 static bool m_bridge_active = false;
 static bool m_data_ready = false;
 static bool m_is_connected = false;
 static bool m_ant_scan_mode = false;  // Track if we're in ANT+ scan mode
-static cycling_data_t m_latest_data;
+static bool m_gym_mode = false;  // Publishing every Keiser bike in range instead of a single rider
+static bool m_aggregator_mode = false;  // Publishing several ANT+ power meters instead of a single rider
+static resampler_t m_resampler;  // Source samples to the fixed output rate
+static uint8_t m_slow_update_count = 0;
 static uint32_t m_last_data_timestamp = 0;
+static uint8_t m_heart_rate_bpm = 0;  // Fused heart rate, 0 when no strap is seen
+static uint32_t m_heart_rate_timestamp = 0;
+static uint16_t m_measured_speed = 0;  // Wheel speed from the reed sensor, 0.01 km/h
+static uint32_t m_measured_speed_timestamp = 0;
+static bool m_measured_speed_seen = false;
 static uint32_t m_last_connection_timestamp = 0;
+static uint32_t m_last_keep_alive_timestamp = 0;
+static bool m_keep_alive_seen = false;
 
-// Function to convert timer ticks to milliseconds
-static uint32_t ticks_to_ms(uint32_t ticks) {
-    return ((ticks * 1000) / (APP_TIMER_CLOCK_FREQ / (APP_TIMER_PRESCALER + 1)));
+// Speed and distance follow the measured wheel speed while it is fresh, the power otherwise
+static void speed_update(uint16_t power_watts) {
+    if (m_measured_speed_seen &&
+        TICKS_TO_MS(app_timer_cnt_diff_compute(app_timer_cnt_get(), m_measured_speed_timestamp)) < DATA_TIMEOUT_MS) {
+        virtual_speed_update_measured(m_measured_speed);
+    } else {
+        virtual_speed_update(power_watts);
+    }
 }
 
 // Function to handle BLE timer expiration
@@ -47,17 +77,49 @@ static void ble_update_timer_handler(void * p_context) {
         return;
     }
 
-    #if defined(DEBUG) && !defined(RELEASE)
-        bsp_board_led_invert(1);       // Toggle LED2
-    #endif
+    // Tables are only refreshed once per second
+    bool slow_update = (m_slow_update_count == 0);
+    m_slow_update_count = (m_slow_update_count + 1) % (SLOW_UPDATE_PERIOD_MS / OUTPUT_PERIOD_MS);
+
+    if (slow_update) {
+        LED_SEQ_DEBUG_PLAY(LED_SEQ_HEARTBEAT);
+        ble_diagnostics_service_update();
+    }
     
-    uint32_t current_time = app_timer_cnt_get();
-    uint32_t time_since_data = app_timer_cnt_diff_compute(current_time, m_last_data_timestamp);
-    time_since_data = ticks_to_ms(time_since_data);
+    // Gym mode publishes the bike table, there is no single rider to send
+    if (m_gym_mode) {
+        if (slow_update) {
+            ble_keiser_gym_service_update();
+        }
+        return;
+    }
+
+    // Aggregator mode publishes one record per power meter
+    if (m_aggregator_mode) {
+        if (slow_update) {
+            ble_ant_agg_service_update();
+        }
+        return;
+    }
+
+    // Statistics keep counting through gaps, refresh them with or without fresh data
+    if (slow_update) {
+        ble_ride_stats_service_update();
+    }
+
+    // Heart rate is sent with or without cycling data until it goes stale
+    uint8_t heart_rate = m_heart_rate_bpm;
+    if (heart_rate != 0 &&
+        TICKS_TO_MS(app_timer_cnt_diff_compute(app_timer_cnt_get(), m_heart_rate_timestamp)) >= DATA_TIMEOUT_MS) {
+        heart_rate = 0;
+    }
+
+    resampler_sample_t sample;
     
     // If we have no data or data is stale, send zero values
-    if (!m_data_ready || time_since_data >= DATA_TIMEOUT_MS) {
+    if (!m_data_ready || !resampler_output(&m_resampler, app_timer_cnt_get(), &sample)) {
         NRF_LOG_DEBUG("BLE Bridge: No recent data, sending zero values");
+        speed_update(0);
         
         // Update Cycling Power Service
         if (m_cps.conn_handle != BLE_CONN_HANDLE_INVALID) {
@@ -66,23 +128,30 @@ static void ble_update_timer_handler(void * p_context) {
 
         // Update Fitness Machine Service
         if (m_ftms.conn_handle != BLE_CONN_HANDLE_INVALID) {
-            ble_ftms_tick(&m_ftms, 0, 0);
+            ble_ftms_tick(&m_ftms, 0, 0, heart_rate);
         }
         return;
     }
     
+    if (sample.flags & RESAMPLER_FLAG_EXTRAPOLATED) {
+        DIAG_INC(DIAG_OUTPUT_HELD);
+    }
+
     // Update the BLE services with the latest data
-    NRF_LOG_DEBUG("BLE Bridge: Updating services with Power=%d W, Cadence=%d RPM", 
-                  m_latest_data.average_power, m_latest_data.average_cadence);
+    NRF_LOG_DEBUG("BLE Bridge: Updating services with Power=%d W, Cadence=%d RPM%s", 
+                  sample.power, sample.cadence,
+                  (sample.flags & RESAMPLER_FLAG_EXTRAPOLATED) ? " (held)" : "");
+
+    speed_update(sample.power);
 
     // Update Cycling Power Service
     if (m_cps.conn_handle != BLE_CONN_HANDLE_INVALID) {
-        ble_cps_send_power_measurement(&m_cps, m_latest_data.average_power);
+        ble_cps_send_power_measurement(&m_cps, sample.power);
     }
 
     // Update Fitness Machine Service
     if (m_ftms.conn_handle != BLE_CONN_HANDLE_INVALID) {
-        ble_ftms_tick(&m_ftms, m_latest_data.average_power, m_latest_data.average_cadence);
+        ble_ftms_tick(&m_ftms, sample.power, sample.cadence, heart_rate);
     }
 }
 
@@ -93,8 +162,8 @@ static void inactivity_timer_handler(void * p_context) {
     uint32_t time_since_connection = app_timer_cnt_diff_compute(current_time, m_last_connection_timestamp);
     
     // Convert ticks to ms
-    time_since_data = ticks_to_ms(time_since_data);
-    time_since_connection = ticks_to_ms(time_since_connection);
+    time_since_data = TICKS_TO_MS(time_since_data);
+    time_since_connection = TICKS_TO_MS(time_since_connection);
     
     // If we're connected, reset the connection timestamp to now
     // This keeps "time since connection" close to zero while connected
@@ -106,6 +175,12 @@ static void inactivity_timer_handler(void * p_context) {
     NRF_LOG_INFO("BLE Bridge: Inactivity check - Connected: %d, Time since data: %d ms, Time since disconnect: %d ms", 
                   m_is_connected, time_since_data, time_since_connection);
     
+    // Gym and aggregator sources keep the bridge awake while bikes are seen
+    if (m_keep_alive_seen &&
+        TICKS_TO_MS(app_timer_cnt_diff_compute(current_time, m_last_keep_alive_timestamp)) < INACTIVITY_TIMEOUT_MS) {
+        return;
+    }
+
     // If we have a BLE connection
     if (m_is_connected) {
         NRF_LOG_INFO("BLE Bridge: Device is connected, staying active");
@@ -129,15 +204,54 @@ static void inactivity_timer_handler(void * p_context) {
     }
 }
 
+// Data bus handler for power, cadence, heart rate and speed updates
+static void data_bus_handler(const data_bus_snapshot_t *p_snapshot, uint8_t topics) {
+    if (topics & DATA_BUS_TOPIC_HEART_RATE) {
+        m_heart_rate_bpm = p_snapshot->heart_rate_bpm;
+        m_heart_rate_timestamp = p_snapshot->timestamp_ticks;
+    }
+
+    if (topics & DATA_BUS_TOPIC_SPEED) {
+        m_measured_speed = p_snapshot->speed_kmh_x100;
+        m_measured_speed_timestamp = p_snapshot->timestamp_ticks;
+        m_measured_speed_seen = true;
+    }
+
+    // Heart rate or speed alone does not count as rider data
+    if ((topics & (DATA_BUS_TOPIC_POWER | DATA_BUS_TOPIC_CADENCE)) == 0) {
+        return;
+    }
+
+    // The services read the resampled value on the next output tick
+    resampler_push(&m_resampler, p_snapshot->sample_ticks,
+                   p_snapshot->cycling.average_power, p_snapshot->cycling.average_cadence);
+    latency_trace_queued(p_snapshot->sample_ticks, p_snapshot->timestamp_ticks);
+    m_data_ready = true;
+
+    // Data after a pause, a rider is about to look for the bridge
+    if (!m_is_connected && (m_last_data_timestamp == 0 ||
+        TICKS_TO_MS(app_timer_cnt_diff_compute(p_snapshot->timestamp_ticks, m_last_data_timestamp)) >= DATA_TIMEOUT_MS)) {
+        advertising_fast_restart();
+    }
+    
+    // Update the timestamp of the last data received
+    m_last_data_timestamp = p_snapshot->timestamp_ticks;
+    
+    // Log only in debug mode to avoid excessive logging
+    NRF_LOG_DEBUG("BLE Bridge: Data updated - Power=%d W, Cadence=%d RPM", 
+                  p_snapshot->cycling.average_power, p_snapshot->cycling.average_cadence);
+}
+
 bool ble_bridge_init(void) {
     uint32_t err_code;
     
     // Create a timer for periodic BLE updates
-    err_code = app_timer_create(&m_ble_update_timer, APP_TIMER_MODE_REPEATED, ble_update_timer_handler);
+    err_code = deadline_timer_create(&m_ble_update_timer, DEADLINE_TIMER_MODE_REPEATED, 0, ble_update_timer_handler);
     APP_ERROR_CHECK(err_code);
     
     // Create a timer for inactivity checking
-    err_code = app_timer_create(&m_inactivity_timer, APP_TIMER_MODE_REPEATED, inactivity_timer_handler);
+    err_code = deadline_timer_create(&m_inactivity_timer, DEADLINE_TIMER_MODE_REPEATED, INACTIVITY_SLACK_MS,
+                                     inactivity_timer_handler);
     APP_ERROR_CHECK(err_code);
     
     // Initialize state variables
@@ -146,7 +260,17 @@ bool ble_bridge_init(void) {
     m_is_connected = false;
     m_ant_scan_mode = false;
     m_last_data_timestamp = 0;
+    m_heart_rate_bpm = 0;
+    m_measured_speed_seen = false;
     m_last_connection_timestamp = app_timer_cnt_get(); // Start counting from init
+    resampler_init(&m_resampler, OUTPUT_RESAMPLER_MODE, OUTPUT_DELAY_MS, DATA_TIMEOUT_MS);
+    
+    // Every sample goes into the resampler, the services are updated on the output timer
+    if (!data_bus_subscribe(data_bus_handler,
+                            DATA_BUS_TOPIC_POWER | DATA_BUS_TOPIC_CADENCE |
+                            DATA_BUS_TOPIC_HEART_RATE | DATA_BUS_TOPIC_SPEED, 0)) {
+        return false;
+    }
     
     NRF_LOG_INFO("BLE Bridge: Initialized");
     
@@ -154,18 +278,14 @@ bool ble_bridge_init(void) {
 }
 
 bool ble_bridge_start(void) {
-    uint32_t err_code;
-    
     // Start BLE advertising
     start_ble_advertising();
     
-    // Start the BLE update timer (every 1 second)
-    err_code = app_timer_start(m_ble_update_timer, APP_TIMER_TICKS(1000), NULL);
-    APP_ERROR_CHECK(err_code);
+    // Start the BLE update timer at the output rate
+    deadline_timer_start(m_ble_update_timer, OUTPUT_PERIOD_MS, NULL);
     
     // Start the inactivity timer
-    err_code = app_timer_start(m_inactivity_timer, APP_TIMER_TICKS(INACTIVITY_CHECK_MS), NULL);
-    APP_ERROR_CHECK(err_code);
+    deadline_timer_start(m_inactivity_timer, INACTIVITY_CHECK_MS, NULL);
     
     m_bridge_active = true;
     
@@ -179,10 +299,10 @@ void ble_bridge_stop(void) {
     stop_ble_advertising();
     
     // Stop the BLE update timer
-    app_timer_stop(m_ble_update_timer);
+    deadline_timer_stop(m_ble_update_timer);
     
     // Stop the inactivity timer
-    app_timer_stop(m_inactivity_timer);
+    deadline_timer_stop(m_inactivity_timer);
     
     m_bridge_active = false;
     
@@ -193,19 +313,6 @@ bool ble_bridge_is_active(void) {
     return m_bridge_active;
 }
 
-void ble_bridge_update_data(cycling_data_t data) {
-    // Store the latest data
-    m_latest_data = data;
-    m_data_ready = true;
-    
-    // Update the timestamp of the last data received
-    m_last_data_timestamp = app_timer_cnt_get();
-    
-    // Log only in debug mode to avoid excessive logging
-    NRF_LOG_DEBUG("BLE Bridge: Data updated - Power=%d W, Cadence=%d RPM", 
-                  data.average_power, data.average_cadence);
-}
-
 void ble_bridge_connection_event(bool connected) {
     m_is_connected = connected;
     m_last_connection_timestamp = app_timer_cnt_get();
@@ -231,7 +338,7 @@ void ble_bridge_data_source_lost(void) {
     if (!m_is_connected) {
         uint32_t current_time = app_timer_cnt_get();
         uint32_t time_since_data = app_timer_cnt_diff_compute(current_time, m_last_data_timestamp);
-        time_since_data = ticks_to_ms(time_since_data);
+        time_since_data = TICKS_TO_MS(time_since_data);
         
         if (time_since_data >= INACTIVITY_TIMEOUT_MS) {
             NRF_LOG_INFO("BLE Bridge: No connection and no data for %d ms, entering deep sleep", time_since_data);
@@ -250,6 +357,23 @@ void ble_bridge_set_ant_scan_mode(bool enabled) {
     NRF_LOG_INFO("BLE Bridge: ANT+ scan mode %s", enabled ? "enabled" : "disabled");
 }
 
+// Function to set Keiser gym mode
+void ble_bridge_set_gym_mode(bool enabled) {
+    m_gym_mode = enabled;
+    NRF_LOG_INFO("BLE Bridge: Gym mode %s", enabled ? "enabled" : "disabled");
+}
+
+// Function to set ANT+ aggregator mode
+void ble_bridge_set_aggregator_mode(bool enabled) {
+    m_aggregator_mode = enabled;
+    NRF_LOG_INFO("BLE Bridge: Aggregator mode %s", enabled ? "enabled" : "disabled");
+}
+
+void ble_bridge_keep_alive(void) {
+    m_last_keep_alive_timestamp = app_timer_cnt_get();
+    m_keep_alive_seen = true;
+}
+
 void ble_bridge_reset_data_timestamp(void) {
     m_last_data_timestamp = app_timer_cnt_get();
     NRF_LOG_DEBUG("BLE Bridge: Reset data timestamp");
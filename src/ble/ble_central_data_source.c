@@ -0,0 +1,859 @@
+/**
+ * @file ble_central_data_source.c
+ * @brief Implementation of the BLE Cycling Power / FTMS Client Data Source
+ */
+
+#include "ble_central_data_source.h"
+#include <string.h>
+#include "app_util.h"
+#include "app_timer.h"
+#include "includes/timer_ticks.h"
+#include "app_error.h"
+#include "nrf_log.h"
+#include "nrf_sdh.h"
+#include "nrf_sdh_ble.h"
+#include "fds.h"
+#include "ble_custom_config.h"
+#include "includes/deadline_timer.h"
+#include "includes/data_manager.h"
+
+#define BLE_CENTRAL_BLE_OBSERVER_PRIO 2
+
+// Discovered handles are cached in flash and reused on every reconnect
+#define HANDLE_CACHE_FILE     (0x8011)
+#define HANDLE_CACHE_REC_KEY  (0x7021)
+
+#define RETRY_SLACK_MS        500   // Reconnect attempts need not be punctual
+#define DATA_TIMEOUT_SLACK_MS 500   // Retriggered per measurement
+#define CRANK_STALE_MS        2500  // Cadence drops to zero after this long without a new crank event
+
+#define BLE_UUID_CCCD         0x2902
+#define BLE_UUID_CHAR_DECL    0x2803
+
+/**
+ * @brief Client states
+ */
+typedef enum {
+    CENTRAL_STATE_IDLE,
+    CENTRAL_STATE_WAIT_RETRY,
+    CENTRAL_STATE_SCANNING,
+    CENTRAL_STATE_CONNECTING,
+    CENTRAL_STATE_DISCOVER_SERVICE,
+    CENTRAL_STATE_DISCOVER_CHAR,
+    CENTRAL_STATE_DISCOVER_CCCD,
+    CENTRAL_STATE_SUBSCRIBING,
+    CENTRAL_STATE_SUBSCRIBED,
+} central_state_t;
+
+/**
+ * @brief Handles cached in flash, valid for one peer address
+ */
+typedef struct {
+    uint8_t  peer_mac[BLE_GAP_ADDR_LEN];  // Peer address as reported by the stack (little-endian)
+    uint8_t  peer_type;                   // ble_central_peer_type_t
+    uint8_t  reserved;
+    uint16_t value_handle;                // Measurement characteristic value
+    uint16_t cccd_handle;                 // Its Client Characteristic Configuration Descriptor
+} handle_cache_t;
+
+// Reconnect backoff schedule, the last entry repeats
+static const uint32_t m_backoff_ms[] = {1000, 2000, 5000, 10000, 30000};
+
+// Forward declarations
+static void ble_evt_handler(ble_evt_t const *p_ble_evt, void *p_context);
+static void fds_evt_handler(fds_evt_t const *p_evt);
+static void schedule_reconnect(void);
+
+NRF_SDH_BLE_OBSERVER(m_ble_central_observer, BLE_CENTRAL_BLE_OBSERVER_PRIO, ble_evt_handler, NULL);
+
+static deadline_timer_id_t m_retry_timer;
+static deadline_timer_id_t m_data_timeout_timer;
+
+// Static variables
+static data_source_config_t m_config;
+static central_state_t m_state = CENTRAL_STATE_IDLE;
+static uint16_t m_conn_handle_central = BLE_CONN_HANDLE_INVALID;
+static uint8_t m_backoff_index = 0;
+static bool m_is_active = false;
+
+static handle_cache_t m_cache;                 // Handles in use for the current peer
+static bool m_cache_valid = false;             // m_cache holds usable handles for the target
+static bool m_cache_from_flash = false;        // Handles came from flash, not from discovery on this link
+static handle_cache_t m_cache_record __attribute__((aligned(4)));  // Buffer handed to FDS
+static bool m_fds_registered = false;
+static bool m_gc_pending = false;              // The cache write waits for our garbage collection
+
+static ble_central_peer_type_t m_try_type;     // Service being discovered
+static uint16_t m_service_end;                 // Last handle of the discovered service
+
+// Crank revolution state for CPS cadence
+static uint16_t m_last_crank_revs;
+static uint16_t m_last_crank_time;
+static uint32_t m_last_crank_ticks;    // app_timer counter of the last new crank event
+static bool m_crank_valid = false;
+static uint8_t m_last_cadence = 0;
+
+static uint8_t m_scan_buffer_data[BLE_GAP_SCAN_BUFFER_MIN];
+static ble_data_t m_scan_buffer = {
+    .p_data = m_scan_buffer_data,
+    .len = BLE_GAP_SCAN_BUFFER_MIN
+};
+
+static ble_gap_scan_params_t const m_scan_params = {
+    .active = 0,
+    .interval = MSEC_TO_UNITS(BLE_CENTRAL_SCAN_INTERVAL_MS, UNIT_0_625_MS),
+    .window = MSEC_TO_UNITS(BLE_CENTRAL_SCAN_WINDOW_MS, UNIT_0_625_MS),
+    .timeout = BLE_CENTRAL_SCAN_TIMEOUT_MS / 10,  // 10 ms units
+    .filter_policy = BLE_GAP_SCAN_FP_ACCEPT_ALL,
+    .scan_phys = BLE_GAP_PHY_1MBPS
+};
+
+static ble_gap_conn_params_t const m_conn_params = {
+    .min_conn_interval = BLE_CENTRAL_MIN_CONN_INTERVAL,
+    .max_conn_interval = BLE_CENTRAL_MAX_CONN_INTERVAL,
+    .slave_latency = BLE_CENTRAL_SLAVE_LATENCY,
+    .conn_sup_timeout = BLE_CENTRAL_SUP_TIMEOUT
+};
+
+// Check the reported address against the configured one (stored most significant byte first)
+static bool is_target(const uint8_t *p_addr)
+{
+    for (uint8_t i = 0; i < BLE_GAP_ADDR_LEN; i++)
+    {
+        if (p_addr[i] != m_keiser_mac[BLE_GAP_ADDR_LEN - 1 - i])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void report_data(uint16_t power, uint8_t cadence)
+{
+    m_is_active = true;
+
+    if (m_config.data_callback != NULL)
+    {
+        m_config.data_callback(power, cadence, app_timer_cnt_get());
+    }
+
+    deadline_timer_start(m_data_timeout_timer, BLE_CENTRAL_DATA_TIMEOUT_MS, NULL);
+}
+
+static void report_lost(void)
+{
+    m_is_active = false;
+    m_crank_valid = false;
+    deadline_timer_stop(m_data_timeout_timer);
+
+    if (m_config.data_callback != NULL)
+    {
+        m_config.data_callback(0, 0, app_timer_cnt_get());  // Send zero values to indicate loss
+    }
+}
+
+/**@brief Load the handle cache from flash */
+static void cache_load(void)
+{
+    fds_record_desc_t desc = {0};
+    fds_find_token_t ftok = {0};
+
+    m_cache_valid = false;
+
+    if (fds_record_find(HANDLE_CACHE_FILE, HANDLE_CACHE_REC_KEY, &desc, &ftok) != NRF_SUCCESS)
+    {
+        return;
+    }
+
+    fds_flash_record_t record;
+    if (fds_record_open(&desc, &record) != NRF_SUCCESS)
+    {
+        return;
+    }
+
+    // A record of another layout is dropped rather than misread
+    if (record.p_header->length_words != (sizeof(m_cache) + 3) / 4)
+    {
+        fds_record_close(&desc);
+        return;
+    }
+
+    memcpy(&m_cache, record.p_data, sizeof(m_cache));
+    fds_record_close(&desc);
+
+    m_cache_valid = is_target(m_cache.peer_mac) && m_cache.value_handle != 0 && m_cache.cccd_handle != 0;
+    m_cache_from_flash = m_cache_valid;
+    if (m_cache_valid)
+    {
+        NRF_LOG_INFO("BLE Central: Using cached handles, value 0x%04X, CCCD 0x%04X",
+                     m_cache.value_handle, m_cache.cccd_handle);
+    }
+}
+
+/**@brief Write m_cache_record, collect garbage once if flash is full
+ *
+ * @param allow_gc False for the retry after our own collection
+ */
+static void cache_write(bool allow_gc)
+{
+    fds_record_t record = {
+        .file_id = HANDLE_CACHE_FILE,
+        .key = HANDLE_CACHE_REC_KEY,
+        .data = {
+            .p_data = &m_cache_record,
+            .length_words = (sizeof(m_cache_record) + 3) / 4,
+        }
+    };
+
+    fds_record_desc_t desc = {0};
+    fds_find_token_t ftok = {0};
+    ret_code_t ret;
+
+    if (fds_record_find(HANDLE_CACHE_FILE, HANDLE_CACHE_REC_KEY, &desc, &ftok) == NRF_SUCCESS)
+    {
+        ret = fds_record_update(&desc, &record);
+    }
+    else
+    {
+        ret = fds_record_write(&desc, &record);
+    }
+
+    if (ret == FDS_ERR_NO_SPACE_IN_FLASH && allow_gc)
+    {
+        // Every update leaves a dirty record behind, reclaim them and write again
+        ret = fds_gc();
+        m_gc_pending = (ret == NRF_SUCCESS);
+    }
+
+    if (ret != NRF_SUCCESS)
+    {
+        NRF_LOG_WARNING("BLE Central: Failed to cache handles: %d", ret);
+    }
+}
+
+/**@brief Store the handles of the current peer in flash */
+static void cache_store(void)
+{
+    m_cache_record = m_cache;
+    cache_write(true);
+}
+
+static void fds_evt_handler(fds_evt_t const *p_evt)
+{
+    if ((p_evt->id == FDS_EVT_WRITE || p_evt->id == FDS_EVT_UPDATE) &&
+        p_evt->write.record_key == HANDLE_CACHE_REC_KEY)
+    {
+        NRF_LOG_INFO("BLE Central: Handle cache %s", (p_evt->result == NRF_SUCCESS) ? "stored" : "write failed");
+    }
+
+    // Other modules collect garbage as well, only a collection we asked for retries the write
+    if (p_evt->id == FDS_EVT_GC && m_gc_pending)
+    {
+        m_gc_pending = false;
+        if (p_evt->result == NRF_SUCCESS)
+        {
+            cache_write(false);
+        }
+        else
+        {
+            NRF_LOG_WARNING("BLE Central: Garbage collection failed: %d", p_evt->result);
+        }
+    }
+}
+
+/**@brief Start scanning for the configured sensor */
+static void scan_start(void)
+{
+    uint32_t err_code = sd_ble_gap_scan_start(&m_scan_params, &m_scan_buffer);
+    if (err_code != NRF_SUCCESS)
+    {
+        NRF_LOG_ERROR("BLE Central: Failed to start scanning: %d", err_code);
+        schedule_reconnect();
+        return;
+    }
+
+    m_state = CENTRAL_STATE_SCANNING;
+}
+
+static void retry_timer_handler(void *p_context)
+{
+    if (m_state == CENTRAL_STATE_WAIT_RETRY)
+    {
+        scan_start();
+    }
+}
+
+static void data_timeout_handler(void *p_context)
+{
+    NRF_LOG_INFO("BLE Central: No measurement received");
+    report_lost();
+}
+
+/**@brief Wait for the next entry of the backoff schedule, then scan again */
+static void schedule_reconnect(void)
+{
+    uint32_t delay_ms = m_backoff_ms[m_backoff_index];
+    if (m_backoff_index < ARRAY_SIZE(m_backoff_ms) - 1)
+    {
+        m_backoff_index++;
+    }
+
+    m_state = CENTRAL_STATE_WAIT_RETRY;
+    NRF_LOG_INFO("BLE Central: Reconnecting in %d ms", delay_ms);
+
+    deadline_timer_start(m_retry_timer, delay_ms, NULL);
+}
+
+/**@brief Enable notifications on the measurement characteristic */
+static void subscribe(void)
+{
+    static uint8_t cccd_value[2] = {BLE_GATT_HVX_NOTIFICATION, 0};
+
+    ble_gattc_write_params_t write_params = {
+        .write_op = BLE_GATT_OP_WRITE_REQ,
+        .flags = 0,
+        .handle = m_cache.cccd_handle,
+        .offset = 0,
+        .len = sizeof(cccd_value),
+        .p_value = cccd_value
+    };
+
+    uint32_t err_code = sd_ble_gattc_write(m_conn_handle_central, &write_params);
+    if (err_code != NRF_SUCCESS)
+    {
+        NRF_LOG_ERROR("BLE Central: CCCD write failed: %d", err_code);
+        (void)sd_ble_gap_disconnect(m_conn_handle_central, BLE_HCI_REMOTE_USER_TERMINATED_CONNECTION);
+        return;
+    }
+
+    m_state = CENTRAL_STATE_SUBSCRIBING;
+}
+
+/**@brief Discover the primary service of the given type */
+static void discover_service(ble_central_peer_type_t type)
+{
+    ble_uuid_t uuid = {
+        .uuid = (type == BLE_CENTRAL_PEER_CPS) ? BLE_CENTRAL_CPS_UUID : BLE_CENTRAL_FTMS_UUID,
+        .type = BLE_UUID_TYPE_BLE
+    };
+
+    m_try_type = type;
+    m_state = CENTRAL_STATE_DISCOVER_SERVICE;
+
+    uint32_t err_code = sd_ble_gattc_primary_services_discover(m_conn_handle_central, 0x0001, &uuid);
+    if (err_code != NRF_SUCCESS)
+    {
+        NRF_LOG_ERROR("BLE Central: Service discovery failed: %d", err_code);
+        (void)sd_ble_gap_disconnect(m_conn_handle_central, BLE_HCI_REMOTE_USER_TERMINATED_CONNECTION);
+    }
+}
+
+static void discover_characteristics(uint16_t start_handle)
+{
+    ble_gattc_handle_range_t range = {
+        .start_handle = start_handle,
+        .end_handle = m_service_end
+    };
+
+    m_state = CENTRAL_STATE_DISCOVER_CHAR;
+
+    uint32_t err_code = sd_ble_gattc_characteristics_discover(m_conn_handle_central, &range);
+    if (err_code != NRF_SUCCESS)
+    {
+        NRF_LOG_ERROR("BLE Central: Characteristic discovery failed: %d", err_code);
+        (void)sd_ble_gap_disconnect(m_conn_handle_central, BLE_HCI_REMOTE_USER_TERMINATED_CONNECTION);
+    }
+}
+
+static void discover_cccd(void)
+{
+    ble_gattc_handle_range_t range = {
+        .start_handle = m_cache.value_handle + 1,
+        .end_handle = m_service_end
+    };
+
+    m_state = CENTRAL_STATE_DISCOVER_CCCD;
+
+    uint32_t err_code = sd_ble_gattc_descriptors_discover(m_conn_handle_central, &range);
+    if (err_code != NRF_SUCCESS)
+    {
+        NRF_LOG_ERROR("BLE Central: Descriptor discovery failed: %d", err_code);
+        (void)sd_ble_gap_disconnect(m_conn_handle_central, BLE_HCI_REMOTE_USER_TERMINATED_CONNECTION);
+    }
+}
+
+/**@brief Service discovery response: CPS first, then FTMS */
+static void on_service_disc_rsp(ble_gattc_evt_t const *p_gattc_evt)
+{
+    ble_gattc_evt_prim_srvc_disc_rsp_t const *p_rsp = &p_gattc_evt->params.prim_srvc_disc_rsp;
+
+    if (p_gattc_evt->gatt_status == BLE_GATT_STATUS_SUCCESS && p_rsp->count > 0)
+    {
+        m_service_end = p_rsp->services[0].handle_range.end_handle;
+        discover_characteristics(p_rsp->services[0].handle_range.start_handle);
+        return;
+    }
+
+    if (m_try_type == BLE_CENTRAL_PEER_CPS)
+    {
+        discover_service(BLE_CENTRAL_PEER_FTMS);
+        return;
+    }
+
+    NRF_LOG_ERROR("BLE Central: Peer has neither Cycling Power nor FTMS");
+    (void)sd_ble_gap_disconnect(m_conn_handle_central, BLE_HCI_REMOTE_USER_TERMINATED_CONNECTION);
+}
+
+static void on_char_disc_rsp(ble_gattc_evt_t const *p_gattc_evt)
+{
+    ble_gattc_evt_char_disc_rsp_t const *p_rsp = &p_gattc_evt->params.char_disc_rsp;
+    uint16_t wanted = (m_try_type == BLE_CENTRAL_PEER_CPS) ? BLE_CENTRAL_CPS_MEAS_UUID : BLE_CENTRAL_FTMS_BIKE_DATA_UUID;
+
+    if (p_gattc_evt->gatt_status == BLE_GATT_STATUS_SUCCESS)
+    {
+        for (uint16_t i = 0; i < p_rsp->count; i++)
+        {
+            if (p_rsp->chars[i].uuid.type == BLE_UUID_TYPE_BLE && p_rsp->chars[i].uuid.uuid == wanted)
+            {
+                m_cache.value_handle = p_rsp->chars[i].handle_value;
+                discover_cccd();
+                return;
+            }
+        }
+
+        // Not in this batch, continue after the last characteristic
+        if (p_rsp->count > 0 && p_rsp->chars[p_rsp->count - 1].handle_value < m_service_end)
+        {
+            discover_characteristics(p_rsp->chars[p_rsp->count - 1].handle_value + 1);
+            return;
+        }
+    }
+
+    if (m_try_type == BLE_CENTRAL_PEER_CPS)
+    {
+        discover_service(BLE_CENTRAL_PEER_FTMS);
+        return;
+    }
+
+    NRF_LOG_ERROR("BLE Central: Measurement characteristic not found");
+    (void)sd_ble_gap_disconnect(m_conn_handle_central, BLE_HCI_REMOTE_USER_TERMINATED_CONNECTION);
+}
+
+static void on_desc_disc_rsp(ble_gattc_evt_t const *p_gattc_evt)
+{
+    ble_gattc_evt_desc_disc_rsp_t const *p_rsp = &p_gattc_evt->params.desc_disc_rsp;
+
+    if (p_gattc_evt->gatt_status == BLE_GATT_STATUS_SUCCESS)
+    {
+        for (uint16_t i = 0; i < p_rsp->count; i++)
+        {
+            if (p_rsp->descs[i].uuid.uuid == BLE_UUID_CHAR_DECL)
+            {
+                break;  // Reached the next characteristic
+            }
+            if (p_rsp->descs[i].uuid.uuid == BLE_UUID_CCCD)
+            {
+                m_cache.cccd_handle = p_rsp->descs[i].handle;
+                m_cache.peer_type = m_try_type;
+                m_cache_valid = true;
+                m_cache_from_flash = false;
+
+                NRF_LOG_INFO("BLE Central: Discovered %s, value 0x%04X, CCCD 0x%04X",
+                             (m_try_type == BLE_CENTRAL_PEER_CPS) ? "CPS" : "FTMS",
+                             m_cache.value_handle, m_cache.cccd_handle);
+
+                cache_store();
+                subscribe();
+                return;
+            }
+        }
+    }
+
+    NRF_LOG_ERROR("BLE Central: Measurement characteristic has no CCCD");
+    (void)sd_ble_gap_disconnect(m_conn_handle_central, BLE_HCI_REMOTE_USER_TERMINATED_CONNECTION);
+}
+
+static void on_write_rsp(ble_gattc_evt_t const *p_gattc_evt)
+{
+    if (m_state != CENTRAL_STATE_SUBSCRIBING)
+    {
+        return;
+    }
+
+    if (p_gattc_evt->gatt_status != BLE_GATT_STATUS_SUCCESS)
+    {
+        m_cache_valid = false;
+
+        if (m_cache_from_flash)
+        {
+            // Cached handles no longer match the peer's database, discover again
+            NRF_LOG_WARNING("BLE Central: CCCD write rejected (0x%04X), rediscovering", p_gattc_evt->gatt_status);
+            m_cache_from_flash = false;
+            discover_service(BLE_CENTRAL_PEER_CPS);
+            return;
+        }
+
+        NRF_LOG_ERROR("BLE Central: CCCD write rejected (0x%04X)", p_gattc_evt->gatt_status);
+        (void)sd_ble_gap_disconnect(m_conn_handle_central, BLE_HCI_REMOTE_USER_TERMINATED_CONNECTION);
+        return;
+    }
+
+    m_state = CENTRAL_STATE_SUBSCRIBED;
+    m_backoff_index = 0;
+    NRF_LOG_INFO("✅ BLE Central: Subscribed to %s", (m_cache.peer_type == BLE_CENTRAL_PEER_CPS) ? "Cycling Power" : "Indoor Bike Data");
+}
+
+/**@brief Parse a Cycling Power Measurement */
+static void parse_cps(uint8_t const *p_data, uint16_t len)
+{
+    if (len < 4) return;
+
+    uint16_t flags = uint16_decode(&p_data[0]);
+    int16_t power = (int16_t)uint16_decode(&p_data[2]);
+    uint16_t offset = 4;
+
+    if (flags & 0x0001) offset += 1;  // Pedal Power Balance
+    if (flags & 0x0004) offset += 2;  // Accumulated Torque
+    if (flags & 0x0010) offset += 6;  // Wheel Revolution Data
+
+    if ((flags & 0x0020) && len >= offset + 4)  // Crank Revolution Data
+    {
+        uint16_t crank_revs = uint16_decode(&p_data[offset]);
+        uint16_t crank_time = uint16_decode(&p_data[offset + 2]);  // 1/1024 s
+        uint32_t now = app_timer_cnt_get();
+
+        if (!m_crank_valid)
+        {
+            m_last_crank_ticks = now;
+        }
+        else
+        {
+            uint16_t d_revs = crank_revs - m_last_crank_revs;
+            uint16_t d_time = crank_time - m_last_crank_time;
+            if (d_revs > 0 && d_time > 0)
+            {
+                uint32_t rpm = ((uint32_t)d_revs * 60 * 1024) / d_time;
+                m_last_cadence = (rpm > 255) ? 255 : (uint8_t)rpm;
+                m_last_crank_ticks = now;
+            }
+            else if (TICKS_TO_MS(app_timer_cnt_diff_compute(now, m_last_crank_ticks)) >= CRANK_STALE_MS)
+            {
+                // Meters repeat the last crank event between strokes, only a long gap means stopped
+                m_last_cadence = 0;
+            }
+        }
+
+        m_last_crank_revs = crank_revs;
+        m_last_crank_time = crank_time;
+        m_crank_valid = true;
+    }
+
+    report_data((power < 0) ? 0 : (uint16_t)power, m_last_cadence);
+}
+
+/**@brief Parse FTMS Indoor Bike Data */
+static void parse_ftms(uint8_t const *p_data, uint16_t len)
+{
+    if (len < 2) return;
+
+    uint16_t flags = uint16_decode(&p_data[0]);
+    uint16_t offset = 2;
+    uint8_t cadence = 0;
+    uint16_t power = 0;
+    bool has_power = false;
+
+    if (!(flags & 0x0001)) offset += 2;  // Instantaneous Speed, present when More Data is 0
+    if (flags & 0x0002) offset += 2;     // Average Speed
+    if (flags & 0x0004)                  // Instantaneous Cadence, 0.5 RPM
+    {
+        if (len < offset + 2) return;
+        cadence = (uint8_t)(uint16_decode(&p_data[offset]) / 2);
+        offset += 2;
+    }
+    if (flags & 0x0008) offset += 2;     // Average Cadence
+    if (flags & 0x0010) offset += 3;     // Total Distance
+    if (flags & 0x0020) offset += 2;     // Resistance Level
+    if (flags & 0x0040)                  // Instantaneous Power
+    {
+        if (len < offset + 2) return;
+        int16_t raw = (int16_t)uint16_decode(&p_data[offset]);
+        power = (raw < 0) ? 0 : (uint16_t)raw;
+        has_power = true;
+        offset += 2;
+    }
+    if (flags & 0x0080) offset += 2;     // Average Power
+    if (flags & 0x0100) offset += 5;     // Expended Energy
+
+    // Some machines split Indoor Bike Data over several notifications
+    if (has_power || (flags & 0x0004))
+    {
+        report_data(power, cadence);
+    }
+
+    if ((flags & 0x0200) && len >= offset + 1)  // Heart Rate, after the data so the source is active
+    {
+        data_manager_report_heart_rate(m_config.type, p_data[offset]);
+    }
+}
+
+static void on_hvx(ble_gattc_evt_t const *p_gattc_evt)
+{
+    ble_gattc_evt_hvx_t const *p_hvx = &p_gattc_evt->params.hvx;
+
+    if (p_hvx->handle != m_cache.value_handle)
+    {
+        return;
+    }
+
+    if (p_hvx->type == BLE_GATT_HVX_INDICATION)
+    {
+        (void)sd_ble_gattc_hv_confirm(p_gattc_evt->conn_handle, p_hvx->handle);
+    }
+
+    if (m_cache.peer_type == BLE_CENTRAL_PEER_CPS)
+    {
+        parse_cps(p_hvx->data, p_hvx->len);
+    }
+    else
+    {
+        parse_ftms(p_hvx->data, p_hvx->len);
+    }
+}
+
+static void on_adv_report(ble_gap_evt_adv_report_t const *p_report)
+{
+    if (!is_target(p_report->peer_addr.addr))
+    {
+        (void)sd_ble_gap_scan_start(NULL, &m_scan_buffer);  // Keep listening
+        return;
+    }
+
+    NRF_LOG_INFO("BLE Central: Sensor found (RSSI %d), connecting", p_report->rssi);
+
+    uint32_t err_code = sd_ble_gap_connect(&p_report->peer_addr, &m_scan_params, &m_conn_params, APP_BLE_CONN_CFG_TAG);
+    if (err_code != NRF_SUCCESS)
+    {
+        NRF_LOG_ERROR("BLE Central: Connect failed: %d", err_code);
+        schedule_reconnect();
+        return;
+    }
+
+    m_state = CENTRAL_STATE_CONNECTING;
+}
+
+static void on_connected(ble_gap_evt_t const *p_gap_evt)
+{
+    m_conn_handle_central = p_gap_evt->conn_handle;
+    m_crank_valid = false;
+    NRF_LOG_INFO("✅ BLE Central: Connected to sensor");
+
+    if (m_cache_valid)
+    {
+        subscribe();  // Skip discovery, handles were cached on an earlier connection
+    }
+    else
+    {
+        memcpy(m_cache.peer_mac, p_gap_evt->params.connected.peer_addr.addr, BLE_GAP_ADDR_LEN);
+        discover_service(BLE_CENTRAL_PEER_CPS);
+    }
+}
+
+static void ble_evt_handler(ble_evt_t const *p_ble_evt, void *p_context)
+{
+    if (m_state == CENTRAL_STATE_IDLE)
+    {
+        return;
+    }
+
+    ble_gap_evt_t const *p_gap_evt = &p_ble_evt->evt.gap_evt;
+    ble_gattc_evt_t const *p_gattc_evt = &p_ble_evt->evt.gattc_evt;
+
+    switch (p_ble_evt->header.evt_id)
+    {
+        case BLE_GAP_EVT_ADV_REPORT:
+            if (m_state == CENTRAL_STATE_SCANNING)
+            {
+                on_adv_report(&p_gap_evt->params.adv_report);
+            }
+            break;
+
+        case BLE_GAP_EVT_TIMEOUT:
+            if ((p_gap_evt->params.timeout.src == BLE_GAP_TIMEOUT_SRC_SCAN && m_state == CENTRAL_STATE_SCANNING) ||
+                (p_gap_evt->params.timeout.src == BLE_GAP_TIMEOUT_SRC_CONN && m_state == CENTRAL_STATE_CONNECTING))
+            {
+                NRF_LOG_INFO("BLE Central: Sensor not found");
+                schedule_reconnect();
+            }
+            break;
+
+        case BLE_GAP_EVT_CONNECTED:
+            if (p_gap_evt->params.connected.role == BLE_GAP_ROLE_CENTRAL)
+            {
+                on_connected(p_gap_evt);
+            }
+            break;
+
+        case BLE_GAP_EVT_DISCONNECTED:
+            if (p_gap_evt->conn_handle == m_conn_handle_central)
+            {
+                NRF_LOG_WARNING("⚠️ BLE Central: Sensor disconnected, reason 0x%02X", p_gap_evt->params.disconnected.reason);
+                m_conn_handle_central = BLE_CONN_HANDLE_INVALID;
+                report_lost();
+                schedule_reconnect();
+            }
+            break;
+
+        case BLE_GAP_EVT_CONN_PARAM_UPDATE_REQUEST:
+            if (p_gap_evt->conn_handle == m_conn_handle_central)
+            {
+                // Keep the link short and without latency, the request only moves the interval within our range
+                ble_gap_conn_params_t params = p_gap_evt->params.conn_param_update_request.conn_params;
+                params.min_conn_interval = MAX(params.min_conn_interval, BLE_CENTRAL_MIN_CONN_INTERVAL);
+                params.min_conn_interval = MIN(params.min_conn_interval, BLE_CENTRAL_MAX_CONN_INTERVAL);
+                params.max_conn_interval = MAX(params.max_conn_interval, params.min_conn_interval);
+                params.max_conn_interval = MIN(params.max_conn_interval, BLE_CENTRAL_MAX_CONN_INTERVAL);
+                params.slave_latency = BLE_CENTRAL_SLAVE_LATENCY;
+                params.conn_sup_timeout = BLE_CENTRAL_SUP_TIMEOUT;
+
+                uint32_t err_code = sd_ble_gap_conn_param_update(m_conn_handle_central, &params);
+                if (err_code != NRF_SUCCESS)
+                {
+                    NRF_LOG_WARNING("BLE Central: Connection parameter update failed: 0x%08X", err_code);
+                }
+            }
+            break;
+
+        case BLE_GATTC_EVT_PRIM_SRVC_DISC_RSP:
+            if (p_gattc_evt->conn_handle == m_conn_handle_central) on_service_disc_rsp(p_gattc_evt);
+            break;
+
+        case BLE_GATTC_EVT_CHAR_DISC_RSP:
+            if (p_gattc_evt->conn_handle == m_conn_handle_central) on_char_disc_rsp(p_gattc_evt);
+            break;
+
+        case BLE_GATTC_EVT_DESC_DISC_RSP:
+            if (p_gattc_evt->conn_handle == m_conn_handle_central) on_desc_disc_rsp(p_gattc_evt);
+            break;
+
+        case BLE_GATTC_EVT_WRITE_RSP:
+            if (p_gattc_evt->conn_handle == m_conn_handle_central) on_write_rsp(p_gattc_evt);
+            break;
+
+        case BLE_GATTC_EVT_HVX:
+            if (p_gattc_evt->conn_handle == m_conn_handle_central) on_hvx(p_gattc_evt);
+            break;
+
+        case BLE_GATTC_EVT_TIMEOUT:
+            if (p_gattc_evt->conn_handle == m_conn_handle_central)
+            {
+                NRF_LOG_WARNING("⚠️ BLE Central: GATT timeout");
+                (void)sd_ble_gap_disconnect(m_conn_handle_central, BLE_HCI_REMOTE_USER_TERMINATED_CONNECTION);
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+// Initialize the BLE central data source
+static bool ble_central_init(data_source_config_t *config)
+{
+    if (config == NULL || config->type != DATA_SOURCE_BLE_PROPRIETARY)
+    {
+        NRF_LOG_ERROR("BLE Central: Invalid configuration");
+        return false;
+    }
+
+    m_config = *config;
+    m_is_active = false;
+    m_state = CENTRAL_STATE_IDLE;
+    m_backoff_index = 0;
+
+    uint32_t err_code = deadline_timer_create(&m_retry_timer, DEADLINE_TIMER_MODE_SINGLE_SHOT,
+                                              RETRY_SLACK_MS, retry_timer_handler);
+    APP_ERROR_CHECK(err_code);
+    err_code = deadline_timer_create(&m_data_timeout_timer, DEADLINE_TIMER_MODE_SINGLE_SHOT,
+                                     DATA_TIMEOUT_SLACK_MS, data_timeout_handler);
+    APP_ERROR_CHECK(err_code);
+
+    if (!m_fds_registered)
+    {
+        err_code = fds_register(fds_evt_handler);
+        APP_ERROR_CHECK(err_code);
+        m_fds_registered = true;
+    }
+
+    cache_load();
+
+    NRF_LOG_INFO("BLE Central: Initialized for %02X:%02X:%02X:%02X:%02X:%02X",
+                 m_keiser_mac[0], m_keiser_mac[1], m_keiser_mac[2],
+                 m_keiser_mac[3], m_keiser_mac[4], m_keiser_mac[5]);
+    return true;
+}
+
+// Start scanning for the sensor
+static bool ble_central_start(void)
+{
+    if (!nrf_sdh_is_enabled())
+    {
+        NRF_LOG_ERROR("BLE Central: BLE stack not enabled");
+        return false;
+    }
+
+    uint8_t zero_mac[BLE_GAP_ADDR_LEN] = {0};
+    if (memcmp(m_keiser_mac, zero_mac, BLE_GAP_ADDR_LEN) == 0)
+    {
+        NRF_LOG_ERROR("BLE Central: Sensor address not set");
+        return false;
+    }
+
+    m_backoff_index = 0;
+    scan_start();
+    return m_state == CENTRAL_STATE_SCANNING;
+}
+
+// Stop the BLE central data source
+static void ble_central_stop(void)
+{
+    central_state_t state = m_state;
+    m_state = CENTRAL_STATE_IDLE;
+
+    deadline_timer_stop(m_retry_timer);
+    deadline_timer_stop(m_data_timeout_timer);
+
+    if (state == CENTRAL_STATE_SCANNING)
+    {
+        (void)sd_ble_gap_scan_stop();
+    }
+    else if (state == CENTRAL_STATE_CONNECTING)
+    {
+        (void)sd_ble_gap_connect_cancel();
+    }
+
+    if (m_conn_handle_central != BLE_CONN_HANDLE_INVALID)
+    {
+        (void)sd_ble_gap_disconnect(m_conn_handle_central, BLE_HCI_REMOTE_USER_TERMINATED_CONNECTION);
+        m_conn_handle_central = BLE_CONN_HANDLE_INVALID;
+    }
+
+    m_is_active = false;
+}
+
+static bool ble_central_is_active(void)
+{
+    return m_is_active;
+}
+
+// Get the interface for the BLE central data source
+const data_source_interface_t* ble_central_data_source_get_interface(void)
+{
+    static const data_source_interface_t interface = {
+        .init = ble_central_init,
+        .start = ble_central_start,
+        .stop = ble_central_stop,
+        .is_active = ble_central_is_active
+    };
+
+    return &interface;
+}
@@ -0,0 +1,53 @@
+/**
+ * @file ble_central_data_source.h
+ * @brief BLE Cycling Power / FTMS Client Data Source
+ *
+ * Central-role data source: connects to a Cycling Power (0x1818) or
+ * Fitness Machine (0x1826) sensor, subscribes to its measurement
+ * characteristic and feeds the data model.
+ */
+
+#ifndef BLE_CENTRAL_DATA_SOURCE_H
+#define BLE_CENTRAL_DATA_SOURCE_H
+
+#include "includes/data_source.h"
+#include "common_definitions.h"
+#include "ble.h"
+#include "ble_gap.h"
+
+// Services and characteristics we can subscribe to
+#define BLE_CENTRAL_CPS_UUID              0x1818  // Cycling Power Service
+#define BLE_CENTRAL_CPS_MEAS_UUID         0x2A63  // Cycling Power Measurement
+#define BLE_CENTRAL_FTMS_UUID             0x1826  // Fitness Machine Service
+#define BLE_CENTRAL_FTMS_BIKE_DATA_UUID   0x2AD2  // Indoor Bike Data
+
+// Connection parameters, short interval for minimum latency
+#define BLE_CENTRAL_MIN_CONN_INTERVAL     MSEC_TO_UNITS(7.5, UNIT_1_25_MS)
+#define BLE_CENTRAL_MAX_CONN_INTERVAL     MSEC_TO_UNITS(15, UNIT_1_25_MS)
+#define BLE_CENTRAL_SLAVE_LATENCY         0
+#define BLE_CENTRAL_SUP_TIMEOUT           MSEC_TO_UNITS(4000, UNIT_10_MS)
+
+// Scanning for the sensor
+#define BLE_CENTRAL_SCAN_INTERVAL_MS      100
+#define BLE_CENTRAL_SCAN_WINDOW_MS        50
+#define BLE_CENTRAL_SCAN_TIMEOUT_MS       10000  // One connection attempt
+
+#define BLE_CENTRAL_DATA_TIMEOUT_MS       3000   // Report zero after this long without a measurement
+
+/**
+ * @brief Sensor types the client can subscribe to
+ */
+typedef enum {
+    BLE_CENTRAL_PEER_UNKNOWN = 0,
+    BLE_CENTRAL_PEER_CPS = 1,   // Cycling Power Measurement notifications
+    BLE_CENTRAL_PEER_FTMS = 2,  // Indoor Bike Data notifications
+} ble_central_peer_type_t;
+
+/**
+ * @brief Get the BLE central data source interface
+ *
+ * @return data_source_interface_t* Pointer to the BLE central data source interface
+ */
+const data_source_interface_t* ble_central_data_source_get_interface(void);
+
+#endif /* BLE_CENTRAL_DATA_SOURCE_H */
@@ -2,6 +2,9 @@
 #include "nrf_log.h"
 #include "app_error.h"
 #include <common_definitions.h>
+#include "includes/latency_trace.h"
+#include "includes/diagnostics.h"
+#include "includes/trace_log.h"
 
 
 
@@ -110,7 +113,7 @@ static uint16_t _duplicate_counter = 0;
 
 void ble_cps_send_power_measurement(ble_cps_t * p_cps, uint16_t power_watts) {
     if (p_cps->conn_handle == BLE_CONN_HANDLE_INVALID) {
-        NRF_LOG_WARNING("⚠️ Invalid connection handle. Cannot send CPS notification.");
+        TRACE_LOG0("CPS: Invalid connection handle, not sent");
         return;
     }
 
@@ -129,18 +132,18 @@ void ble_cps_send_power_measurement(ble_cps_t * p_cps, uint16_t power_watts) {
     );
 
     if (err_code != NRF_SUCCESS || (cccd_value & BLE_GATT_HVX_NOTIFICATION) == 0) {
-        NRF_LOG_WARNING("⚠️ Notifications not enabled. Skipping CPS notification.");
+        TRACE_LOG0("CPS: Notifications not enabled, not sent");
         return;
     }
 
     if (power_watts == last_sent_power) {
         _duplicate_counter++;
         if (_duplicate_counter < RESET_DUPLICATE_COUNTER_EVERY_N_MESSAGE) {
-            NRF_LOG_WARNING("⏩ CPS duplicate (%d W), skipping [%d/%d]", 
-                          power_watts, _duplicate_counter, RESET_DUPLICATE_COUNTER_EVERY_N_MESSAGE);
+            DIAG_INC(DIAG_CPS_DEDUP_SKIP);
+            TRACE_LOG2("CPS: Duplicate %u W skipped [%u]", power_watts, _duplicate_counter);
             return;
         } else {
-            NRF_LOG_INFO("🔁 CPS duplicate threshold reached. Forcing update: %d W", power_watts);
+            TRACE_LOG1("CPS: Duplicate threshold reached, forcing %u W", power_watts);
             _duplicate_counter = 0;  // Reset counter after forced send
         }
     } else {
@@ -154,7 +157,6 @@ void ble_cps_send_power_measurement(ble_cps_t * p_cps, uint16_t power_watts) {
     encoded_data[2] = (power_watts & 0xFF);
     encoded_data[3] = (power_watts >> 8);
 
-    NRF_LOG_INFO("🚴 CPS Power Sent: %d W", power_watts);
 
     ble_gatts_hvx_params_t hvx_params = {0};
     hvx_params.handle = p_cps->power_measurement_handles.value_handle;
@@ -166,10 +168,14 @@ void ble_cps_send_power_measurement(ble_cps_t * p_cps, uint16_t power_watts) {
 
     err_code = sd_ble_gatts_hvx(p_cps->conn_handle, &hvx_params);
     if (err_code != NRF_SUCCESS) {
-        NRF_LOG_ERROR("❌ Failed to send CPS notification: 0x%08X", err_code);
+        DIAG_INC(DIAG_HVX_FAIL);
+        TRACE_LOG2("CPS: Notification of %u W failed: 0x%08X", power_watts, err_code);
         return;
     }
 
+    DIAG_INC(DIAG_HVX_OK);
+    TRACE_LOG1("CPS: Power sent %u W", power_watts);
+    latency_trace_hvx();
     last_sent_power = power_watts;
 }
 
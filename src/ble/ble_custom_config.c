@@ -12,10 +12,34 @@
 #include "nrf_sdh_soc.h"       // ✅ System-on-Chip SoftDevice API (sd_softdevice_disable)
 #include "fds.h"
 #include "nrf_fstorage.h"      // ✅ Added for NRF_SUCCESS definition
+#ifdef BONDING_ENABLE
+#include "peer_manager.h"
+#endif
 
 #define CUSTOM_SERVICE_UUID          0x1523
 #define CUSTOM_CHAR_DEVICE_INFO_UUID 0x1524  
 
+// Device ID (2) + Name Length (1) + Name (8) + Data Source Type (1) + MAC (6) + Aggregator Count (1) + Aggregator IDs (2 each)
+// + Backup Source Type (1) + Backup Device ID (2) + Mass kg*10 (2) + CdA m^2*10000 (2) + Crr*100000 (2)
+// + ANT+ TX Enabled (1) + ANT+ TX Device ID (2) + Filter Override (1) + Power Filter (7) + Cadence Filter (7)
+#define DEVICE_INFO_BASE_LEN         (BLE_NAME_MAX_LEN + 3 + 1 + BLE_GAP_ADDR_LEN)
+#define DEVICE_INFO_MAX_LEN          (DEVICE_INFO_BASE_LEN + 1 + (2 * ANT_AGG_MAX_BIKES) + 3 + 6 + 3 + FILTER_CONFIG_LEN)
+
+// Mode (1) + Max Value (2) + Max Rise per s (2) + Min Deviation (2), little-endian
+#define FILTER_FIELD_LEN             7
+#define FILTER_CONFIG_LEN            (1 + (2 * FILTER_FIELD_LEN))
+
+// Byte offset of the aggregator device IDs in the stored record
+#define CONFIG_AGG_IDS_OFFSET        17
+// Byte offset of the backup source in the stored record
+#define CONFIG_BACKUP_OFFSET         (CONFIG_AGG_IDS_OFFSET + (2 * ANT_AGG_MAX_BIKES))
+// Byte offset of the virtual speed parameters in the stored record
+#define CONFIG_PHYSICS_OFFSET        (CONFIG_BACKUP_OFFSET + 3)
+// Byte offset of the ANT+ re-broadcast settings in the stored record
+#define CONFIG_ANT_TX_OFFSET         (CONFIG_PHYSICS_OFFSET + 6)
+// Byte offset of the sample filter settings in the stored record
+#define CONFIG_FILTER_OFFSET         (CONFIG_ANT_TX_OFFSET + 3)
+
 NRF_SDH_BLE_OBSERVER(m_custom_service_observer, APP_BLE_OBSERVER_PRIO, ble_custom_service_on_ble_evt, NULL);
 
 static uint16_t m_service_handle;
@@ -27,6 +51,16 @@ char m_ble_name[BLE_NAME_MAX_LEN + 1] = DEFAULT_BLE_NAME;
 char ble_full_name[MAX_BLE_FULL_NAME_LEN] = {0};
 data_source_type_t m_data_source_type = DATA_SOURCE_ANT_PLUS;  // Default to ANT+
 uint8_t m_keiser_mac[BLE_GAP_ADDR_LEN] = {0};  // Default to all zeros
+uint16_t m_ant_agg_device_ids[ANT_AGG_MAX_BIKES] = {0};  // No aggregated power meters
+data_source_type_t m_backup_source_type = DATA_SOURCE_NONE;  // No backup source
+uint16_t m_backup_device_id = 0;
+uint16_t m_rider_mass_kg_x10 = 0;  // 0 = virtual speed default
+uint16_t m_cda_x10000 = 0;
+uint16_t m_crr_x100000 = 0;
+uint8_t m_ant_tx_enabled = 0;  // No ANT+ re-broadcast
+uint16_t m_ant_tx_device_id = 0;
+uint8_t m_filter_override = 0;  // Per-type filter defaults
+sample_filter_config_t m_filter_config = {0};
 
 #define CONFIG_FILE     (0x8010)
 #define CONFIG_REC_KEY  (0x7010)
@@ -36,10 +70,36 @@ typedef struct {
     char name[BLE_NAME_MAX_LEN + 1];
     uint8_t data_source_type;  // Store as uint8_t since enum size may vary
     uint8_t keiser_mac[BLE_GAP_ADDR_LEN];
+    uint8_t agg_device_ids[2 * ANT_AGG_MAX_BIKES];  // Little-endian, appended after the original fields
+    uint8_t backup_source_type;
+    uint8_t backup_device_id[2];  // Little-endian
+    uint8_t physics[6];  // Mass, CdA, Crr, little-endian
+    uint8_t ant_tx[3];  // Enabled, device ID little-endian
+    uint8_t filter[FILTER_CONFIG_LEN];  // Override, power and cadence filter fields
 } device_config_t;
 
 static bool fds_ready = false;
 static bool fds_write_pending = false;
+static bool fds_gc_pending = false;    // Our delete started the garbage collection
+
+/**@brief Decode one filter field, an unknown mode turns the robust filter off. */
+static void filter_field_decode(const uint8_t *p_data, sample_filter_field_config_t *p_field) {
+    p_field->mode = (p_data[0] <= SAMPLE_FILTER_SPIKE) ? (sample_filter_mode_t)p_data[0] : SAMPLE_FILTER_OFF;
+    p_field->max_value = (uint16_t)(p_data[1] | (p_data[2] << 8));
+    p_field->max_rise_per_s = (uint16_t)(p_data[3] | (p_data[4] << 8));
+    p_field->min_deviation = (uint16_t)(p_data[5] | (p_data[6] << 8));
+}
+
+/**@brief Encode one filter field (Little-Endian). */
+static void filter_field_encode(uint8_t *p_data, const sample_filter_field_config_t *p_field) {
+    p_data[0] = (uint8_t)p_field->mode;
+    p_data[1] = (uint8_t)(p_field->max_value & 0xFF);
+    p_data[2] = (uint8_t)((p_field->max_value >> 8) & 0xFF);
+    p_data[3] = (uint8_t)(p_field->max_rise_per_s & 0xFF);
+    p_data[4] = (uint8_t)((p_field->max_rise_per_s >> 8) & 0xFF);
+    p_data[5] = (uint8_t)(p_field->min_deviation & 0xFF);
+    p_data[6] = (uint8_t)((p_field->min_deviation >> 8) & 0xFF);
+}
 
 void save_device_config(void) {
     if (!fds_ready) {
@@ -63,6 +123,35 @@ void save_device_config(void) {
     // Store Keiser MAC address
     memcpy(&data[11], m_keiser_mac, BLE_GAP_ADDR_LEN);
 
+    // Store ANT+ aggregator device IDs (Little-Endian)
+    for (int i = 0; i < ANT_AGG_MAX_BIKES; i++) {
+        data[CONFIG_AGG_IDS_OFFSET + (2 * i)] = (uint8_t)(m_ant_agg_device_ids[i] & 0xFF);
+        data[CONFIG_AGG_IDS_OFFSET + (2 * i) + 1] = (uint8_t)((m_ant_agg_device_ids[i] >> 8) & 0xFF);
+    }
+
+    // Store backup data source (Little-Endian)
+    data[CONFIG_BACKUP_OFFSET] = (uint8_t)m_backup_source_type;
+    data[CONFIG_BACKUP_OFFSET + 1] = (uint8_t)(m_backup_device_id & 0xFF);
+    data[CONFIG_BACKUP_OFFSET + 2] = (uint8_t)((m_backup_device_id >> 8) & 0xFF);
+
+    // Store virtual speed parameters (Little-Endian)
+    data[CONFIG_PHYSICS_OFFSET] = (uint8_t)(m_rider_mass_kg_x10 & 0xFF);
+    data[CONFIG_PHYSICS_OFFSET + 1] = (uint8_t)((m_rider_mass_kg_x10 >> 8) & 0xFF);
+    data[CONFIG_PHYSICS_OFFSET + 2] = (uint8_t)(m_cda_x10000 & 0xFF);
+    data[CONFIG_PHYSICS_OFFSET + 3] = (uint8_t)((m_cda_x10000 >> 8) & 0xFF);
+    data[CONFIG_PHYSICS_OFFSET + 4] = (uint8_t)(m_crr_x100000 & 0xFF);
+    data[CONFIG_PHYSICS_OFFSET + 5] = (uint8_t)((m_crr_x100000 >> 8) & 0xFF);
+
+    // Store ANT+ re-broadcast settings (Little-Endian)
+    data[CONFIG_ANT_TX_OFFSET] = m_ant_tx_enabled;
+    data[CONFIG_ANT_TX_OFFSET + 1] = (uint8_t)(m_ant_tx_device_id & 0xFF);
+    data[CONFIG_ANT_TX_OFFSET + 2] = (uint8_t)((m_ant_tx_device_id >> 8) & 0xFF);
+
+    // Store sample filter settings
+    data[CONFIG_FILTER_OFFSET] = m_filter_override;
+    filter_field_encode(&data[CONFIG_FILTER_OFFSET + 1], &m_filter_config.power);
+    filter_field_encode(&data[CONFIG_FILTER_OFFSET + 1 + FILTER_FIELD_LEN], &m_filter_config.cadence);
+
     // Print byte-by-byte for debugging
     NRF_LOG_INFO("🔍 Data to be stored:");
     for (int i = 0; i < sizeof(data); i++) {
@@ -109,6 +198,15 @@ void load_device_config(void) {
         m_ble_name[BLE_NAME_MAX_LEN] = '\0';
         m_data_source_type = DATA_SOURCE_ANT_PLUS;
         memset(m_keiser_mac, 0, BLE_GAP_ADDR_LEN);
+        memset(m_ant_agg_device_ids, 0, sizeof(m_ant_agg_device_ids));
+        m_backup_source_type = DATA_SOURCE_NONE;
+        m_backup_device_id = 0;
+        m_rider_mass_kg_x10 = 0;
+        m_cda_x10000 = 0;
+        m_crr_x100000 = 0;
+        m_ant_tx_enabled = 0;
+        m_ant_tx_device_id = 0;
+        m_filter_override = 0;
         update_ble_name();
         return;
     }
@@ -144,6 +242,60 @@ void load_device_config(void) {
                         m_keiser_mac[0], m_keiser_mac[1], m_keiser_mac[2],
                         m_keiser_mac[3], m_keiser_mac[4], m_keiser_mac[5]);
 
+            // Parse ANT+ aggregator device IDs, records written by older firmware end before them
+            memset(m_ant_agg_device_ids, 0, sizeof(m_ant_agg_device_ids));
+            if ((record.p_header->length_words * 4) >= CONFIG_AGG_IDS_OFFSET + (2 * ANT_AGG_MAX_BIKES)) {
+                for (int i = 0; i < ANT_AGG_MAX_BIKES; i++) {
+                    m_ant_agg_device_ids[i] = (uint16_t)(data[CONFIG_AGG_IDS_OFFSET + (2 * i)] |
+                                                         (data[CONFIG_AGG_IDS_OFFSET + (2 * i) + 1] << 8));
+                    if (m_ant_agg_device_ids[i] != 0) {
+                        NRF_LOG_INFO("✅ Parsed Aggregator Device %d: %d", i, m_ant_agg_device_ids[i]);
+                    }
+                }
+            }
+
+            // Parse backup data source, also missing from older records
+            m_backup_source_type = DATA_SOURCE_NONE;
+            m_backup_device_id = 0;
+            if ((record.p_header->length_words * 4) >= CONFIG_BACKUP_OFFSET + 3) {
+                m_backup_source_type = (data_source_type_t)data[CONFIG_BACKUP_OFFSET];
+                m_backup_device_id = (uint16_t)(data[CONFIG_BACKUP_OFFSET + 1] |
+                                                (data[CONFIG_BACKUP_OFFSET + 2] << 8));
+                NRF_LOG_INFO("✅ Parsed Backup Source Type: %d, Device ID: %d",
+                             m_backup_source_type, m_backup_device_id);
+            }
+
+            // Parse virtual speed parameters, zero selects the defaults
+            m_rider_mass_kg_x10 = 0;
+            m_cda_x10000 = 0;
+            m_crr_x100000 = 0;
+            if ((record.p_header->length_words * 4) >= CONFIG_PHYSICS_OFFSET + 6) {
+                m_rider_mass_kg_x10 = (uint16_t)(data[CONFIG_PHYSICS_OFFSET] | (data[CONFIG_PHYSICS_OFFSET + 1] << 8));
+                m_cda_x10000 = (uint16_t)(data[CONFIG_PHYSICS_OFFSET + 2] | (data[CONFIG_PHYSICS_OFFSET + 3] << 8));
+                m_crr_x100000 = (uint16_t)(data[CONFIG_PHYSICS_OFFSET + 4] | (data[CONFIG_PHYSICS_OFFSET + 5] << 8));
+                NRF_LOG_INFO("✅ Parsed Mass: %d, CdA: %d, Crr: %d",
+                             m_rider_mass_kg_x10, m_cda_x10000, m_crr_x100000);
+            }
+
+            // Parse ANT+ re-broadcast settings, off in older records
+            m_ant_tx_enabled = 0;
+            m_ant_tx_device_id = 0;
+            if ((record.p_header->length_words * 4) >= CONFIG_ANT_TX_OFFSET + 3) {
+                m_ant_tx_enabled = data[CONFIG_ANT_TX_OFFSET];
+                m_ant_tx_device_id = (uint16_t)(data[CONFIG_ANT_TX_OFFSET + 1] | (data[CONFIG_ANT_TX_OFFSET + 2] << 8));
+                NRF_LOG_INFO("✅ Parsed ANT+ TX: %d, Device ID: %d", m_ant_tx_enabled, m_ant_tx_device_id);
+            }
+
+            // Parse sample filter settings, per-type defaults in older records
+            m_filter_override = 0;
+            if ((record.p_header->length_words * 4) >= CONFIG_FILTER_OFFSET + FILTER_CONFIG_LEN) {
+                m_filter_override = data[CONFIG_FILTER_OFFSET];
+                filter_field_decode(&data[CONFIG_FILTER_OFFSET + 1], &m_filter_config.power);
+                filter_field_decode(&data[CONFIG_FILTER_OFFSET + 1 + FILTER_FIELD_LEN], &m_filter_config.cadence);
+                NRF_LOG_INFO("✅ Parsed Filter Override: %d, Power Mode: %d, Cadence Mode: %d",
+                             m_filter_override, m_filter_config.power.mode, m_filter_config.cadence.mode);
+            }
+
             fds_record_close(&desc);
         } else {
             NRF_LOG_ERROR("🚨 Failed to open record!");
@@ -155,6 +307,15 @@ void load_device_config(void) {
         m_ble_name[BLE_NAME_MAX_LEN] = '\0';
         m_data_source_type = DATA_SOURCE_ANT_PLUS;
         memset(m_keiser_mac, 0, BLE_GAP_ADDR_LEN);
+        memset(m_ant_agg_device_ids, 0, sizeof(m_ant_agg_device_ids));
+        m_backup_source_type = DATA_SOURCE_NONE;
+        m_backup_device_id = 0;
+        m_rider_mass_kg_x10 = 0;
+        m_cda_x10000 = 0;
+        m_crr_x100000 = 0;
+        m_ant_tx_enabled = 0;
+        m_ant_tx_device_id = 0;
+        m_filter_override = 0;
     }
 
     update_ble_name();
@@ -173,8 +334,21 @@ void load_device_config(void) {
 }
 
 static void fds_evt_handler(fds_evt_t const * p_evt) {
+    // Other modules keep their own records in FDS, only our config record triggers a reboot
+    if ((p_evt->id == FDS_EVT_WRITE || p_evt->id == FDS_EVT_UPDATE) &&
+        p_evt->write.record_key != CONFIG_REC_KEY) {
+        return;
+    }
+    if (p_evt->id == FDS_EVT_DEL_RECORD && p_evt->del.record_key != CONFIG_REC_KEY) {
+        return;
+    }
+
     switch (p_evt->id) {
         case FDS_EVT_INIT:
+            // The Peer Manager initializes FDS again, every user sees INIT once more
+            if (fds_ready) {
+                break;
+            }
             if (p_evt->result == NRF_SUCCESS) {
                 fds_ready = true;
                 NRF_LOG_INFO("✅ FDS initialized and ready");
@@ -209,6 +383,7 @@ static void fds_evt_handler(fds_evt_t const * p_evt) {
         case FDS_EVT_DEL_RECORD:
             if (p_evt->result == NRF_SUCCESS) {
                 NRF_LOG_INFO("🗑️ Record deleted successfully, starting garbage collection...");
+                fds_gc_pending = true;
                 fds_gc();  // **Run GC after deletion**
             } else {
                 NRF_LOG_ERROR("🚨 FDS delete failed! Error: %d", p_evt->result);
@@ -216,6 +391,11 @@ static void fds_evt_handler(fds_evt_t const * p_evt) {
             break;
 
         case FDS_EVT_GC:
+            // The Peer Manager collects garbage when its pages fill up
+            if (!fds_gc_pending) {
+                break;
+            }
+            fds_gc_pending = false;
             if (p_evt->result == NRF_SUCCESS) {
                 NRF_LOG_INFO("✅ Garbage collection completed, now writing new record...");
                 save_device_config();  // **Trigger save after GC completes**
@@ -237,8 +417,7 @@ void update_ble_name() {
     NRF_LOG_INFO("Updated BLE Full Name: %s", ble_full_name);
 }
 
-/**@brief   Wait for fds to initialize. */
-static void wait_for_fds_ready(void)
+void custom_service_wait_ready(void)
 {
     while (!fds_ready)
     {
@@ -252,8 +431,6 @@ void custom_service_init(void) {
     
     ret = fds_init();
     APP_ERROR_CHECK(ret);
-
-    wait_for_fds_ready();
 }
 
 /**@brief Function for handling BLE writes. */
@@ -262,8 +439,9 @@ static void on_write(ble_evt_t const *p_ble_evt) {
 
     if (p_evt_write->handle == m_device_info_handles.value_handle) {
         uint16_t write_len = p_evt_write->len;
+        data_source_type_t old_source_type = m_data_source_type;
 
-        if (write_len < 3 || write_len > BLE_NAME_MAX_LEN + 3 + 1 + BLE_GAP_ADDR_LEN) {
+        if (write_len < 3 || write_len > DEVICE_INFO_MAX_LEN) {
             NRF_LOG_WARNING("Invalid Data Length: %d bytes", write_len);
             return;
         }
@@ -289,13 +467,82 @@ static void on_write(ble_evt_t const *p_ble_evt) {
             memcpy(m_keiser_mac, &p_evt_write->data[3 + name_length + 1], BLE_GAP_ADDR_LEN);
         }
 
+        // Extract ANT+ aggregator device IDs: count followed by little-endian IDs
+        uint16_t agg_offset = 3 + name_length + 1 + BLE_GAP_ADDR_LEN;
+        if (write_len >= agg_offset + 1) {
+            uint8_t agg_count = p_evt_write->data[agg_offset];
+            if (agg_count > ANT_AGG_MAX_BIKES) agg_count = ANT_AGG_MAX_BIKES;
+
+            memset(m_ant_agg_device_ids, 0, sizeof(m_ant_agg_device_ids));
+            for (uint8_t i = 0; i < agg_count && write_len >= agg_offset + 1 + (2 * (i + 1)); i++) {
+                m_ant_agg_device_ids[i] = (uint16_t)(p_evt_write->data[agg_offset + 1 + (2 * i)] |
+                                                     (p_evt_write->data[agg_offset + 2 + (2 * i)] << 8));
+            }
+
+            // Extract backup data source: type followed by little-endian device ID
+            uint16_t backup_offset = agg_offset + 1 + (2 * agg_count);
+            m_backup_source_type = DATA_SOURCE_NONE;
+            m_backup_device_id = 0;
+            if (write_len >= backup_offset + 3) {
+                m_backup_source_type = (data_source_type_t)p_evt_write->data[backup_offset];
+                m_backup_device_id = (uint16_t)(p_evt_write->data[backup_offset + 1] |
+                                                (p_evt_write->data[backup_offset + 2] << 8));
+            }
+
+            // Extract virtual speed parameters: mass, CdA and Crr, little-endian
+            uint16_t physics_offset = backup_offset + 3;
+            m_rider_mass_kg_x10 = 0;
+            m_cda_x10000 = 0;
+            m_crr_x100000 = 0;
+            if (write_len >= physics_offset + 6) {
+                m_rider_mass_kg_x10 = (uint16_t)(p_evt_write->data[physics_offset] |
+                                                 (p_evt_write->data[physics_offset + 1] << 8));
+                m_cda_x10000 = (uint16_t)(p_evt_write->data[physics_offset + 2] |
+                                          (p_evt_write->data[physics_offset + 3] << 8));
+                m_crr_x100000 = (uint16_t)(p_evt_write->data[physics_offset + 4] |
+                                           (p_evt_write->data[physics_offset + 5] << 8));
+            }
+
+            // Extract ANT+ re-broadcast settings: enabled followed by little-endian device ID
+            uint16_t ant_tx_offset = physics_offset + 6;
+            m_ant_tx_enabled = 0;
+            m_ant_tx_device_id = 0;
+            if (write_len >= ant_tx_offset + 3) {
+                m_ant_tx_enabled = p_evt_write->data[ant_tx_offset];
+                m_ant_tx_device_id = (uint16_t)(p_evt_write->data[ant_tx_offset + 1] |
+                                                (p_evt_write->data[ant_tx_offset + 2] << 8));
+            }
+
+            // Extract sample filter settings: override followed by the power and cadence fields
+            uint16_t filter_offset = ant_tx_offset + 3;
+            m_filter_override = 0;
+            if (write_len >= filter_offset + FILTER_CONFIG_LEN) {
+                m_filter_override = p_evt_write->data[filter_offset];
+                filter_field_decode(&p_evt_write->data[filter_offset + 1], &m_filter_config.power);
+                filter_field_decode(&p_evt_write->data[filter_offset + 1 + FILTER_FIELD_LEN], &m_filter_config.cadence);
+            }
+        }
+
         NRF_LOG_INFO("New Device ID: %d", m_ant_device_id);
         NRF_LOG_INFO("New BLE Name: %s", m_ble_name);
         NRF_LOG_INFO("New Data Source Type: %d", m_data_source_type);
+        NRF_LOG_INFO("New Backup Source Type: %d, Device ID: %d", m_backup_source_type, m_backup_device_id);
+        NRF_LOG_INFO("New Mass: %d, CdA: %d, Crr: %d", m_rider_mass_kg_x10, m_cda_x10000, m_crr_x100000);
+        NRF_LOG_INFO("New ANT+ TX: %d, Device ID: %d", m_ant_tx_enabled, m_ant_tx_device_id);
+        NRF_LOG_INFO("New Filter Override: %d", m_filter_override);
         NRF_LOG_INFO("New Keiser MAC: %02X:%02X:%02X:%02X:%02X:%02X",
                     m_keiser_mac[0], m_keiser_mac[1], m_keiser_mac[2],
                     m_keiser_mac[3], m_keiser_mac[4], m_keiser_mac[5]);
 
+#ifdef BONDING_ENABLE
+        // The mode specific services change the attribute table after the reboot, bonded
+        // centrals get a Service Changed indication instead of using their cached handles.
+        // Queued in FDS ahead of the config record, so it is stored before the reboot.
+        if (m_data_source_type != old_source_type) {
+            pm_local_database_has_changed();
+        }
+#endif // BONDING_ENABLE
+
         // Save to FDS - will reboot after successful write
         save_device_config();
     }
@@ -317,8 +564,8 @@ void ble_custom_service_init(void) {
 
     add_char_params.uuid = CUSTOM_CHAR_DEVICE_INFO_UUID;
     add_char_params.uuid_type = BLE_UUID_TYPE_BLE;
-    add_char_params.init_len = BLE_NAME_MAX_LEN + 3 + 1 + BLE_GAP_ADDR_LEN;  // Device ID (2) + Name Length (1) + Name (8) + Data Source Type (1) + MAC (6)
-    add_char_params.max_len = BLE_NAME_MAX_LEN + 3 + 1 + BLE_GAP_ADDR_LEN;
+    add_char_params.init_len = DEVICE_INFO_MAX_LEN;
+    add_char_params.max_len = DEVICE_INFO_MAX_LEN;
     add_char_params.char_props.read = 1;
     add_char_params.char_props.write = 1;
     add_char_params.read_access = SEC_OPEN;
@@ -326,7 +573,7 @@ void ble_custom_service_init(void) {
     characteristic_add(m_service_handle, &add_char_params, &m_device_info_handles);
 
     // ✅ Set initial value after adding the characteristic
-    uint8_t initial_value[BLE_NAME_MAX_LEN + 3 + 1 + BLE_GAP_ADDR_LEN] = {0};
+    uint8_t initial_value[DEVICE_INFO_MAX_LEN] = {0};
 
     // Device ID
     initial_value[0] = (uint8_t)(m_ant_device_id & 0xFF);
@@ -342,6 +589,41 @@ void ble_custom_service_init(void) {
     // Keiser MAC Address
     memcpy(&initial_value[3 + initial_value[2] + 1], m_keiser_mac, BLE_GAP_ADDR_LEN);
 
+    // ANT+ aggregator device IDs
+    uint8_t agg_offset = 3 + initial_value[2] + 1 + BLE_GAP_ADDR_LEN;
+    initial_value[agg_offset] = ANT_AGG_MAX_BIKES;
+    for (int i = 0; i < ANT_AGG_MAX_BIKES; i++) {
+        initial_value[agg_offset + 1 + (2 * i)] = (uint8_t)(m_ant_agg_device_ids[i] & 0xFF);
+        initial_value[agg_offset + 2 + (2 * i)] = (uint8_t)((m_ant_agg_device_ids[i] >> 8) & 0xFF);
+    }
+
+    // Backup data source
+    uint8_t backup_offset = agg_offset + 1 + (2 * ANT_AGG_MAX_BIKES);
+    initial_value[backup_offset] = (uint8_t)m_backup_source_type;
+    initial_value[backup_offset + 1] = (uint8_t)(m_backup_device_id & 0xFF);
+    initial_value[backup_offset + 2] = (uint8_t)((m_backup_device_id >> 8) & 0xFF);
+
+    // Virtual speed parameters
+    uint8_t physics_offset = backup_offset + 3;
+    initial_value[physics_offset] = (uint8_t)(m_rider_mass_kg_x10 & 0xFF);
+    initial_value[physics_offset + 1] = (uint8_t)((m_rider_mass_kg_x10 >> 8) & 0xFF);
+    initial_value[physics_offset + 2] = (uint8_t)(m_cda_x10000 & 0xFF);
+    initial_value[physics_offset + 3] = (uint8_t)((m_cda_x10000 >> 8) & 0xFF);
+    initial_value[physics_offset + 4] = (uint8_t)(m_crr_x100000 & 0xFF);
+    initial_value[physics_offset + 5] = (uint8_t)((m_crr_x100000 >> 8) & 0xFF);
+
+    // ANT+ re-broadcast settings
+    uint8_t ant_tx_offset = physics_offset + 6;
+    initial_value[ant_tx_offset] = m_ant_tx_enabled;
+    initial_value[ant_tx_offset + 1] = (uint8_t)(m_ant_tx_device_id & 0xFF);
+    initial_value[ant_tx_offset + 2] = (uint8_t)((m_ant_tx_device_id >> 8) & 0xFF);
+
+    // Sample filter settings
+    uint8_t filter_offset = ant_tx_offset + 3;
+    initial_value[filter_offset] = m_filter_override;
+    filter_field_encode(&initial_value[filter_offset + 1], &m_filter_config.power);
+    filter_field_encode(&initial_value[filter_offset + 1 + FILTER_FIELD_LEN], &m_filter_config.cadence);
+
     ble_gatts_value_t value = {
         .len = sizeof(initial_value),
         .offset = 0,
@@ -5,6 +5,8 @@
 #include "ble.h"
 #include "ble_srv_common.h"
 #include "data_source.h"
+#include "common_definitions.h"
+#include "includes/sample_filter.h"
 #define MAX_BLE_FULL_NAME_LEN 15  // Includes custom name + "_12345"
 #define DEFAULT_BLE_NAME       "BikeBLE"
 #define BLE_NAME_MAX_LEN       8
@@ -15,10 +17,27 @@ extern char m_ble_name[BLE_NAME_MAX_LEN + 1];
 extern uint16_t m_ant_device_id;  // ✅ This is now accessible in `main.c`
 extern data_source_type_t m_data_source_type;  // Current data source type
 extern uint8_t m_keiser_mac[BLE_GAP_ADDR_LEN];  // Keiser M3i MAC address
-
-/**@brief Function for initializing FDS and registering event handler. */
+extern uint16_t m_ant_agg_device_ids[ANT_AGG_MAX_BIKES];  // ANT+ aggregator power meters, 0 = unused slot
+extern data_source_type_t m_backup_source_type;  // Fused with the main source, DATA_SOURCE_NONE = no backup
+extern uint16_t m_backup_device_id;  // Device ID of the backup source
+extern uint16_t m_rider_mass_kg_x10;  // Rider and bike mass for virtual speed, 0 = default
+extern uint16_t m_cda_x10000;  // Drag area in m^2 * 10000, 0 = default
+extern uint16_t m_crr_x100000;  // Rolling resistance * 100000, 0 = default
+extern uint8_t m_ant_tx_enabled;  // Re-broadcast the Keiser bike as an ANT+ power meter, 0 = off
+extern uint16_t m_ant_tx_device_id;  // ANT+ device number to transmit as, 0 = derived from the chip ID
+extern uint8_t m_filter_override;  // 1 = m_filter_config replaces the per-type filter defaults of the main source
+extern sample_filter_config_t m_filter_config;  // Power and cadence filter settings, used with m_filter_override
+
+/**@brief Function for initializing FDS and registering event handler.
+ *
+ * @details Returns as soon as the FDS init is queued, the configuration is loaded
+ *          from the FDS event. Call custom_service_wait_ready() before using it.
+ */
 void custom_service_init(void);
 
+/**@brief Wait until FDS is ready and the configuration has been loaded. */
+void custom_service_wait_ready(void);
+
 /**@brief Function for initializing the custom BLE service. */
 void ble_custom_service_init(void);
 
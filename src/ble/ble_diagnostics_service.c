@@ -0,0 +1,197 @@
+#include "ble_diagnostics_service.h"
+#include "ble_srv_common.h"
+#include "nrf_log.h"
+#include "app_error.h"
+#include "app_util.h"
+#include "nrf_sdh_ble.h"
+#include "common_definitions.h"
+#include "includes/latency_trace.h"
+#include "includes/diagnostics.h"
+#include "includes/trace_log.h"
+#include "includes/crash_log.h"
+
+#if TRACE_LOG_ENABLED
+// The ring is served as one attribute value
+STATIC_ASSERT(TRACE_LOG_ENCODED_LEN <= BLE_GATTS_FIX_ATTR_LEN_MAX);
+#endif
+
+ble_diagnostics_t m_diagnostics_service;
+
+// Characteristic values, stored in application RAM to spare the attribute table
+static uint8_t m_latency[LATENCY_TRACE_ENCODED_LEN];
+static uint8_t m_counters[DIAGNOSTICS_ENCODED_LEN];
+static uint8_t m_last_reset[CRASH_LOG_ENCODED_LEN];
+
+static uint16_t m_log_countdown = DIAGNOSTICS_LOG_INTERVAL_S;
+
+static void ble_diagnostics_service_on_ble_evt(ble_evt_t const *p_ble_evt, void *p_context);
+static void notify_last_reset(void);
+NRF_SDH_BLE_OBSERVER(m_diagnostics_service_observer, APP_BLE_OBSERVER_PRIO, ble_diagnostics_service_on_ble_evt, NULL);
+
+/**@brief Function for handling BLE events in the Diagnostics Service */
+static void ble_diagnostics_service_on_ble_evt(ble_evt_t const *p_ble_evt, void *p_context) {
+    switch (p_ble_evt->header.evt_id) {
+        case BLE_GAP_EVT_CONNECTED:
+            if (p_ble_evt->evt.gap_evt.params.connected.role != BLE_GAP_ROLE_PERIPH) break;
+            m_diagnostics_service.conn_handle = p_ble_evt->evt.gap_evt.conn_handle;
+            break;
+
+        case BLE_GAP_EVT_DISCONNECTED:
+            if (p_ble_evt->evt.gap_evt.conn_handle != m_diagnostics_service.conn_handle) break;
+            m_diagnostics_service.conn_handle = BLE_CONN_HANDLE_INVALID;
+            break;
+
+        case BLE_GATTS_EVT_WRITE:
+            // The crash record goes out once, as soon as the client subscribes
+            if (p_ble_evt->evt.gatts_evt.params.write.handle == m_diagnostics_service.reset_handles.cccd_handle &&
+                crash_log_has_record()) {
+                notify_last_reset();
+            }
+            break;
+
+        case BLE_GAP_EVT_CONN_PARAM_UPDATE:
+            if (p_ble_evt->evt.gap_evt.conn_handle != m_diagnostics_service.conn_handle) break;
+            DIAG_INC(DIAG_CONN_PARAM_UPDATE);
+            break;
+
+        default:
+            break;
+    }
+}
+
+/**@brief Notify the start of the counter record, the rest is a long read */
+static void notify_counters(void) {
+    if (m_diagnostics_service.conn_handle == BLE_CONN_HANDLE_INVALID) return;
+
+    uint16_t cccd_value = 0;
+    ble_gatts_value_t cccd_val = {.len = sizeof(cccd_value), .offset = 0, .p_value = (uint8_t *)&cccd_value};
+    uint32_t err_code = sd_ble_gatts_value_get(m_diagnostics_service.conn_handle,
+                                               m_diagnostics_service.counters_handles.cccd_handle,
+                                               &cccd_val);
+    if (err_code != NRF_SUCCESS || (cccd_value & BLE_GATT_HVX_NOTIFICATION) == 0) return;
+
+    uint16_t len = BLE_GATT_ATT_MTU_DEFAULT - 3;
+
+    ble_gatts_hvx_params_t hvx_params = {0};
+    hvx_params.handle = m_diagnostics_service.counters_handles.value_handle;
+    hvx_params.type   = BLE_GATT_HVX_NOTIFICATION;
+    hvx_params.p_data = m_counters;
+    hvx_params.p_len  = &len;
+
+    err_code = sd_ble_gatts_hvx(m_diagnostics_service.conn_handle, &hvx_params);
+    if (err_code != NRF_SUCCESS && err_code != NRF_ERROR_RESOURCES) {
+        NRF_LOG_WARNING("⚠️ Diagnostics: Notification failed: 0x%08X", err_code);
+    }
+}
+
+/**@brief Notify the head of the last reset record: cause, reset reason, PC, LR and error code */
+static void notify_last_reset(void) {
+    if (m_diagnostics_service.conn_handle == BLE_CONN_HANDLE_INVALID) return;
+
+    uint16_t cccd_value = 0;
+    ble_gatts_value_t cccd_val = {.len = sizeof(cccd_value), .offset = 0, .p_value = (uint8_t *)&cccd_value};
+    uint32_t err_code = sd_ble_gatts_value_get(m_diagnostics_service.conn_handle,
+                                               m_diagnostics_service.reset_handles.cccd_handle,
+                                               &cccd_val);
+    if (err_code != NRF_SUCCESS || (cccd_value & BLE_GATT_HVX_NOTIFICATION) == 0) return;
+
+    uint16_t len = BLE_GATT_ATT_MTU_DEFAULT - 3;
+
+    ble_gatts_hvx_params_t hvx_params = {0};
+    hvx_params.handle = m_diagnostics_service.reset_handles.value_handle;
+    hvx_params.type   = BLE_GATT_HVX_NOTIFICATION;
+    hvx_params.p_data = m_last_reset;
+    hvx_params.p_len  = &len;
+
+    err_code = sd_ble_gatts_hvx(m_diagnostics_service.conn_handle, &hvx_params);
+    if (err_code != NRF_SUCCESS && err_code != NRF_ERROR_RESOURCES) {
+        NRF_LOG_WARNING("⚠️ Diagnostics: Reset record notification failed: 0x%08X", err_code);
+    }
+}
+
+void ble_diagnostics_service_update(void) {
+    // The values live in application RAM, encode in place and only update the length (p_value NULL)
+    ble_gatts_value_t counters = {.len = diagnostics_encode(m_counters), .offset = 0, .p_value = NULL};
+    sd_ble_gatts_value_set(BLE_CONN_HANDLE_INVALID, m_diagnostics_service.counters_handles.value_handle, &counters);
+
+    ble_gatts_value_t latency = {.len = latency_trace_encode(m_latency), .offset = 0, .p_value = NULL};
+    sd_ble_gatts_value_set(BLE_CONN_HANDLE_INVALID, m_diagnostics_service.latency_handles.value_handle, &latency);
+
+    if (--m_log_countdown == 0) {
+        m_log_countdown = DIAGNOSTICS_LOG_INTERVAL_S;
+        latency_trace_log();
+    }
+
+    notify_counters();
+}
+
+/**@brief Function to initialize the Diagnostics Service */
+void ble_diagnostics_service_init(void) {
+    ble_uuid_t ble_uuid;
+    ble_uuid.type = BLE_UUID_TYPE_BLE;
+    ble_uuid.uuid = DIAGNOSTICS_SERVICE_UUID;
+    m_diagnostics_service.conn_handle = BLE_CONN_HANDLE_INVALID;
+
+    uint32_t err_code = sd_ble_gatts_service_add(BLE_GATTS_SRVC_TYPE_PRIMARY, &ble_uuid, &m_diagnostics_service.service_handle);
+    APP_ERROR_CHECK(err_code);
+
+    // ✅ Latency Characteristic (Read)
+    ble_add_char_params_t latency_params = {0};
+    latency_params.uuid = DIAGNOSTICS_LATENCY_CHAR_UUID;
+    latency_params.uuid_type = BLE_UUID_TYPE_BLE;
+    latency_params.init_len = LATENCY_TRACE_ENCODED_LEN;
+    latency_params.max_len = LATENCY_TRACE_ENCODED_LEN;
+    latency_params.is_value_user = true;
+    latency_params.p_init_value = m_latency;
+    latency_params.char_props.read = 1;
+    latency_params.read_access = SEC_OPEN;
+    err_code = characteristic_add(m_diagnostics_service.service_handle, &latency_params, &m_diagnostics_service.latency_handles);
+    APP_ERROR_CHECK(err_code);
+
+    // ✅ Counters Characteristic (Read + Notify)
+    ble_add_char_params_t counters_params = {0};
+    counters_params.uuid = DIAGNOSTICS_COUNTERS_CHAR_UUID;
+    counters_params.uuid_type = BLE_UUID_TYPE_BLE;
+    counters_params.init_len = DIAGNOSTICS_ENCODED_LEN;
+    counters_params.max_len = DIAGNOSTICS_ENCODED_LEN;
+    counters_params.is_value_user = true;
+    counters_params.p_init_value = m_counters;
+    counters_params.char_props.read = 1;
+    counters_params.char_props.notify = 1;
+    counters_params.read_access = SEC_OPEN;
+    counters_params.cccd_write_access = SEC_OPEN;
+    err_code = characteristic_add(m_diagnostics_service.service_handle, &counters_params, &m_diagnostics_service.counters_handles);
+    APP_ERROR_CHECK(err_code);
+
+    // ✅ Last Reset Characteristic (Read + Notify), fixed for the whole run
+    ble_add_char_params_t reset_params = {0};
+    reset_params.uuid = DIAGNOSTICS_RESET_CHAR_UUID;
+    reset_params.uuid_type = BLE_UUID_TYPE_BLE;
+    reset_params.init_len = crash_log_encode(m_last_reset);
+    reset_params.max_len = CRASH_LOG_ENCODED_LEN;
+    reset_params.is_value_user = true;
+    reset_params.p_init_value = m_last_reset;
+    reset_params.char_props.read = 1;
+    reset_params.char_props.notify = 1;
+    reset_params.read_access = SEC_OPEN;
+    reset_params.cccd_write_access = SEC_OPEN;
+    err_code = characteristic_add(m_diagnostics_service.service_handle, &reset_params, &m_diagnostics_service.reset_handles);
+    APP_ERROR_CHECK(err_code);
+
+#if TRACE_LOG_ENABLED
+    // ✅ Trace Characteristic (Read), served straight from the ring without a copy
+    ble_add_char_params_t trace_params = {0};
+    trace_params.uuid = DIAGNOSTICS_TRACE_CHAR_UUID;
+    trace_params.uuid_type = BLE_UUID_TYPE_BLE;
+    trace_params.init_len = TRACE_LOG_ENCODED_LEN;
+    trace_params.max_len = TRACE_LOG_ENCODED_LEN;
+    trace_params.is_value_user = true;
+    trace_params.p_init_value = (uint8_t *)trace_log_get();
+    trace_params.char_props.read = 1;
+    trace_params.read_access = SEC_OPEN;
+    err_code = characteristic_add(m_diagnostics_service.service_handle, &trace_params, &m_diagnostics_service.trace_handles);
+    APP_ERROR_CHECK(err_code);
+#endif
+
+    NRF_LOG_INFO("✅ Diagnostics Service Initialized");
+}
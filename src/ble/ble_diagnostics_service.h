@@ -0,0 +1,34 @@
+#ifndef BLE_DIAGNOSTICS_SERVICE_H__
+#define BLE_DIAGNOSTICS_SERVICE_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ble.h"
+#include "ble_srv_common.h"
+
+#define DIAGNOSTICS_SERVICE_UUID       0x1640
+#define DIAGNOSTICS_LATENCY_CHAR_UUID  0x1641  // Latency per hop, see latency_trace_encode()
+#define DIAGNOSTICS_COUNTERS_CHAR_UUID 0x1642  // Counters, see diagnostics_encode() (read + notify)
+#define DIAGNOSTICS_TRACE_CHAR_UUID    0x1643  // Binary trace ring, decode with tools/trace_decode.py (long read)
+#define DIAGNOSTICS_RESET_CHAR_UUID    0x1644  // Last reset record, see crash_log_encode() (read + notify)
+
+#define DIAGNOSTICS_LOG_INTERVAL_S     60      // Same numbers go to RTT this often
+
+typedef struct {
+    uint16_t service_handle;
+    ble_gatts_char_handles_t latency_handles;
+    ble_gatts_char_handles_t counters_handles;
+    ble_gatts_char_handles_t trace_handles;
+    ble_gatts_char_handles_t reset_handles;
+    uint16_t conn_handle;
+} ble_diagnostics_t;
+
+extern ble_diagnostics_t m_diagnostics_service;
+
+/**@brief Function to initialize the Diagnostics Service */
+void ble_diagnostics_service_init(void);
+
+/**@brief Refresh the characteristic values and notify the counters. Call once per second. */
+void ble_diagnostics_service_update(void);
+
+#endif // BLE_DIAGNOSTICS_SERVICE_H__
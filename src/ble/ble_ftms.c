@@ -3,8 +3,14 @@
 #include "nrf_log.h"
 #include <common_definitions.h>
 #include "app_timer.h"  // Required for app_timer
+#include "includes/virtual_speed.h"
+#include "includes/latency_trace.h"
+#include "includes/profiler.h"
+#include "includes/diagnostics.h"
+#include "includes/trace_log.h"
+#include "includes/deadline_timer.h"
 
-APP_TIMER_DEF(ftms_training_timer);  // Timer instance
+static deadline_timer_id_t ftms_training_timer;  // Timer instance
 
 typedef enum {
     TRAINING_STATUS_IDLE           = 0x01,
@@ -19,6 +25,7 @@ typedef enum {
 } training_state_t;
 
 #define FTMS_INACTIVITY_TIMEOUT_MS 5000  // 5 seconds
+#define FTMS_INACTIVITY_SLACK_MS   500   // Restarted every tick, may expire on the next output wake-up
 #define FTMS_MAX_PAUSE_COUNT 1           // After this, transition to FINISHED
 
 static training_state_t current_training_state = TRAINING_STATUS_IDLE;
@@ -126,9 +133,10 @@ uint32_t ble_ftms_init(ble_ftms_t * p_ftms) {
     }
     NRF_LOG_INFO("FTMS Service added successfully. Handle: %d", p_ftms->service_handle);
     
-    err_code = app_timer_create(
+    err_code = deadline_timer_create(
         &ftms_training_timer,
-        APP_TIMER_MODE_SINGLE_SHOT,
+        DEADLINE_TIMER_MODE_SINGLE_SHOT,
+        FTMS_INACTIVITY_SLACK_MS,
         ftms_training_timer_handler
     );
     APP_ERROR_CHECK(err_code);
@@ -151,6 +159,8 @@ uint32_t ble_ftms_init(ble_ftms_t * p_ftms) {
 
 static int16_t last_power = -1;
 static uint8_t last_cadence = 0xFF;
+static uint32_t last_distance = 0xFFFFFFFF;
+static uint8_t last_heart_rate = 0xFF;
 static uint8_t _duplicate_counter = 0;
 
 static void _ble_ftms_send_indoor_bike_data(ble_ftms_t * p_ftms, ble_ftms_data_t * p_data) {
@@ -171,21 +181,26 @@ static void _ble_ftms_send_indoor_bike_data(ble_ftms_t * p_ftms, ble_ftms_data_t
     );
 
     if (err_code != NRF_SUCCESS || (cccd_value & BLE_GATT_HVX_NOTIFICATION) == 0) {
-        NRF_LOG_WARNING("⚠️ FTMS notifications not enabled. Skipping.");
+        TRACE_LOG0("FTMS: Notifications not enabled, not sent");
         return;
     }
 
+    // The bridge feeds the model the power that is sent or the measured wheel speed, speed and distance share that input
+    const virtual_speed_t *p_virtual = virtual_speed_get();
+    uint16_t speed = p_virtual->speed_kmh_x100;
+    uint32_t distance = p_virtual->distance_m;
+
     // 🧠 Deduplication logic
-    if (p_data->power_watts == last_power && p_data->cadence_rpm == last_cadence) {
+    if (p_data->power_watts == last_power && p_data->cadence_rpm == last_cadence && distance == last_distance &&
+        p_data->heart_rate_bpm == last_heart_rate) {
         _duplicate_counter++;
         if (_duplicate_counter < RESET_DUPLICATE_COUNTER_EVERY_N_MESSAGE) {
-            NRF_LOG_WARNING("⏩ FTMS duplicate (P:%d W, C:%d RPM), skipping [%d/%d]",
-                          p_data->power_watts, p_data->cadence_rpm,
-                          _duplicate_counter, RESET_DUPLICATE_COUNTER_EVERY_N_MESSAGE);
+            DIAG_INC(DIAG_FTMS_DEDUP_SKIP);
+            TRACE_LOG2("FTMS: Duplicate %u W / %u RPM skipped", p_data->power_watts, p_data->cadence_rpm);
             return;
         } else {
-            NRF_LOG_INFO("🔁 FTMS duplicate threshold reached. Forcing update (P:%d W, C:%d RPM)",
-                          p_data->power_watts, p_data->cadence_rpm);
+            TRACE_LOG2("FTMS: Duplicate threshold reached, forcing %u W / %u RPM",
+                       p_data->power_watts, p_data->cadence_rpm);
             _duplicate_counter = 0;  // Reset after forced send
         }
     } else {
@@ -193,21 +208,22 @@ static void _ble_ftms_send_indoor_bike_data(ble_ftms_t * p_ftms, ble_ftms_data_t
     }
 
     // Prepare FTMS data packet
-    uint8_t encoded_data[15] = {0};
+    uint8_t encoded_data[16] = {0};
+    uint16_t len = 13;
 
     encoded_data[0] = 0x74;  // Flags
     encoded_data[1] = 0x08;
 
-    encoded_data[2] = 0x00;  // Speed
-    encoded_data[3] = 0x00;
+    encoded_data[2] = speed & 0xFF;  // Speed (0.01 km/h)
+    encoded_data[3] = (speed >> 8) & 0xFF;
 
     uint16_t cadence = (uint16_t)(p_data->cadence_rpm * 2);
     encoded_data[4] = cadence & 0xFF;
     encoded_data[5] = (cadence >> 8) & 0xFF;
 
-    encoded_data[6] = 0x00;  // Distance
-    encoded_data[7] = 0x00;
-    encoded_data[8] = 0x00;
+    encoded_data[6] = distance & 0xFF;  // Total Distance (m, uint24)
+    encoded_data[7] = (distance >> 8) & 0xFF;
+    encoded_data[8] = (distance >> 16) & 0xFF;
 
     encoded_data[9]  = 0x00;  // Resistance Level
     encoded_data[10] = 0x00;
@@ -216,31 +232,43 @@ static void _ble_ftms_send_indoor_bike_data(ble_ftms_t * p_ftms, ble_ftms_data_t
     encoded_data[11] = power & 0xFF;
     encoded_data[12] = (power >> 8) & 0xFF;
 
-    encoded_data[13] = 0x00;  // Elapsed Time
-    encoded_data[14] = 0x00;
+    // Heart Rate (BPM) comes before Elapsed Time when present
+    if (p_data->heart_rate_bpm != 0) {
+        encoded_data[1] |= 0x02;  // Heart Rate Present
+        encoded_data[len++] = p_data->heart_rate_bpm;
+    }
+
+    uint16_t elapsed = (p_virtual->elapsed_s > 0xFFFF) ? 0xFFFF : (uint16_t)p_virtual->elapsed_s;
+    encoded_data[len++] = elapsed & 0xFF;  // Elapsed Time (s)
+    encoded_data[len++] = (elapsed >> 8) & 0xFF;
 
     ble_gatts_hvx_params_t hvx_params = {0};
     hvx_params.handle = p_ftms->indoor_bike_data_handles.value_handle;
     hvx_params.type   = BLE_GATT_HVX_NOTIFICATION;
     hvx_params.p_data = encoded_data;
-
-    uint16_t len = sizeof(encoded_data);
     hvx_params.p_len = &len;
 
     err_code = sd_ble_gatts_hvx(p_ftms->conn_handle, &hvx_params);
     if (err_code != NRF_SUCCESS) {
-        NRF_LOG_ERROR("❌ Failed to send FTMS notification: 0x%08X", err_code);
+        DIAG_INC(DIAG_HVX_FAIL);
+        TRACE_LOG2("FTMS: Notification of %u W failed: 0x%08X", p_data->power_watts, err_code);
     } else {
-        NRF_LOG_INFO("🚴 FTMS Power Sent: %d W, Cadence: %d RPM", p_data->power_watts, p_data->cadence_rpm);
+        DIAG_INC(DIAG_HVX_OK);
+        TRACE_LOG2("FTMS: Sent %u W / %u RPM", p_data->power_watts, p_data->cadence_rpm);
+        latency_trace_hvx();
         last_power = p_data->power_watts;
         last_cadence = p_data->cadence_rpm;
+        last_distance = distance;
+        last_heart_rate = p_data->heart_rate_bpm;
     }
 }
 
-void ble_ftms_tick(ble_ftms_t *p_ftms, uint16_t power_watts, uint8_t cadence_rpm) {
+void ble_ftms_tick(ble_ftms_t *p_ftms, uint16_t power_watts, uint8_t cadence_rpm, uint8_t heart_rate_bpm) {
     if (p_ftms->conn_handle == BLE_CONN_HANDLE_INVALID)
         return;
 
+    PROFILE_BEGIN(PROFILE_FTMS_TICK);
+
     // 1. Update training status
     bool is_active = (power_watts > 0 || cadence_rpm > 0);
 
@@ -252,8 +280,7 @@ void ble_ftms_tick(ble_ftms_t *p_ftms, uint16_t power_watts, uint8_t cadence_rpm
         }
 
         // Reset inactivity timer
-        app_timer_stop(ftms_training_timer);
-        app_timer_start(ftms_training_timer, APP_TIMER_TICKS(FTMS_INACTIVITY_TIMEOUT_MS), NULL);
+        deadline_timer_start(ftms_training_timer, FTMS_INACTIVITY_TIMEOUT_MS, NULL);
     }
 
     // 2. Notify Training Status if changed or periodically
@@ -293,9 +320,12 @@ void ble_ftms_tick(ble_ftms_t *p_ftms, uint16_t power_watts, uint8_t cadence_rpm
     // 3. Call Indoor Bike Data sender (reuse your existing deduped logic)
     ble_ftms_data_t ftms_data = {
         .power_watts = power_watts,
-        .cadence_rpm = cadence_rpm
+        .cadence_rpm = cadence_rpm,
+        .heart_rate_bpm = heart_rate_bpm
     };
     _ble_ftms_send_indoor_bike_data(p_ftms, &ftms_data);
+
+    PROFILE_END(PROFILE_FTMS_TICK);
 }
 
 
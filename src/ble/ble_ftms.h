@@ -18,12 +18,18 @@
 
 #define BLE_FTMS_FEATURE_AVG_SPEED_SUPPORTED         (1 << 0)
 #define BLE_FTMS_FEATURE_CADENCE_SUPPORTED           (1 << 1)
+#define BLE_FTMS_FEATURE_TOTAL_DISTANCE_SUPPORTED    (1 << 2)
 #define BLE_FTMS_FEATURE_INCLINATION_SUPPORTED       (1 << 3)
 #define BLE_FTMS_FEATURE_RESISTANCE_SUPPORTED        (1 << 7)
+#define BLE_FTMS_FEATURE_HEART_RATE_SUPPORTED        (1 << 10)
+#define BLE_FTMS_FEATURE_ELAPSED_TIME_SUPPORTED      (1 << 12)
 #define BLE_FTMS_FEATURE_POWER_MEASUREMENT_SUPPORTED (1 << 14)
 
 #define BLE_FTMS_FEATURES  ( \
     BLE_FTMS_FEATURE_CADENCE_SUPPORTED | \
+    BLE_FTMS_FEATURE_TOTAL_DISTANCE_SUPPORTED | \
+    BLE_FTMS_FEATURE_HEART_RATE_SUPPORTED | \
+    BLE_FTMS_FEATURE_ELAPSED_TIME_SUPPORTED | \
     BLE_FTMS_FEATURE_POWER_MEASUREMENT_SUPPORTED \
 )
 
@@ -34,6 +40,7 @@
 typedef struct {
     uint16_t power_watts;  // Power in Watts
     uint16_t cadence_rpm;  // Cadence in RPM
+    uint8_t heart_rate_bpm;  // Heart rate in BPM, 0 when unknown
 } ble_ftms_data_t;
 
 /**@brief FTMS Training Status Structure */
@@ -59,6 +66,6 @@ typedef struct {
 /**@brief Function for initializing the FTMS service. */
 uint32_t ble_ftms_init(ble_ftms_t * p_ftms);
 
-void ble_ftms_tick(ble_ftms_t *p_ftms, uint16_t power_watts, uint8_t cadence_rpm);
+void ble_ftms_tick(ble_ftms_t *p_ftms, uint16_t power_watts, uint8_t cadence_rpm, uint8_t heart_rate_bpm);
 
 #endif // BLE_FTMS_H__
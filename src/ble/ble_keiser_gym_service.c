@@ -0,0 +1,173 @@
+#include "ble_keiser_gym_service.h"
+#include "ble_srv_common.h"
+#include "nrf_log.h"
+#include "app_error.h"
+#include "app_timer.h"
+#include "nrf_sdh_ble.h"
+#include "ble_setup.h"
+#include "common_definitions.h"
+#include "keiser/keiser_gym_table.h"
+
+// Entries per notification with the default ATT MTU
+#define SNAPSHOT_NOTIFY_MAX_LEN   (BLE_GATT_ATT_MTU_DEFAULT - 3)
+#define SNAPSHOT_ENTRIES_PER_PAGE ((SNAPSHOT_NOTIFY_MAX_LEN - KEISER_GYM_SNAPSHOT_HDR_LEN) / KEISER_GYM_SNAPSHOT_ENTRY_LEN)
+
+// Manufacturer data in the scan response: AD header (2) + company ID (2) + payload
+#define BROADCAST_MAX_LEN         (BLE_GAP_ADV_SET_DATA_SIZE_MAX - 4)
+#define BROADCAST_ENTRIES_PER_FRAME ((BROADCAST_MAX_LEN - KEISER_GYM_BROADCAST_HDR_LEN) / KEISER_GYM_BROADCAST_ENTRY_LEN)
+
+ble_keiser_gym_t m_keiser_gym_service;
+
+static uint8_t m_snapshot[KEISER_GYM_SNAPSHOT_MAX_LEN];  // Characteristic value, stored in application RAM
+static uint8_t m_notify_next = 0;      // Index of the next bike to notify, 0xFF when idle
+static uint8_t m_notify_generation = 0;     // Table generation the notified pages were encoded under
+static uint8_t m_broadcast_first = 0;  // Index of the first bike in the next broadcast frame
+static uint8_t m_broadcast_generation = 0;  // Table generation of the broadcast rotation
+
+static void ble_keiser_gym_service_on_ble_evt(ble_evt_t const *p_ble_evt, void *p_context);
+NRF_SDH_BLE_OBSERVER(m_keiser_gym_service_observer, APP_BLE_OBSERVER_PRIO, ble_keiser_gym_service_on_ble_evt, NULL);
+
+/**@brief Send the next snapshot page, continues from HVN TX complete until all bikes are sent */
+static void send_next_page(void) {
+    if (m_keiser_gym_service.conn_handle == BLE_CONN_HANDLE_INVALID || m_notify_next == 0xFF) return;
+
+    uint16_t cccd_value = 0;
+    ble_gatts_value_t cccd_val = {.len = sizeof(cccd_value), .offset = 0, .p_value = (uint8_t *)&cccd_value};
+    uint32_t err_code = sd_ble_gatts_value_get(m_keiser_gym_service.conn_handle,
+                                               m_keiser_gym_service.snapshot_handles.cccd_handle,
+                                               &cccd_val);
+    if (err_code != NRF_SUCCESS || (cccd_value & BLE_GATT_HVX_NOTIFICATION) == 0) {
+        m_notify_next = 0xFF;
+        return;
+    }
+
+    // A bike was added or removed since the last page, indexes shifted: start over
+    if (keiser_gym_table_generation() != m_notify_generation) {
+        m_notify_generation = keiser_gym_table_generation();
+        m_notify_next = 0;
+    }
+
+    uint8_t page[SNAPSHOT_NOTIFY_MAX_LEN];
+    uint16_t len = keiser_gym_table_encode_snapshot(page, sizeof(page), m_notify_next, app_timer_cnt_get());
+
+    ble_gatts_hvx_params_t hvx_params = {0};
+    hvx_params.handle = m_keiser_gym_service.snapshot_handles.value_handle;
+    hvx_params.type   = BLE_GATT_HVX_NOTIFICATION;
+    hvx_params.p_data = page;
+    hvx_params.p_len  = &len;
+
+    err_code = sd_ble_gatts_hvx(m_keiser_gym_service.conn_handle, &hvx_params);
+    if (err_code == NRF_ERROR_RESOURCES) {
+        return;  // Queue full, retried on the next TX complete
+    }
+    if (err_code != NRF_SUCCESS) {
+        NRF_LOG_WARNING("⚠️ Keiser Gym: Snapshot notification failed: 0x%08X", err_code);
+        m_notify_next = 0xFF;
+        return;
+    }
+
+    m_notify_next += SNAPSHOT_ENTRIES_PER_PAGE;
+    if (m_notify_next >= keiser_gym_table_count()) {
+        m_notify_next = 0xFF;  // All bikes sent
+    }
+}
+
+/**@brief Function for handling BLE events in the Keiser Gym Service */
+static void ble_keiser_gym_service_on_ble_evt(ble_evt_t const *p_ble_evt, void *p_context) {
+    switch (p_ble_evt->header.evt_id) {
+        case BLE_GAP_EVT_CONNECTED:
+            if (p_ble_evt->evt.gap_evt.params.connected.role != BLE_GAP_ROLE_PERIPH) break;
+            m_keiser_gym_service.conn_handle = p_ble_evt->evt.gap_evt.conn_handle;
+            m_notify_next = 0xFF;
+            break;
+
+        case BLE_GAP_EVT_DISCONNECTED:
+            if (p_ble_evt->evt.gap_evt.conn_handle != m_keiser_gym_service.conn_handle) break;
+            m_keiser_gym_service.conn_handle = BLE_CONN_HANDLE_INVALID;
+            m_notify_next = 0xFF;
+            break;
+
+        case BLE_GATTS_EVT_HVN_TX_COMPLETE:
+            send_next_page();
+            break;
+
+        default:
+            break;
+    }
+}
+
+void ble_keiser_gym_service_update(void) {
+    uint32_t now = app_timer_cnt_get();
+
+    keiser_gym_table_expire(now);
+
+    // ✅ Refresh the readable snapshot (long read returns all bikes). The value lives in
+    // m_snapshot, encode in place and only update the length (p_value NULL)
+    ble_gatts_value_t value = {
+        .len = keiser_gym_table_encode_snapshot(m_snapshot, sizeof(m_snapshot), 0, now),
+        .offset = 0,
+        .p_value = NULL
+    };
+    uint32_t err_code = sd_ble_gatts_value_set(BLE_CONN_HANDLE_INVALID,
+                                               m_keiser_gym_service.snapshot_handles.value_handle, &value);
+    if (err_code != NRF_SUCCESS) {
+        NRF_LOG_WARNING("⚠️ Keiser Gym: Snapshot update failed: 0x%08X", err_code);
+    }
+
+    // ✅ Notify all bikes, page by page
+    if (m_notify_next == 0xFF) {
+        m_notify_next = 0;
+        m_notify_generation = keiser_gym_table_generation();
+        send_next_page();
+    }
+
+    // ✅ Rotate the broadcast frame through the table, from the start when bikes came or went
+    uint8_t count = keiser_gym_table_count();
+    if (m_broadcast_first >= count || keiser_gym_table_generation() != m_broadcast_generation) {
+        m_broadcast_first = 0;
+        m_broadcast_generation = keiser_gym_table_generation();
+    }
+
+    uint8_t frame[BROADCAST_MAX_LEN];
+    uint16_t frame_len = keiser_gym_table_encode_broadcast(frame, sizeof(frame), m_broadcast_first, now);
+    advertising_set_manuf_data(KEISER_GYM_BROADCAST_COMPANY_ID, frame, (uint8_t)frame_len);
+
+    m_broadcast_first += BROADCAST_ENTRIES_PER_FRAME;
+
+    NRF_LOG_DEBUG("Keiser Gym: %d bikes, broadcast frame %d bytes", count, frame_len);
+}
+
+/**@brief Function to initialize the Keiser Gym Service */
+void ble_keiser_gym_service_init(void) {
+    ble_uuid_t ble_uuid;
+    ble_uuid.type = BLE_UUID_TYPE_BLE;
+    ble_uuid.uuid = KEISER_GYM_SERVICE_UUID;
+    m_keiser_gym_service.conn_handle = BLE_CONN_HANDLE_INVALID;
+    m_notify_next = 0xFF;
+
+    uint32_t err_code = sd_ble_gatts_service_add(BLE_GATTS_SRVC_TYPE_PRIMARY, &ble_uuid,
+                                                 &m_keiser_gym_service.service_handle);
+    APP_ERROR_CHECK(err_code);
+
+    // ✅ Snapshot Characteristic (Read + Notify), value kept in application RAM to spare the attribute table
+    m_snapshot[0] = 0;  // No bikes
+    m_snapshot[1] = 0;
+
+    ble_add_char_params_t snapshot_params = {0};
+    snapshot_params.uuid = KEISER_GYM_SNAPSHOT_CHAR_UUID;
+    snapshot_params.uuid_type = BLE_UUID_TYPE_BLE;
+    snapshot_params.init_len = KEISER_GYM_SNAPSHOT_HDR_LEN;
+    snapshot_params.max_len = KEISER_GYM_SNAPSHOT_MAX_LEN;
+    snapshot_params.is_var_len = true;
+    snapshot_params.is_value_user = true;
+    snapshot_params.p_init_value = m_snapshot;
+    snapshot_params.char_props.read = 1;
+    snapshot_params.char_props.notify = 1;
+    snapshot_params.read_access = SEC_OPEN;
+    snapshot_params.cccd_write_access = SEC_OPEN;
+    err_code = characteristic_add(m_keiser_gym_service.service_handle, &snapshot_params,
+                                  &m_keiser_gym_service.snapshot_handles);
+    APP_ERROR_CHECK(err_code);
+
+    NRF_LOG_INFO("✅ Keiser Gym Service Initialized");
+}
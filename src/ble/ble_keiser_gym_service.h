@@ -0,0 +1,28 @@
+#ifndef BLE_KEISER_GYM_SERVICE_H__
+#define BLE_KEISER_GYM_SERVICE_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ble.h"
+#include "ble_srv_common.h"
+
+#define KEISER_GYM_SERVICE_UUID        0x1610
+#define KEISER_GYM_SNAPSHOT_CHAR_UUID  0x1611
+
+#define KEISER_GYM_BROADCAST_COMPANY_ID 0xFFFF  // Reserved company ID, no registered ID for this device
+
+typedef struct {
+    uint16_t service_handle;
+    ble_gatts_char_handles_t snapshot_handles;
+    uint16_t conn_handle;
+} ble_keiser_gym_t;
+
+extern ble_keiser_gym_t m_keiser_gym_service;
+
+/**@brief Function to initialize the Keiser Gym Service */
+void ble_keiser_gym_service_init(void);
+
+/**@brief Refresh the snapshot, notify subscribers and rotate the broadcast frame. Call periodically. */
+void ble_keiser_gym_service_update(void);
+
+#endif // BLE_KEISER_GYM_SERVICE_H__
@@ -0,0 +1,126 @@
+#include "ble_ride_stats_service.h"
+#include "ble_srv_common.h"
+#include "nrf_log.h"
+#include "app_error.h"
+#include "nrf_sdh_ble.h"
+#include "common_definitions.h"
+#include "includes/ride_stats.h"
+
+#define HISTORY_MAX_LEN (RIDE_STATS_ENCODED_LEN * RIDE_STATS_MAX_SESSIONS)
+
+ble_ride_stats_t m_ride_stats_service;
+
+// Characteristic values, stored in application RAM to spare the attribute table
+static uint8_t m_current[RIDE_STATS_ENCODED_LEN];
+static uint8_t m_history[HISTORY_MAX_LEN];
+
+static void ble_ride_stats_service_on_ble_evt(ble_evt_t const *p_ble_evt, void *p_context);
+NRF_SDH_BLE_OBSERVER(m_ride_stats_service_observer, APP_BLE_OBSERVER_PRIO, ble_ride_stats_service_on_ble_evt, NULL);
+
+/**@brief Function for handling BLE events in the Ride Stats Service */
+static void ble_ride_stats_service_on_ble_evt(ble_evt_t const *p_ble_evt, void *p_context) {
+    switch (p_ble_evt->header.evt_id) {
+        case BLE_GAP_EVT_CONNECTED:
+            if (p_ble_evt->evt.gap_evt.params.connected.role != BLE_GAP_ROLE_PERIPH) break;
+            m_ride_stats_service.conn_handle = p_ble_evt->evt.gap_evt.conn_handle;
+            break;
+
+        case BLE_GAP_EVT_DISCONNECTED:
+            if (p_ble_evt->evt.gap_evt.conn_handle != m_ride_stats_service.conn_handle) break;
+            m_ride_stats_service.conn_handle = BLE_CONN_HANDLE_INVALID;
+            break;
+
+        default:
+            break;
+    }
+}
+
+/**@brief Encode the stored sessions, newest first */
+static uint16_t encode_history(void) {
+    uint16_t len = 0;
+    const ride_stats_summary_t *p_session;
+
+    for (uint8_t i = 0; (p_session = ride_stats_get_stored(i)) != NULL; i++) {
+        len += ride_stats_encode(p_session, &m_history[len]);
+    }
+    return len;
+}
+
+void ble_ride_stats_service_update(void) {
+    uint16_t len = ride_stats_encode(ride_stats_get(), m_current);
+
+    // ✅ Refresh the readable values, encoded in place in application RAM so only the length is set
+    ble_gatts_value_t value = {.len = len, .offset = 0, .p_value = NULL};
+    uint32_t err_code = sd_ble_gatts_value_set(BLE_CONN_HANDLE_INVALID, m_ride_stats_service.current_handles.value_handle, &value);
+    if (err_code != NRF_SUCCESS) {
+        NRF_LOG_WARNING("⚠️ Ride Stats: Failed to set current session: 0x%08X", err_code);
+    }
+
+    ble_gatts_value_t history = {.len = encode_history(), .offset = 0, .p_value = NULL};
+    err_code = sd_ble_gatts_value_set(BLE_CONN_HANDLE_INVALID, m_ride_stats_service.history_handles.value_handle, &history);
+    if (err_code != NRF_SUCCESS) {
+        NRF_LOG_WARNING("⚠️ Ride Stats: Failed to set history: 0x%08X", err_code);
+    }
+
+    if (m_ride_stats_service.conn_handle == BLE_CONN_HANDLE_INVALID) return;
+
+    uint16_t cccd_value = 0;
+    ble_gatts_value_t cccd_val = {.len = sizeof(cccd_value), .offset = 0, .p_value = (uint8_t *)&cccd_value};
+    err_code = sd_ble_gatts_value_get(m_ride_stats_service.conn_handle,
+                                               m_ride_stats_service.current_handles.cccd_handle,
+                                               &cccd_val);
+    if (err_code != NRF_SUCCESS || (cccd_value & BLE_GATT_HVX_NOTIFICATION) == 0) return;
+
+    ble_gatts_hvx_params_t hvx_params = {0};
+    hvx_params.handle = m_ride_stats_service.current_handles.value_handle;
+    hvx_params.type   = BLE_GATT_HVX_NOTIFICATION;
+    hvx_params.p_data = m_current;
+    hvx_params.p_len  = &len;
+
+    err_code = sd_ble_gatts_hvx(m_ride_stats_service.conn_handle, &hvx_params);
+    if (err_code != NRF_SUCCESS && err_code != NRF_ERROR_RESOURCES) {
+        NRF_LOG_WARNING("⚠️ Ride Stats: Notification failed: 0x%08X", err_code);
+    }
+}
+
+/**@brief Function to initialize the Ride Stats Service */
+void ble_ride_stats_service_init(void) {
+    ble_uuid_t ble_uuid;
+    ble_uuid.type = BLE_UUID_TYPE_BLE;
+    ble_uuid.uuid = RIDE_STATS_SERVICE_UUID;
+    m_ride_stats_service.conn_handle = BLE_CONN_HANDLE_INVALID;
+
+    uint32_t err_code = sd_ble_gatts_service_add(BLE_GATTS_SRVC_TYPE_PRIMARY, &ble_uuid, &m_ride_stats_service.service_handle);
+    APP_ERROR_CHECK(err_code);
+
+    // ✅ Current Session Characteristic (Read + Notify)
+    ble_add_char_params_t current_params = {0};
+    current_params.uuid = RIDE_STATS_CURRENT_CHAR_UUID;
+    current_params.uuid_type = BLE_UUID_TYPE_BLE;
+    current_params.init_len = RIDE_STATS_ENCODED_LEN;
+    current_params.max_len = RIDE_STATS_ENCODED_LEN;
+    current_params.is_value_user = true;
+    current_params.p_init_value = m_current;
+    current_params.char_props.read = 1;
+    current_params.char_props.notify = 1;
+    current_params.read_access = SEC_OPEN;
+    current_params.cccd_write_access = SEC_OPEN;
+    err_code = characteristic_add(m_ride_stats_service.service_handle, &current_params, &m_ride_stats_service.current_handles);
+    APP_ERROR_CHECK(err_code);
+
+    // ✅ Session History Characteristic (Read)
+    ble_add_char_params_t history_params = {0};
+    history_params.uuid = RIDE_STATS_HISTORY_CHAR_UUID;
+    history_params.uuid_type = BLE_UUID_TYPE_BLE;
+    history_params.init_len = 0;
+    history_params.max_len = HISTORY_MAX_LEN;
+    history_params.is_var_len = true;
+    history_params.is_value_user = true;
+    history_params.p_init_value = m_history;
+    history_params.char_props.read = 1;
+    history_params.read_access = SEC_OPEN;
+    err_code = characteristic_add(m_ride_stats_service.service_handle, &history_params, &m_ride_stats_service.history_handles);
+    APP_ERROR_CHECK(err_code);
+
+    NRF_LOG_INFO("✅ Ride Stats Service Initialized");
+}
@@ -0,0 +1,28 @@
+#ifndef BLE_RIDE_STATS_SERVICE_H__
+#define BLE_RIDE_STATS_SERVICE_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ble.h"
+#include "ble_srv_common.h"
+
+#define RIDE_STATS_SERVICE_UUID        0x1630
+#define RIDE_STATS_CURRENT_CHAR_UUID   0x1631  // Current session (read + notify)
+#define RIDE_STATS_HISTORY_CHAR_UUID   0x1632  // Stored sessions, newest first (long read)
+
+typedef struct {
+    uint16_t service_handle;
+    ble_gatts_char_handles_t current_handles;
+    ble_gatts_char_handles_t history_handles;
+    uint16_t conn_handle;
+} ble_ride_stats_t;
+
+extern ble_ride_stats_t m_ride_stats_service;
+
+/**@brief Function to initialize the Ride Stats Service */
+void ble_ride_stats_service_init(void);
+
+/**@brief Refresh both characteristics and notify the current session. Call periodically. */
+void ble_ride_stats_service_update(void);
+
+#endif // BLE_RIDE_STATS_SERVICE_H__
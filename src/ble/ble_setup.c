@@ -15,6 +15,10 @@
 #include "ble_custom_config.h"
 #include "ble_ant_scan_service.h"
 #include "ble_battery_service.h"
+#include "ble_keiser_gym_service.h"
+#include "ble_ant_agg_service.h"
+#include "ble_ride_stats_service.h"
+#include "ble_diagnostics_service.h"
 #include "battery_measurement.h"
 
 #include "app_error.h"
@@ -28,8 +32,16 @@
 #include "device_info.h"  
 #include <ble_conn_params.h>
 #include "ble_advdata.h"
+#include "app_util.h"
 #include "nrf_delay.h"
 #include "boards.h"
+#include "includes/crash_log.h"
+#include "includes/deadline_timer.h"
+#include "includes/boot_profile.h"
+#include "includes/latency_trace.h"
+#ifdef BONDING_ENABLE
+#include "ble_bonding.h"
+#endif
 
 app_timer_id_t ble_shutdown_timer;
 bool ant_active = false;
@@ -38,16 +50,44 @@ bool ble_started = false;
 bool ble_shutdown_timer_running = false;
 
 
+/**@brief Advertising stages, each one ends in a timeout that starts the next.
+ */
+typedef enum
+{
+    ADV_STAGE_IDLE,      /**< Not advertising, connected or stopped */
+    ADV_STAGE_DIRECTED,  /**< High duty directed advertising to the last central, 1.28 s */
+    ADV_STAGE_WHITELIST, /**< APP_ADV_INTERVAL, connections from bonded centrals only, APP_ADV_WHITELIST_DURATION */
+    ADV_STAGE_FAST,      /**< APP_ADV_INTERVAL for APP_ADV_FAST_DURATION */
+    ADV_STAGE_SLOW,      /**< APP_ADV_SLOW_INTERVAL until connected */
+} adv_stage_t;
+
 NRF_BLE_GATT_DEF(m_gatt);
 NRF_BLE_QWR_DEF(m_qwr);                                                              /**< Context for the Queued Write module.*/
 static void ble_evt_handler(ble_evt_t const * p_ble_evt, void * p_context);
+static void advertising_stage_start(adv_stage_t stage);
+static void advertising_peer_remember(ble_gap_addr_t const * p_addr);
 NRF_SDH_BLE_OBSERVER(m_ble_observer, APP_BLE_OBSERVER_PRIO, ble_evt_handler, NULL);
-APP_TIMER_DEF(battery_timer);
+static deadline_timer_id_t battery_timer;
 
 volatile uint16_t m_conn_handle = BLE_CONN_HANDLE_INVALID;
 
 uint8_t m_adv_handle;      /**< Advertising handle. */
 
+static ble_gap_adv_data_t m_adv_data_enc;                              /**< Encoded advertising and scan response data. */
+static uint8_t m_advdata_buff[2][BLE_GAP_ADV_SET_DATA_SIZE_MAX];       /**< Double buffered, the SoftDevice keeps using the old buffer while advertising. */
+static uint8_t m_srdata_buff[2][BLE_GAP_ADV_SET_DATA_SIZE_MAX];
+static uint8_t m_adv_buff_index = 0;
+
+static adv_stage_t m_adv_stage = ADV_STAGE_IDLE;
+static ble_gap_addr_t m_directed_peer;       /**< Identity address of the last central. */
+static bool m_directed_peer_valid = false;   /**< Directed advertising needs an address that does not change. */
+
+static ble_uuid_t m_adv_uuids[] = {
+    {BLE_UUID_FTMS_SERVICE, BLE_UUID_TYPE_BLE},          // ✅ FTMS Service
+    {BLE_UUID_CYCLING_POWER_SERVICE, BLE_UUID_TYPE_BLE}, // ✅ Cycling Power Service
+    {ANT_SCAN_SERVICE_UUID, BLE_UUID_TYPE_BLE}
+};
+
 uint16_t latest_power_watts = 0;  // Define and initialize
 uint8_t latest_cadence_rpm = 0;
 
@@ -97,6 +137,7 @@ void stop_ble_advertising(void)
         return;
     }
     NRF_LOG_INFO("🛑 Stopping BLE power transmission timer...");
+    m_adv_stage = ADV_STAGE_IDLE;  // No next stage on a timeout
     uint32_t err_code = sd_ble_gap_adv_stop(m_adv_handle);  // ✅ Pass advertising handle
 
     if (err_code == NRF_SUCCESS)
@@ -144,12 +185,15 @@ void softdevice_setup(void)
     APP_ERROR_CHECK(err_code);
     NRF_LOG_INFO("✅ BLE Config Set");
 
+    // The linker's RAM origin, sd_ble_enable() replaces it with what the SoftDevice needs
+    uint32_t app_ram_start = ram_start;
     err_code = nrf_sdh_ble_enable(&ram_start);
     if (err_code == NRF_ERROR_NO_MEM) {
-        NRF_LOG_ERROR("🚨 Memory issue! SoftDevice needs more RAM.");
+        NRF_LOG_ERROR("🚨 Memory issue! SoftDevice needs RAM up to 0x%08X, app RAM starts at 0x%08X.",
+                      ram_start, app_ram_start);
     }
     APP_ERROR_CHECK(err_code);
-    NRF_LOG_INFO("✅ BLE Enabled");
+    NRF_LOG_INFO("✅ BLE Enabled, SoftDevice RAM up to 0x%08X, app RAM from 0x%08X", ram_start, app_ram_start);
 
     err_code = nrf_sdh_ant_enable();
     if (err_code != NRF_SUCCESS) {
@@ -175,7 +219,8 @@ static void nrf_qwr_error_handler(uint32_t nrf_error)
 
 /**@brief Initialize services that will be used by the application.
  *
- * @details Initialize the Heart Rate and Device Information services.
+ * @details Initialize the services that do not depend on the stored configuration,
+ *          they can be added while FDS is still starting.
  */
 void services_init(void)
 {
@@ -228,11 +273,39 @@ void services_init(void)
     // Initialize Battery BLE Service (should not call battery_monitoring_init again)
     ble_battery_service_init();  
 
-    app_timer_create(&battery_timer, APP_TIMER_MODE_REPEATED, update_battery);
-    app_timer_start(battery_timer, APP_TIMER_TICKS(120000), NULL);  // Update every 2 minutes
+    // The level changes slowly, the update may wait for another wake-up
+    err_code = deadline_timer_create(&battery_timer, DEADLINE_TIMER_MODE_REPEATED, 30000, update_battery);
+    APP_ERROR_CHECK(err_code);
+    deadline_timer_start(battery_timer, 120000, NULL);  // Update every 2 minutes
+}
 
+/**@brief Function for initializing the services that depend on the stored configuration.
+ *
+ * @details Added after services_init() so the attribute table keeps its order.
+ */
+void services_config_init(void)
+{
     ble_custom_service_init();  
 
+    // Keiser Gym snapshot service is only present in gym receiver mode
+    if (m_data_source_type == DATA_SOURCE_KEISER_GYM)
+    {
+        ble_keiser_gym_service_init();
+    }
+
+    // ANT+ aggregator service is only present in aggregator mode
+    if (m_data_source_type == DATA_SOURCE_ANT_AGGREGATOR)
+    {
+        ble_ant_agg_service_init();
+    }
+
+    // Ride statistics belong to the single rider modes
+    if (m_data_source_type != DATA_SOURCE_KEISER_GYM && m_data_source_type != DATA_SOURCE_ANT_AGGREGATOR)
+    {
+        ble_ride_stats_service_init();
+    }
+
+    ble_diagnostics_service_init();
 }
 
 /**@brief Function for dispatching a BLE stack event to all modules with a BLE stack event handler.
@@ -247,7 +320,14 @@ static void ble_evt_handler(ble_evt_t const * p_ble_evt, void * p_context)
     switch (p_ble_evt->header.evt_id)
     {
         case BLE_GAP_EVT_CONNECTED:
+            // Central links to sensors are owned by the BLE central data source
+            if (p_ble_evt->evt.gap_evt.params.connected.role != BLE_GAP_ROLE_PERIPH)
+            {
+                break;
+            }
             NRF_LOG_INFO("✅ BLE Connected");
+            m_adv_stage = ADV_STAGE_IDLE;  // The SoftDevice stopped advertising
+            advertising_peer_remember(&p_ble_evt->evt.gap_evt.params.connected.peer_addr);
             err_code = bsp_indication_set(BSP_INDICATE_CONNECTED);
             APP_ERROR_CHECK(err_code);
             m_conn_handle = p_ble_evt->evt.gap_evt.conn_handle;
@@ -256,12 +336,22 @@ static void ble_evt_handler(ble_evt_t const * p_ble_evt, void * p_context)
             m_battery_service.conn_handle = m_conn_handle;
             err_code = nrf_ble_qwr_conn_handle_assign(&m_qwr, m_conn_handle);
             APP_ERROR_CHECK(err_code);
+            latency_trace_connected();
+
+#ifdef BONDING_ENABLE
+            // A bonded central is only encrypted, a new one is asked to bond so its CCCDs are kept
+            ble_bonding_conn_secure(m_conn_handle);
+#endif // BONDING_ENABLE
             
             // Notify the BLE bridge about the connection
             ble_bridge_connection_event(true);
             break;
 
         case BLE_GAP_EVT_DISCONNECTED:
+            if (p_ble_evt->evt.gap_evt.conn_handle != m_conn_handle)
+            {
+                break;
+            }
             NRF_LOG_INFO("⚠️ BLE Disconnected");
             err_code = bsp_indication_set(BSP_INDICATE_IDLE);
             APP_ERROR_CHECK(err_code);
@@ -274,7 +364,7 @@ static void ble_evt_handler(ble_evt_t const * p_ble_evt, void * p_context)
             ble_bridge_connection_event(false);
             
             // Keep ANT+ Running – Do NOT close the ANT+ channel!
-            // Just restart BLE advertising
+            // Just restart BLE advertising, directed to the central that just left first
             start_ble_advertising();  
             break;
 
@@ -304,12 +394,12 @@ static void ble_evt_handler(ble_evt_t const * p_ble_evt, void * p_context)
 
 #ifndef BONDING_ENABLE
         case BLE_GAP_EVT_SEC_INFO_REQUEST:
-            err_code = sd_ble_gap_sec_info_reply(m_conn_handle, NULL, NULL, NULL);
+            err_code = sd_ble_gap_sec_info_reply(p_ble_evt->evt.gap_evt.conn_handle, NULL, NULL, NULL);
             APP_ERROR_CHECK(err_code);
             break;
 
         case BLE_GAP_EVT_SEC_PARAMS_REQUEST:
-            err_code = sd_ble_gap_sec_params_reply(m_conn_handle,
+            err_code = sd_ble_gap_sec_params_reply(p_ble_evt->evt.gap_evt.conn_handle,
                                                    BLE_GAP_SEC_STATUS_PAIRING_NOT_SUPP,
                                                    NULL,
                                                    NULL);
@@ -321,15 +411,33 @@ static void ble_evt_handler(ble_evt_t const * p_ble_evt, void * p_context)
             if (p_ble_evt->evt.gap_evt.params.adv_set_terminated.reason ==
                 BLE_GAP_EVT_ADV_SET_TERMINATED_REASON_TIMEOUT)
             {
-                NRF_LOG_INFO("🔄 Advertising Timeout - For now no connections possible.. check this...");
-                err_code = bsp_indication_set(BSP_INDICATE_IDLE);
-                APP_ERROR_CHECK(err_code);
+                if (m_adv_stage == ADV_STAGE_DIRECTED)
+                {
+                    NRF_LOG_INFO("🔄 Directed advertising timeout");
+                    advertising_stage_start(ADV_STAGE_WHITELIST);
+                }
+                else if (m_adv_stage == ADV_STAGE_WHITELIST)
+                {
+                    NRF_LOG_INFO("🔄 Whitelist advertising timeout, advertising to all");
+                    advertising_stage_start(ADV_STAGE_FAST);
+                }
+                else if (m_adv_stage == ADV_STAGE_FAST)
+                {
+                    NRF_LOG_INFO("🔄 Fast advertising timeout, slowing down");
+                    advertising_stage_start(ADV_STAGE_SLOW);
+                }
+                else
+                {
+                    NRF_LOG_INFO("🔄 Advertising Timeout");
+                    err_code = bsp_indication_set(BSP_INDICATE_IDLE);
+                    APP_ERROR_CHECK(err_code);
+                }
             }
             break;
 
 #ifndef BONDING_ENABLE
         case BLE_GATTS_EVT_SYS_ATTR_MISSING:
-            err_code = sd_ble_gatts_sys_attr_set(m_conn_handle,
+            err_code = sd_ble_gatts_sys_attr_set(p_ble_evt->evt.gatts_evt.conn_handle,
                                                  NULL,
                                                  0,
                                                  BLE_GATTS_SYS_ATTR_FLAG_SYS_SRVCS | BLE_GATTS_SYS_ATTR_FLAG_USR_SRVCS);
@@ -347,8 +455,8 @@ static void advertising_failed_handler(uint32_t err_code)
 {
     NRF_LOG_ERROR("🔁 Advertising failed. Restarting device... Error: 0x%08X", err_code);
 
-    // Optional: set a GPREGRET reason for debugging after reset
-    //NRF_POWER->GPREGRET = 0xAD;  // 0xAD = Advertising failure (custom code)
+    // Reason for the next boot, GPREGRET is left to the bootloader
+    crash_log_record(CRASH_CAUSE_ADV_FAILED, 0, 0, err_code, __FILE__, __LINE__);
 
     // Give time for logs to flush
     nrf_delay_ms(100);
@@ -367,6 +475,7 @@ static void advertising_start(void)
         err_code = sd_ble_gap_adv_start(m_adv_handle, APP_BLE_CONN_CFG_TAG);
         if (err_code == NRF_SUCCESS) {
             NRF_LOG_INFO("✅ BLE Advertising started on attempt %d", i + 1);
+            boot_profile_mark(BOOT_PHASE_FIRST_ADV);
             ble_started = true;  // Set flag to indicate BLE is started
             break;
         } else {
@@ -383,18 +492,156 @@ static void advertising_start(void)
         return;
     }
 
-    err_code = bsp_indication_set(BSP_INDICATE_ADVERTISING);
+    bsp_indication_t indication = (m_adv_stage == ADV_STAGE_DIRECTED) ? BSP_INDICATE_ADVERTISING_DIRECTED :
+                                  (m_adv_stage == ADV_STAGE_WHITELIST) ? BSP_INDICATE_ADVERTISING_WHITELIST :
+                                  (m_adv_stage == ADV_STAGE_SLOW) ? BSP_INDICATE_ADVERTISING_SLOW :
+                                  BSP_INDICATE_ADVERTISING;
+    err_code = bsp_indication_set(indication);
     if (err_code != NRF_SUCCESS) {
         NRF_LOG_WARNING("⚠️ LED indication failed: 0x%08X", err_code);
     }
 }
 
+/**@brief Advertising parameters of a stage.
+ */
+static void advertising_params_get(adv_stage_t stage, ble_gap_adv_params_t * p_params)
+{
+    memset(p_params, 0, sizeof(*p_params));
+
+    p_params->primary_phy   = BLE_GAP_PHY_1MBPS;
+    p_params->filter_policy = BLE_GAP_ADV_FP_ANY;
 
+    switch (stage)
+    {
+        case ADV_STAGE_DIRECTED:
+            // The interval is fixed at 3.75 ms or less for high duty cycle
+            p_params->properties.type = BLE_GAP_ADV_TYPE_CONNECTABLE_NONSCANNABLE_DIRECTED_HIGH_DUTY_CYCLE;
+            p_params->p_peer_addr     = &m_directed_peer;
+            p_params->duration        = BLE_GAP_ADV_TIMEOUT_HIGH_DUTY_MAX;
+            break;
+
+        case ADV_STAGE_WHITELIST:
+            // Anyone may scan, only the centrals in the whitelist may connect
+            p_params->properties.type = BLE_GAP_ADV_TYPE_CONNECTABLE_SCANNABLE_UNDIRECTED;
+            p_params->filter_policy   = BLE_GAP_ADV_FP_FILTER_CONNREQ;
+            p_params->interval        = APP_ADV_INTERVAL;
+            p_params->duration        = APP_ADV_WHITELIST_DURATION;
+            break;
+
+        case ADV_STAGE_SLOW:
+            p_params->properties.type = BLE_GAP_ADV_TYPE_CONNECTABLE_SCANNABLE_UNDIRECTED;
+            p_params->interval        = APP_ADV_SLOW_INTERVAL;
+            p_params->duration        = BLE_GAP_ADV_TIMEOUT_GENERAL_UNLIMITED;
+            break;
+
+        default:
+            p_params->properties.type = BLE_GAP_ADV_TYPE_CONNECTABLE_SCANNABLE_UNDIRECTED;
+            p_params->interval        = APP_ADV_INTERVAL;
+            p_params->duration        = APP_ADV_FAST_DURATION;
+            break;
+    }
+}
+
+/**@brief Fill the SoftDevice whitelist with the bonded centrals.
+ *
+ * @details The Keiser M3i scanner keeps the bike in the same whitelist between its scan
+ *          windows, whitelist advertising is left out when it may be running.
+ *
+ * @return true if there is at least one central in the whitelist.
+ */
+static bool advertising_whitelist_apply(void)
+{
+#ifdef BONDING_ENABLE
+    if (m_data_source_type == DATA_SOURCE_KEISER_M3I || m_backup_source_type == DATA_SOURCE_KEISER_M3I)
+    {
+        return false;
+    }
+    return ble_bonding_whitelist_apply() > 0;
+#else
+    return false;
+#endif // BONDING_ENABLE
+}
+
+/**@brief Reconfigure the advertising set for a stage and start it.
+ */
+static void advertising_stage_start(adv_stage_t stage)
+{
+    ble_gap_adv_params_t adv_params;
+    uint32_t             err_code;
+
+    // Parameters can only change while stopped, stopping an idle set is harmless
+    (void)sd_ble_gap_adv_stop(m_adv_handle);
+
+    // Without bonded centrals there is nobody to wait for
+    if (stage == ADV_STAGE_WHITELIST && !advertising_whitelist_apply())
+    {
+        stage = ADV_STAGE_FAST;
+    }
+
+    advertising_params_get(stage, &adv_params);
+
+    // Directed advertising carries no data
+    err_code = sd_ble_gap_adv_set_configure(&m_adv_handle,
+                                            (stage == ADV_STAGE_DIRECTED) ? NULL : &m_adv_data_enc,
+                                            &adv_params);
+    if (err_code != NRF_SUCCESS && stage == ADV_STAGE_DIRECTED)
+    {
+        NRF_LOG_WARNING("⚠️ Directed advertising not possible: 0x%08X", err_code);
+        m_directed_peer_valid = false;
+        stage = ADV_STAGE_FAST;
+        advertising_params_get(stage, &adv_params);
+        err_code = sd_ble_gap_adv_set_configure(&m_adv_handle, &m_adv_data_enc, &adv_params);
+    }
+    if (err_code != NRF_SUCCESS)
+    {
+        advertising_failed_handler(err_code);
+        return;
+    }
+
+    m_adv_stage = stage;
+    advertising_start();
+}
+
+/**@brief Keep the address of a central for directed advertising after a disconnect.
+ *
+ * @details Random resolvable addresses change, the central would not recognise them
+ *          without its IRK, only identity addresses are kept. The SoftDevice only
+ *          resolves a phone's address and sets addr_id_peer when the phone's IRK is
+ *          in the device identity list at connection time, which is filled by
+ *          ble_bonding_whitelist_apply() for bonded phones. Phones that connect
+ *          before that, or without bonding, skip the directed stage; in practice it
+ *          serves centrals with a public or static address such as head units.
+ */
+static void advertising_peer_remember(ble_gap_addr_t const * p_addr)
+{
+    if (p_addr->addr_id_peer ||
+        p_addr->addr_type == BLE_GAP_ADDR_TYPE_PUBLIC ||
+        p_addr->addr_type == BLE_GAP_ADDR_TYPE_RANDOM_STATIC)
+    {
+        m_directed_peer = *p_addr;
+        m_directed_peer_valid = true;
+    }
+    else
+    {
+        m_directed_peer_valid = false;
+    }
+}
 
 void start_ble_advertising(void)
 {
     NRF_LOG_INFO("📡 Starting BLE Advertising...");
-    advertising_start();  // Use the existing function
+    advertising_stage_start(m_directed_peer_valid ? ADV_STAGE_DIRECTED : ADV_STAGE_WHITELIST);
+}
+
+void advertising_fast_restart(void)
+{
+    if (m_adv_stage != ADV_STAGE_SLOW)
+    {
+        return;
+    }
+
+    NRF_LOG_INFO("📡 Data is back, fast advertising");
+    advertising_stage_start(ADV_STAGE_FAST);
 }
 
 /**@brief Connection Parameters module error handler.
@@ -454,6 +701,55 @@ void conn_params_init(void)
     APP_ERROR_CHECK(err_code);
 }
 
+/**@brief Encode the advertising and scan response data into one buffer pair.
+ *
+ * @details The advertising packet only carries the flags and the appearance, the name
+ *          and the service UUIDs are in the scan response. Manufacturer data fills the
+ *          scan response on its own, the name and UUIDs then move to the advertising
+ *          packet.
+ *
+ * @param[in] index    Buffer pair to encode into.
+ * @param[in] p_manuf  Manufacturer data for the scan response, NULL for none.
+ */
+static uint32_t advertising_data_encode(uint8_t index, ble_advdata_manuf_data_t * p_manuf)
+{
+    uint32_t      err_code;
+    ble_advdata_t advdata;
+    ble_advdata_t srdata;
+    uint16_t      advdata_len = BLE_GAP_ADV_SET_DATA_SIZE_MAX;
+    uint16_t      srdata_len = BLE_GAP_ADV_SET_DATA_SIZE_MAX;
+
+    memset(&advdata, 0, sizeof(advdata));
+    memset(&srdata, 0, sizeof(srdata));
+
+    advdata.include_appearance = true;
+    advdata.flags              = BLE_GAP_ADV_FLAGS_LE_ONLY_GENERAL_DISC_MODE;
+
+    ble_advdata_t * p_ids = (p_manuf == NULL) ? &srdata : &advdata;
+    p_ids->name_type               = BLE_ADVDATA_FULL_NAME;
+    p_ids->uuids_complete.uuid_cnt = ARRAY_SIZE(m_adv_uuids);
+    p_ids->uuids_complete.p_uuids  = m_adv_uuids;
+
+    srdata.p_manuf_specific_data = p_manuf;
+
+    err_code = ble_advdata_encode(&advdata, m_advdata_buff[index], &advdata_len);
+    if (err_code != NRF_SUCCESS)
+    {
+        return err_code;
+    }
+    err_code = ble_advdata_encode(&srdata, m_srdata_buff[index], &srdata_len);
+    if (err_code != NRF_SUCCESS)
+    {
+        return err_code;
+    }
+
+    m_adv_data_enc.adv_data.p_data      = m_advdata_buff[index];
+    m_adv_data_enc.adv_data.len         = advdata_len;
+    m_adv_data_enc.scan_rsp_data.p_data = m_srdata_buff[index];
+    m_adv_data_enc.scan_rsp_data.len    = srdata_len;
+    return NRF_SUCCESS;
+}
+
 /**@brief Advertising functionality initialization.
  *
  * @details Encodes the required advertising data and passes it to the stack.
@@ -462,52 +758,70 @@ void conn_params_init(void)
 void advertising_init(void)
 {
     uint32_t             err_code;
-    ble_advdata_t        advdata;
-    ble_gap_adv_data_t   advdata_enc;
     ble_gap_adv_params_t adv_params;
-    static uint8_t       advdata_buff[BLE_GAP_ADV_SET_DATA_SIZE_MAX];
-    uint16_t             advdata_buff_len = BLE_GAP_ADV_SET_DATA_SIZE_MAX;
-    uint8_t              flags = BLE_GAP_ADV_FLAGS_LE_ONLY_GENERAL_DISC_MODE;
 
-    ble_uuid_t adv_uuids[] = {
-        {BLE_UUID_FTMS_SERVICE, BLE_UUID_TYPE_BLE},          // ✅ FTMS Service
-        {BLE_UUID_CYCLING_POWER_SERVICE, BLE_UUID_TYPE_BLE}, // ✅ Cycling Power Service
-        {ANT_SCAN_SERVICE_UUID, BLE_UUID_TYPE_BLE} 
-    };
+    memset(&m_adv_data_enc, 0, sizeof(m_adv_data_enc));
 
     // Build and set advertising data.
-    memset(&advdata, 0, sizeof(advdata));
+    m_adv_buff_index = 0;
+    err_code = advertising_data_encode(m_adv_buff_index, NULL);
+    APP_ERROR_CHECK(err_code);
+
+    m_adv_handle = BLE_GAP_ADV_SET_HANDLE_NOT_SET;
+    m_adv_stage = ADV_STAGE_IDLE;
 
-    advdata.name_type               = BLE_ADVDATA_FULL_NAME;
-    advdata.include_appearance      = true;
-    advdata.flags                   = flags;
-    advdata.uuids_complete.uuid_cnt = sizeof(adv_uuids) / sizeof(adv_uuids[0]);
-    advdata.uuids_complete.p_uuids  = adv_uuids;
+    // Initialise advertising parameters, each stage reconfigures them when it starts.
+    advertising_params_get(ADV_STAGE_FAST, &adv_params);
 
-    err_code = ble_advdata_encode(&advdata, advdata_buff, &advdata_buff_len);
+    err_code = sd_ble_gap_adv_set_configure(&m_adv_handle, &m_adv_data_enc, &adv_params);
     APP_ERROR_CHECK(err_code);
 
-    m_adv_handle = BLE_GAP_ADV_SET_HANDLE_NOT_SET;
+    NRF_LOG_INFO("Advertising UUIDs (scan response):");
+    for (int i = 0; i < ARRAY_SIZE(m_adv_uuids); i++) {
+        NRF_LOG_INFO("UUID: 0x%04X", m_adv_uuids[i].uuid);
+    }
+}
+
+/**@brief Set manufacturer specific data in the scan response.
+ *
+ * @details Can be called while advertising. The advertising data is copied to the spare buffer
+ *          so the SoftDevice never sees a buffer change underneath it.
+ */
+void advertising_set_manuf_data(uint16_t company_id, uint8_t * p_data, uint8_t len)
+{
+    uint32_t                 err_code;
+    ble_advdata_manuf_data_t manuf_data;
+    uint8_t                  next = m_adv_buff_index ^ 1;
 
-    memset(&advdata_enc, 0, sizeof(advdata_enc));
+    if (m_adv_handle == BLE_GAP_ADV_SET_HANDLE_NOT_SET)
+    {
+        return;
+    }
 
-    advdata_enc.adv_data.p_data = advdata_buff;
-    advdata_enc.adv_data.len    = advdata_buff_len;
+    manuf_data.company_identifier = company_id;
+    manuf_data.data.p_data        = p_data;
+    manuf_data.data.size          = len;
 
-    // Initialise advertising parameters (used when starting advertising).
-    memset(&adv_params, 0, sizeof(adv_params));
+    err_code = advertising_data_encode(next, &manuf_data);
+    if (err_code != NRF_SUCCESS)
+    {
+        NRF_LOG_WARNING("⚠️ Scan response encode failed: 0x%08X", err_code);
+        return;
+    }
 
-    adv_params.primary_phy     = BLE_GAP_PHY_1MBPS;
-    adv_params.properties.type = BLE_GAP_ADV_TYPE_CONNECTABLE_SCANNABLE_UNDIRECTED;
-    adv_params.filter_policy   = BLE_GAP_ADV_FP_ANY;
-    adv_params.interval        = APP_ADV_INTERVAL;
-    adv_params.duration        = BLE_GAP_ADV_TIMEOUT_GENERAL_UNLIMITED;
-    
-    err_code = sd_ble_gap_adv_set_configure(&m_adv_handle, &advdata_enc, &adv_params);
-    APP_ERROR_CHECK(err_code);
+    // Directed advertising has no data, the next stage configures the new buffers
+    if (m_adv_stage == ADV_STAGE_DIRECTED)
+    {
+        m_adv_buff_index = next;
+        return;
+    }
 
-    NRF_LOG_INFO("Advertising UUIDs:");
-    for (int i = 0; i < advdata.uuids_complete.uuid_cnt; i++) {
-        NRF_LOG_INFO("UUID: 0x%04X", advdata.uuids_complete.p_uuids[i].uuid);
+    err_code = sd_ble_gap_adv_set_configure(&m_adv_handle, &m_adv_data_enc, NULL);
+    if (err_code != NRF_SUCCESS)
+    {
+        NRF_LOG_WARNING("⚠️ Failed to update scan response: 0x%08X", err_code);
+        return;
     }
-}
\ No newline at end of file
+
+    m_adv_buff_index = next;
+}
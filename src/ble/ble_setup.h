@@ -27,12 +27,25 @@ extern bool ble_shutdown_timer_running;
 extern void ble_shutdown_timer_handler(void *p_context);
 extern void stop_ble_advertising(void);
 
+/**@brief Start advertising, directed to the last central first, then to bonded centrals, then fast, then slow.
+ */
 void start_ble_advertising(void);
+
+/**@brief Go back to fast advertising if the fast period is over, e.g. when data appears.
+ */
+void advertising_fast_restart(void);
 void softdevice_setup(void);
 void services_init(void);
+
+/**@brief Add the services that depend on the stored configuration, call once FDS is ready. */
+void services_config_init(void);
 void conn_params_init(void);
 void advertising_init(void);
 
+/**@brief Set manufacturer specific data in the scan response, can be called while advertising.
+ */
+void advertising_set_manuf_data(uint16_t company_id, uint8_t * p_data, uint8_t len);
+
 /**@brief Initializes GAP parameters including device name, appearance, and connection parameters.
  */
 void gap_params_init(void);
@@ -0,0 +1,73 @@
+/**
+ * @file boot_profile.c
+ * @brief Implementation of the Boot Phase Timestamps
+ */
+
+#include "includes/boot_profile.h"
+#include "includes/diagnostics.h"
+#include "app_timer.h"
+#include "includes/timer_ticks.h"
+#include "app_util_platform.h"
+#include "nrf_log.h"
+
+// The 24-bit RTC wraps after 1024 s, later phases fall back to the uptime seconds
+#define RTC_VALID_S  1000
+
+static uint32_t m_phase_ms[BOOT_PHASE_COUNT];
+static uint32_t m_marked = 0;  // Bit per phase
+
+static const char * const m_phase_names[BOOT_PHASE_COUNT] = {
+    [BOOT_PHASE_TIMERS]         = "timers",
+    [BOOT_PHASE_SOFTDEVICE]     = "softdevice",
+    [BOOT_PHASE_FDS_STARTED]    = "fds started",
+    [BOOT_PHASE_GATT_TABLE]     = "gatt table",
+    [BOOT_PHASE_FDS_READY]      = "fds ready",
+    [BOOT_PHASE_ADV_INIT]       = "adv init",
+    [BOOT_PHASE_SOURCE_STARTED] = "source started",
+    [BOOT_PHASE_FIRST_ADV]      = "first adv",
+    [BOOT_PHASE_FIRST_DATA]     = "first data",
+    [BOOT_PHASE_FIRST_WATT]     = "first watt",
+};
+
+void boot_profile_mark(boot_phase_t phase) {
+    if (phase >= BOOT_PHASE_COUNT || (m_marked & (1UL << phase))) {
+        return;
+    }
+
+    uint32_t uptime_s = diagnostics_uptime_s();
+    uint32_t ms = (uptime_s < RTC_VALID_S) ? TICKS_TO_MS(app_timer_cnt_get()) : uptime_s * 1000;
+    bool first = false;
+
+    CRITICAL_REGION_ENTER();
+    if (!(m_marked & (1UL << phase))) {
+        m_phase_ms[phase] = ms;
+        m_marked |= (1UL << phase);
+        first = true;
+    }
+    CRITICAL_REGION_EXIT();
+
+    if (first && (phase >= BOOT_PHASE_FIRST_ADV)) {
+        NRF_LOG_INFO("⏱️ Boot: %s after %d ms", m_phase_names[phase], ms);
+    }
+}
+
+uint32_t boot_profile_ms(boot_phase_t phase) {
+    if (phase >= BOOT_PHASE_COUNT || !(m_marked & (1UL << phase))) {
+        return BOOT_PROFILE_NOT_REACHED;
+    }
+    return m_phase_ms[phase];
+}
+
+void boot_profile_log(void) {
+    uint32_t prev_ms = 0;
+
+    for (uint8_t phase = 0; phase < BOOT_PHASE_COUNT; phase++) {
+        uint32_t ms = boot_profile_ms((boot_phase_t)phase);
+        if (ms == BOOT_PROFILE_NOT_REACHED) {
+            NRF_LOG_INFO("⏱️ Boot: %s not reached", m_phase_names[phase]);
+            continue;
+        }
+        NRF_LOG_INFO("⏱️ Boot: %s at %d ms (+%d)", m_phase_names[phase], ms, ms - prev_ms);
+        prev_ms = ms;
+    }
+}
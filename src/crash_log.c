@@ -0,0 +1,206 @@
+/**
+ * @file crash_log.c
+ * @brief Implementation of the Crash Record in No-Init RAM
+ */
+
+#include "includes/crash_log.h"
+#include <stddef.h>
+#include <string.h>
+#include "includes/diagnostics.h"
+#include "includes/trace_log.h"
+#include "app_error.h"
+#include "app_util_platform.h"
+#include "nrf_sdm.h"
+#include "nrf.h"
+#include "nrf_log.h"
+#include "nrf_log_ctrl.h"
+
+#define CRASH_LOG_MAGIC 0xC0A5C0DE
+
+typedef struct {
+    uint32_t magic;
+    uint32_t cause;
+    uint32_t pc;
+    uint32_t lr;
+    uint32_t error_code;
+    uint32_t uptime_s;
+    uint32_t line;
+    char file[CRASH_LOG_FILE_LEN];
+    trace_log_entry_t events[CRASH_LOG_TRACE_EVENTS];
+    uint32_t checksum;
+} crash_record_t;
+
+// Placed in its own RAM region by the linker script, below what the bootloader uses
+static crash_record_t m_noinit_record __attribute__((section(".app_noinit")));
+
+static crash_record_t m_last_record;  // Record of the previous run, cause NONE if it left none
+
+/**
+ * @brief Checksum over everything before the checksum field
+ */
+static uint32_t record_checksum(const crash_record_t *p_record) {
+    const uint32_t *p_word = (const uint32_t *)p_record;
+    uint32_t sum = 0;
+
+    for (uint32_t i = 0; i < offsetof(crash_record_t, checksum) / sizeof(uint32_t); i++) {
+        sum = (sum << 1 | sum >> 31) + p_word[i];
+    }
+    return ~sum;
+}
+
+void crash_log_init(void) {
+    if (m_noinit_record.magic == CRASH_LOG_MAGIC &&
+        m_noinit_record.checksum == record_checksum(&m_noinit_record)) {
+        m_last_record = m_noinit_record;
+        m_last_record.file[CRASH_LOG_FILE_LEN - 1] = '\0';
+
+        NRF_LOG_WARNING("💥 Last reset: cause %u, error 0x%08X at %s:%u",
+                        m_last_record.cause, m_last_record.error_code,
+                        m_last_record.file, m_last_record.line);
+        NRF_LOG_WARNING("💥 PC 0x%08X, LR 0x%08X, uptime %u s",
+                        m_last_record.pc, m_last_record.lr, m_last_record.uptime_s);
+    } else {
+        memset(&m_last_record, 0, sizeof(m_last_record));
+    }
+
+    memset(&m_noinit_record, 0, sizeof(m_noinit_record));
+}
+
+void crash_log_record(crash_cause_t cause, uint32_t pc, uint32_t lr, uint32_t error_code,
+                      const char *p_file, uint32_t line) {
+    crash_record_t *p_record = &m_noinit_record;
+
+    p_record->cause = cause;
+    p_record->pc = pc;
+    p_record->lr = lr;
+    p_record->error_code = error_code;
+    p_record->line = line;
+
+    p_record->uptime_s = diagnostics_uptime_s();
+
+    // Keep the end of the path, it holds the file name
+    memset(p_record->file, 0, sizeof(p_record->file));
+    if (p_file != NULL) {
+        size_t len = strlen(p_file);
+        const char *p_tail = (len >= CRASH_LOG_FILE_LEN) ? &p_file[len - (CRASH_LOG_FILE_LEN - 1)] : p_file;
+        strncpy(p_record->file, p_tail, CRASH_LOG_FILE_LEN - 1);
+    }
+
+    memset(p_record->events, 0, sizeof(p_record->events));
+#if TRACE_LOG_ENABLED
+    const trace_log_t *p_trace = trace_log_get();
+    uint32_t count = (p_trace->next < CRASH_LOG_TRACE_EVENTS) ? p_trace->next : CRASH_LOG_TRACE_EVENTS;
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t seq = p_trace->next - count + i;
+        p_record->events[i] = p_trace->entries[seq & (TRACE_LOG_ENTRIES - 1)];
+    }
+#endif
+
+    p_record->magic = CRASH_LOG_MAGIC;
+    p_record->checksum = record_checksum(p_record);
+}
+
+bool crash_log_has_record(void) {
+    return m_last_record.cause != CRASH_CAUSE_NONE;
+}
+
+/**
+ * @brief Store a little-endian uint32
+ */
+static uint8_t put_u32(uint8_t *p_buf, uint32_t value) {
+    p_buf[0] = (uint8_t)(value & 0xFF);
+    p_buf[1] = (uint8_t)((value >> 8) & 0xFF);
+    p_buf[2] = (uint8_t)((value >> 16) & 0xFF);
+    p_buf[3] = (uint8_t)((value >> 24) & 0xFF);
+    return 4;
+}
+
+uint16_t crash_log_encode(uint8_t *p_buf) {
+    const crash_record_t *p_record = &m_last_record;
+    uint16_t len = 0;
+
+    len += put_u32(&p_buf[len], p_record->cause);
+    len += put_u32(&p_buf[len], diagnostics_reset_reason());
+    len += put_u32(&p_buf[len], p_record->pc);
+    len += put_u32(&p_buf[len], p_record->lr);
+    len += put_u32(&p_buf[len], p_record->error_code);
+    len += put_u32(&p_buf[len], p_record->uptime_s);
+    len += put_u32(&p_buf[len], p_record->line);
+    len += put_u32(&p_buf[len], 0);
+
+    memcpy(&p_buf[len], p_record->file, CRASH_LOG_FILE_LEN);
+    len += CRASH_LOG_FILE_LEN;
+
+    for (uint8_t i = 0; i < CRASH_LOG_TRACE_EVENTS; i++) {
+        len += put_u32(&p_buf[len], p_record->events[i].ticks);
+        len += put_u32(&p_buf[len], p_record->events[i].id);
+        len += put_u32(&p_buf[len], p_record->events[i].args[0]);
+        len += put_u32(&p_buf[len], p_record->events[i].args[1]);
+    }
+    return len;
+}
+
+/**
+ * @brief Replaces the weak SDK handler, records the fault before the usual reset
+ */
+void app_error_fault_handler(uint32_t id, uint32_t pc, uint32_t info) {
+    __disable_irq();
+
+    switch (id) {
+        case NRF_FAULT_ID_SD_ASSERT:
+            crash_log_record(CRASH_CAUSE_SD_ASSERT, pc, 0, 0, NULL, 0);
+            break;
+
+        case NRF_FAULT_ID_SDK_ASSERT: {
+            assert_info_t const *p_info = (assert_info_t const *)info;
+            crash_log_record(CRASH_CAUSE_APP_ERROR, pc, 0, NRF_FAULT_ID_SDK_ASSERT,
+                             (const char *)p_info->p_file_name, p_info->line_num);
+            break;
+        }
+
+        case NRF_FAULT_ID_SDK_ERROR: {
+            error_info_t const *p_info = (error_info_t const *)info;
+            crash_log_record(CRASH_CAUSE_APP_ERROR, pc, 0, p_info->err_code,
+                             (const char *)p_info->p_file_name, p_info->line_num);
+            break;
+        }
+
+        default:
+            crash_log_record(CRASH_CAUSE_APP_ERROR, pc, 0, id, NULL, 0);
+            break;
+    }
+
+    NRF_LOG_FINAL_FLUSH();
+    NRF_LOG_ERROR("💥 Fatal error 0x%08X at PC 0x%08X", id, pc);
+
+    NRF_BREAKPOINT_COND;
+#ifndef DEBUG
+    NVIC_SystemReset();
+#else
+    app_error_save_and_stop(id, pc, info);
+#endif
+}
+
+/**
+ * @brief Second half of the HardFault handler, gets the stacked exception frame
+ */
+__attribute__((used)) void crash_log_hardfault(uint32_t *p_stack) {
+    // Frame: R0, R1, R2, R3, R12, LR, PC, xPSR
+    crash_log_record(CRASH_CAUSE_HARDFAULT, p_stack[6], p_stack[5], SCB->CFSR, NULL, 0);
+
+    NRF_BREAKPOINT_COND;
+    NVIC_SystemReset();
+}
+
+/**
+ * @brief Replaces the default handler, which spins until the watchdog or a power cycle
+ */
+__attribute__((naked)) void HardFault_Handler(void) {
+    __asm volatile(
+        "tst lr, #4             \n"
+        "ite eq                 \n"
+        "mrseq r0, msp          \n"
+        "mrsne r0, psp          \n"
+        "b crash_log_hardfault  \n"
+    );
+}
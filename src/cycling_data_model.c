@@ -5,34 +5,27 @@
 
 #include "includes/cycling_data_model.h"
 #include <string.h>
+#include "includes/data_bus.h"
+#include "includes/ride_stats.h"
+#include "includes/virtual_speed.h"
+#include "includes/latency_trace.h"
+#include "includes/profiler.h"
 #include "nrf_log.h"
 
-// Moving average buffer size
-#define MOVING_AVG_SIZE 6
-
-// Callback for data updates
-static void (*data_update_callback)(cycling_data_t data) = NULL;
-
 // Data model
-static cycling_data_t cycling_data;
-
-// Moving average buffers
-static uint16_t power_buffer[MOVING_AVG_SIZE] = {0};
-static uint8_t cadence_buffer[MOVING_AVG_SIZE] = {0};
-static uint8_t buffer_index = 0;
-static bool buffer_filled = false;
+static cycling_data_pipeline_t m_pipeline;
 
 /**
  * @brief Calculate moving average for power
  * 
  * @return uint16_t The moving average power
  */
-static uint16_t calculate_moving_avg_power(void) {
+static uint16_t calculate_moving_avg_power(const cycling_data_pipeline_t *p_pipeline) {
     uint32_t sum = 0;
-    for (uint8_t i = 0; i < MOVING_AVG_SIZE; i++) {
-        sum += power_buffer[i];
+    for (uint8_t i = 0; i < CYCLING_DATA_MOVING_AVG_SIZE; i++) {
+        sum += p_pipeline->power_buffer[i];
     }
-    return (uint16_t)(sum / MOVING_AVG_SIZE);
+    return (uint16_t)(sum / CYCLING_DATA_MOVING_AVG_SIZE);
 }
 
 /**
@@ -40,87 +33,92 @@ static uint16_t calculate_moving_avg_power(void) {
  * 
  * @return uint8_t The moving average cadence
  */
-static uint8_t calculate_moving_avg_cadence(void) {
+static uint8_t calculate_moving_avg_cadence(const cycling_data_pipeline_t *p_pipeline) {
     uint32_t sum = 0;
-    for (uint8_t i = 0; i < MOVING_AVG_SIZE; i++) {
-        sum += cadence_buffer[i];
+    for (uint8_t i = 0; i < CYCLING_DATA_MOVING_AVG_SIZE; i++) {
+        sum += p_pipeline->cadence_buffer[i];
     }
-    return (uint8_t)(sum / MOVING_AVG_SIZE);
+    return (uint8_t)(sum / CYCLING_DATA_MOVING_AVG_SIZE);
 }
 
-bool cycling_data_init(void) {
-    // Initialize the data model
-    memset(&cycling_data, 0, sizeof(cycling_data_t));
-    cycling_data.data_available = false;
-    
-    // Initialize buffers
-    memset(power_buffer, 0, sizeof(power_buffer));
-    memset(cadence_buffer, 0, sizeof(cadence_buffer));
-    buffer_index = 0;
-    buffer_filled = false;
-    
-    NRF_LOG_INFO("Cycling Data Model: Initialized");
-    
-    return true;
+void cycling_data_pipeline_reset(cycling_data_pipeline_t *p_pipeline) {
+    memset(p_pipeline, 0, sizeof(cycling_data_pipeline_t));
+    p_pipeline->data.data_available = false;
 }
 
-void cycling_data_update(uint16_t power_watts, uint8_t cadence_rpm) {
+void cycling_data_pipeline_update(cycling_data_pipeline_t *p_pipeline, uint16_t power_watts, uint8_t cadence_rpm) {
+    cycling_data_t *p_data = &p_pipeline->data;
+
     // Store raw values
-    cycling_data.instantaneous_power = power_watts;
-    cycling_data.instantaneous_cadence = cadence_rpm;
+    p_data->instantaneous_power = power_watts;
+    p_data->instantaneous_cadence = cadence_rpm;
     
     // Store in moving average buffers
-    power_buffer[buffer_index] = power_watts;
-    cadence_buffer[buffer_index] = cadence_rpm;
+    p_pipeline->power_buffer[p_pipeline->buffer_index] = power_watts;
+    p_pipeline->cadence_buffer[p_pipeline->buffer_index] = cadence_rpm;
     
     // Update buffer index and filled flag
-    buffer_index = (buffer_index + 1) % MOVING_AVG_SIZE;
-    if (buffer_index == 0) {
-        buffer_filled = true;
+    p_pipeline->buffer_index = (p_pipeline->buffer_index + 1) % CYCLING_DATA_MOVING_AVG_SIZE;
+    if (p_pipeline->buffer_index == 0) {
+        p_pipeline->buffer_filled = true;
     }
     
     // Calculate and update averages
-    if (buffer_filled) {
-        cycling_data.average_power = calculate_moving_avg_power();
-        cycling_data.average_cadence = calculate_moving_avg_cadence();
+    if (p_pipeline->buffer_filled) {
+        p_data->average_power = calculate_moving_avg_power(p_pipeline);
+        p_data->average_cadence = calculate_moving_avg_cadence(p_pipeline);
     } else {
         // Use instantaneous values until buffer is filled
-        cycling_data.average_power = power_watts;
-        cycling_data.average_cadence = cadence_rpm;
+        p_data->average_power = power_watts;
+        p_data->average_cadence = cadence_rpm;
     }
     
     // Mark data as available
-    cycling_data.data_available = true;
+    p_data->data_available = true;
+}
+
+bool cycling_data_init(void) {
+    // Initialize the data model and buffers
+    cycling_data_pipeline_reset(&m_pipeline);
+
+    // Statistics of this session, FDS is ready at this point
+    ride_stats_init();
+
+    // Config is loaded, build the power to speed table
+    virtual_speed_init();
+    
+    NRF_LOG_INFO("Cycling Data Model: Initialized");
+    
+    return true;
+}
+
+void cycling_data_update(uint16_t power_watts, uint8_t cadence_rpm, uint32_t sample_ticks) {
+    PROFILE_BEGIN(PROFILE_CYCLING_UPDATE);
+
+    cycling_data_pipeline_update(&m_pipeline, power_watts, cadence_rpm);
+    ride_stats_update(power_watts);
     
     NRF_LOG_DEBUG("Cycling Data: Power=%d W (avg=%d W), Cadence=%d RPM (avg=%d RPM)", 
-                 cycling_data.instantaneous_power, 
-                 cycling_data.average_power,
-                 cycling_data.instantaneous_cadence,
-                 cycling_data.average_cadence);
+                 m_pipeline.data.instantaneous_power, 
+                 m_pipeline.data.average_power,
+                 m_pipeline.data.instantaneous_cadence,
+                 m_pipeline.data.average_cadence);
     
-    // Notify callback if registered
-    if (data_update_callback != NULL) {
-        data_update_callback(cycling_data);
-    }
+    latency_trace_model(sample_ticks);
+
+    // Notify all subscribers
+    data_bus_publish_cycling(&m_pipeline.data, sample_ticks);
+
+    PROFILE_END(PROFILE_CYCLING_UPDATE);
 }
 
-cycling_data_t cycling_data_get(void) {
-    return cycling_data;
+const cycling_data_t* cycling_data_get(void) {
+    return &m_pipeline.data;
 }
 
 void cycling_data_reset(void) {
-    memset(&cycling_data, 0, sizeof(cycling_data_t));
-    cycling_data.data_available = false;
-    
-    memset(power_buffer, 0, sizeof(power_buffer));
-    memset(cadence_buffer, 0, sizeof(cadence_buffer));
-    buffer_index = 0;
-    buffer_filled = false;
+    cycling_data_pipeline_reset(&m_pipeline);
     
     NRF_LOG_INFO("Cycling Data Model: Reset");
 }
 
-void cycling_data_register_callback(void (*callback)(cycling_data_t data)) {
-    data_update_callback = callback;
-    NRF_LOG_INFO("Cycling Data Model: Callback registered");
-} 
\ No newline at end of file
@@ -0,0 +1,152 @@
+/**
+ * @file data_bus.c
+ * @brief Implementation of the Cycling Data Bus
+ */
+
+#include "includes/data_bus.h"
+#include <string.h>
+#include "app_timer.h"
+#include "includes/timer_ticks.h"
+#include "includes/deadline_timer.h"
+#include "app_error.h"
+#include "nrf_log.h"
+
+#define FLUSH_SLACK_MS 10  // Rate-limited deliveries may be a little late
+
+/**
+ * @brief One subscriber slot
+ */
+typedef struct {
+    data_bus_handler_t handler;
+    uint8_t topic_mask;
+    uint8_t pending;            /**< Topics updated but not yet delivered (rate limited) */
+    uint16_t min_interval_ms;
+    uint32_t last_call_ticks;
+} data_bus_subscriber_t;
+
+static data_bus_subscriber_t m_subscribers[DATA_BUS_MAX_SUBSCRIBERS];
+static data_bus_snapshot_t m_snapshot;
+
+static deadline_timer_id_t m_flush_timer;
+static bool m_flush_timer_created = false;
+
+/**
+ * @brief Call every subscriber with pending topics whose interval has passed
+ *
+ * Subscribers still inside their interval keep their topics pending and the
+ * flush timer is armed for the earliest of them, so the last update of a
+ * burst is delivered even when nothing is published afterwards.
+ */
+static void deliver(void) {
+    uint32_t now = app_timer_cnt_get();
+    uint32_t next_ms = UINT32_MAX;
+
+    for (uint8_t i = 0; i < DATA_BUS_MAX_SUBSCRIBERS; i++) {
+        data_bus_subscriber_t *p_sub = &m_subscribers[i];
+
+        if (p_sub->handler == NULL || p_sub->pending == 0) continue;
+
+        if (p_sub->min_interval_ms != 0) {
+            uint32_t elapsed_ms = TICKS_TO_MS(app_timer_cnt_diff_compute(now, p_sub->last_call_ticks));
+            if (elapsed_ms < p_sub->min_interval_ms) {
+                uint32_t wait_ms = p_sub->min_interval_ms - elapsed_ms;
+                next_ms = (wait_ms < next_ms) ? wait_ms : next_ms;
+                continue;  // Merged into the next call
+            }
+        }
+
+        uint8_t delivered = p_sub->pending;
+        p_sub->pending = 0;
+        p_sub->last_call_ticks = now;
+        p_sub->handler(&m_snapshot, delivered);
+    }
+
+    if (next_ms != UINT32_MAX) {
+        deadline_timer_start(m_flush_timer, next_ms, NULL);
+    }
+}
+
+static void flush_timer_handler(void *p_context) {
+    deliver();
+}
+
+/**
+ * @brief Mark topics as updated and deliver them
+ */
+static void publish(uint8_t topics) {
+    m_snapshot.version++;
+    m_snapshot.timestamp_ticks = app_timer_cnt_get();
+
+    for (uint8_t i = 0; i < DATA_BUS_MAX_SUBSCRIBERS; i++) {
+        if (m_subscribers[i].handler != NULL) {
+            m_subscribers[i].pending |= (topics & m_subscribers[i].topic_mask);
+        }
+    }
+
+    deliver();
+}
+
+bool data_bus_subscribe(data_bus_handler_t handler, uint8_t topic_mask, uint16_t min_interval_ms) {
+    data_bus_subscriber_t *p_free = NULL;
+
+    if (!m_flush_timer_created) {
+        uint32_t err_code = deadline_timer_create(&m_flush_timer, DEADLINE_TIMER_MODE_SINGLE_SHOT,
+                                                  FLUSH_SLACK_MS, flush_timer_handler);
+        APP_ERROR_CHECK(err_code);
+        m_flush_timer_created = true;
+    }
+
+    for (uint8_t i = 0; i < DATA_BUS_MAX_SUBSCRIBERS; i++) {
+        if (m_subscribers[i].handler == handler) {
+            p_free = &m_subscribers[i];  // Already subscribed, update the filter
+            break;
+        }
+        if (m_subscribers[i].handler == NULL && p_free == NULL) {
+            p_free = &m_subscribers[i];
+        }
+    }
+
+    if (p_free == NULL) {
+        NRF_LOG_ERROR("Data Bus: No free subscriber slot");
+        return false;
+    }
+
+    p_free->handler = handler;
+    p_free->topic_mask = topic_mask;
+    p_free->min_interval_ms = min_interval_ms;
+    p_free->pending = 0;
+    p_free->last_call_ticks = app_timer_cnt_get();
+    return true;
+}
+
+void data_bus_unsubscribe(data_bus_handler_t handler) {
+    for (uint8_t i = 0; i < DATA_BUS_MAX_SUBSCRIBERS; i++) {
+        if (m_subscribers[i].handler == handler) {
+            memset(&m_subscribers[i], 0, sizeof(m_subscribers[i]));
+        }
+    }
+}
+
+void data_bus_publish_cycling(const cycling_data_t *p_data, uint32_t sample_ticks) {
+    m_snapshot.cycling = *p_data;
+    m_snapshot.sample_ticks = sample_ticks;
+    publish(DATA_BUS_TOPIC_POWER | DATA_BUS_TOPIC_CADENCE);
+}
+
+void data_bus_publish_heart_rate(uint8_t bpm) {
+    m_snapshot.heart_rate_bpm = bpm;
+    publish(DATA_BUS_TOPIC_HEART_RATE);
+}
+
+void data_bus_publish_speed(uint16_t speed_kmh_x100) {
+    m_snapshot.speed_kmh_x100 = speed_kmh_x100;
+    publish(DATA_BUS_TOPIC_SPEED);
+}
+
+void data_bus_publish_status(uint8_t status) {
+    if (m_snapshot.status == status) {
+        return;
+    }
+    m_snapshot.status = status;
+    publish(DATA_BUS_TOPIC_STATUS);
+}
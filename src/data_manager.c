@@ -5,39 +5,306 @@
 
 #include "includes/data_manager.h"
 #include "includes/cycling_data_model.h"
+#include "includes/data_bus.h"
+#include "includes/sample_filter.h"
 #include "ant/ant_data_source.h"
+#include "ant/ant_aggregator.h"
+#include "ble/ble_central_data_source.h"
 #include "keiser/keiser_m3i_data_source.h"
+#include "sensors/reed_data_source.h"
 #include "includes/ble_bridge.h"
+#include "includes/led_sequencer.h"
+#include "includes/boot_profile.h"
+#include "ble_custom_config.h"
+#include "app_timer.h"
+#include "includes/timer_ticks.h"
 #include "nrf_log.h"
 #include "boards.h"
-// Forward declare the proprietary BLE source interface (will be implemented later)
-extern const data_source_interface_t* prop_ble_data_source_get_interface(void);
+#include <string.h>
 
-// Currently active data source
+/**
+ * @brief One concurrently running data source
+ */
+typedef struct {
+    data_source_type_t type;                  /**< DATA_SOURCE_NONE for a free slot */
+    const data_source_interface_t *p_iface;
+    uint8_t priority;                         /**< Lower wins while the source is healthy */
+    uint8_t fields;                           /**< DATA_BUS_TOPIC_POWER / _CADENCE the source provides */
+    uint8_t quality;                          /**< 0..DATA_MANAGER_QUALITY_MAX, see update_quality() */
+    bool has_data;
+    uint16_t power;                           /**< Last raw sample */
+    uint8_t cadence;
+    uint32_t last_rx_ticks;
+    bool has_heart_rate;                      /**< Set by data_manager_report_heart_rate(), 0 BPM clears it */
+    uint8_t heart_rate;
+    uint32_t heart_rate_rx_ticks;
+    sample_filter_t filter;                   /**< Applied to every raw sample before it is used */
+} data_manager_source_t;
+
+static data_manager_source_t m_sources[DATA_MANAGER_MAX_SOURCES];
+
+// Primary source, selects the operating mode (gym, aggregator, single rider)
 static data_source_type_t m_active_source_type = DATA_SOURCE_NONE;
-static const data_source_interface_t* m_active_source = NULL;
 
-// Callback function for data source updates
-static void data_source_callback(uint16_t power, uint8_t cadence)
+// Slots currently selected for each field, DATA_MANAGER_MAX_SOURCES if none
+static uint8_t m_power_slot = DATA_MANAGER_MAX_SOURCES;
+static uint8_t m_cadence_slot = DATA_MANAGER_MAX_SOURCES;
+static uint8_t m_heart_rate_slot = DATA_MANAGER_MAX_SOURCES;
+
+/**
+ * @brief Fields a source type provides
+ */
+static uint8_t fields_for_type(data_source_type_t type)
+{
+    switch (type)
+    {
+        case DATA_SOURCE_ANT_PLUS:
+        case DATA_SOURCE_ANT_AGGREGATOR:
+            return DATA_BUS_TOPIC_POWER | DATA_BUS_TOPIC_CADENCE;
+
+        case DATA_SOURCE_KEISER_M3I:
+        case DATA_SOURCE_KEISER_GYM:
+        case DATA_SOURCE_BLE_PROPRIETARY:
+            return DATA_BUS_TOPIC_POWER | DATA_BUS_TOPIC_CADENCE | DATA_BUS_TOPIC_HEART_RATE;
+
+        case DATA_SOURCE_REED:
+            return DATA_BUS_TOPIC_CADENCE;
+
+        default:
+            return 0;
+    }
+}
+
+/**
+ * @brief Whether a source type drives the SoftDevice scanner
+ *
+ * There is one scanner and one whitelist, and each of these sources sets
+ * them up for its own target, so only one of them may run at a time.
+ */
+static bool uses_scanner(data_source_type_t type)
+{
+    return type == DATA_SOURCE_KEISER_M3I ||
+           type == DATA_SOURCE_KEISER_GYM ||
+           type == DATA_SOURCE_BLE_PROPRIETARY;
+}
+
+// Filter settings per source type. Spikes come from single bad packets,
+// so the radio sources only drop isolated spikes, which delays a jump of
+// more than 200 W or 30 RPM by one sample and passes everything else at
+// once. Keiser broadcasts are noisier and get a median. Reed cadence is
+// measured over whole seconds in hardware and only needs the range check.
+// Power is not slew limited, a sprint may rise faster than any fixed rate.
+// Settings stored through the device config replace them for the main source.
+static const sample_filter_config_t m_filter_radio = {
+    .power   = { .mode = SAMPLE_FILTER_SPIKE, .max_value = 3000, .max_rise_per_s = 0,   .min_deviation = 200 },
+    .cadence = { .mode = SAMPLE_FILTER_SPIKE, .max_value = 200,  .max_rise_per_s = 200, .min_deviation = 30 },
+};
+
+static const sample_filter_config_t m_filter_keiser = {
+    .power   = { .mode = SAMPLE_FILTER_MEDIAN3, .max_value = 3000, .max_rise_per_s = 0,   .min_deviation = 40 },
+    .cadence = { .mode = SAMPLE_FILTER_MEDIAN3, .max_value = 200,  .max_rise_per_s = 200, .min_deviation = 10 },
+};
+
+static const sample_filter_config_t m_filter_reed = {
+    .power   = { .mode = SAMPLE_FILTER_OFF, .max_value = 0,   .max_rise_per_s = 0, .min_deviation = 0 },
+    .cadence = { .mode = SAMPLE_FILTER_OFF, .max_value = 200, .max_rise_per_s = 0, .min_deviation = 0 },
+};
+
+/**
+ * @brief Filter settings for a source type
+ */
+static const sample_filter_config_t* filter_config_for_type(data_source_type_t type)
+{
+    if (m_filter_override && type == m_data_source_type) {
+        return &m_filter_config;
+    }
+
+    switch (type)
+    {
+        case DATA_SOURCE_KEISER_M3I:
+        case DATA_SOURCE_KEISER_GYM:
+            return &m_filter_keiser;
+
+        case DATA_SOURCE_REED:
+            return &m_filter_reed;
+
+        case DATA_SOURCE_ANT_PLUS:
+        case DATA_SOURCE_ANT_AGGREGATOR:
+        case DATA_SOURCE_BLE_PROPRIETARY:
+            return &m_filter_radio;
+
+        default:
+            return NULL;
+    }
+}
+
+/**
+ * @brief Track link quality of a source
+ *
+ * Every sample raises the score; a gap longer than the stale time halves it,
+ * so a flapping link has to prove itself again before it is preferred.
+ */
+static void update_quality(data_manager_source_t *p_source, uint32_t now)
+{
+    if (p_source->has_data &&
+        TICKS_TO_MS(app_timer_cnt_diff_compute(now, p_source->last_rx_ticks)) >= DATA_MANAGER_SOURCE_STALE_MS) {
+        p_source->quality /= 2;
+    }
+
+    if (p_source->quality <= DATA_MANAGER_QUALITY_MAX - DATA_MANAGER_QUALITY_STEP) {
+        p_source->quality += DATA_MANAGER_QUALITY_STEP;
+    } else {
+        p_source->quality = DATA_MANAGER_QUALITY_MAX;
+    }
+}
+
+/**
+ * @brief Check if a source may provide a field right now
+ */
+static bool source_usable(const data_manager_source_t *p_source, uint8_t field, uint32_t now)
+{
+    // Heart rate arrives on its own and may be missing while power flows
+    bool is_heart_rate = (field == DATA_BUS_TOPIC_HEART_RATE);
+    bool has_field = is_heart_rate ? p_source->has_heart_rate : p_source->has_data;
+    uint32_t rx_ticks = is_heart_rate ? p_source->heart_rate_rx_ticks : p_source->last_rx_ticks;
+
+    return p_source->type != DATA_SOURCE_NONE &&
+           has_field &&
+           (p_source->fields & field) &&
+           p_source->p_iface->is_active() &&
+           TICKS_TO_MS(app_timer_cnt_diff_compute(now, rx_ticks)) < DATA_MANAGER_SOURCE_STALE_MS;
+}
+
+/**
+ * @brief Select the source for one field
+ *
+ * Sources above the minimum quality are ranked by priority, then quality.
+ * Below that threshold a source is only used when nothing else is left.
+ *
+ * @return Slot index, or DATA_MANAGER_MAX_SOURCES if no source can provide the field
+ */
+static uint8_t select_source(uint8_t field, uint32_t now)
+{
+    uint8_t best = DATA_MANAGER_MAX_SOURCES;
+    bool best_qualified = false;
+
+    for (uint8_t i = 0; i < DATA_MANAGER_MAX_SOURCES; i++)
+    {
+        const data_manager_source_t *p_source = &m_sources[i];
+        if (!source_usable(p_source, field, now)) {
+            continue;
+        }
+
+        bool qualified = p_source->quality >= DATA_MANAGER_MIN_QUALITY;
+        if (best == DATA_MANAGER_MAX_SOURCES ||
+            (qualified && !best_qualified) ||
+            (qualified == best_qualified &&
+             (p_source->priority < m_sources[best].priority ||
+              (p_source->priority == m_sources[best].priority && p_source->quality > m_sources[best].quality))))
+        {
+            best = i;
+            best_qualified = qualified;
+        }
+    }
+
+    return best;
+}
+
+/**
+ * @brief Log field ownership changes
+ */
+static void log_selection(const char *p_field, uint8_t old_slot, uint8_t new_slot)
+{
+    if (old_slot == new_slot) {
+        return;
+    }
+
+    if (new_slot == DATA_MANAGER_MAX_SOURCES) {
+        NRF_LOG_WARNING("⚠️ Data Manager: No source left for %s", p_field);
+    } else {
+        NRF_LOG_INFO("🔀 Data Manager: %s now from source type %d (quality %d)",
+                     p_field, m_sources[new_slot].type, m_sources[new_slot].quality);
+    }
+}
+
+// Fused data update from one source slot
+static void data_source_callback(uint8_t slot, uint16_t power, uint8_t cadence, uint32_t sample_ticks)
 {
-    NRF_LOG_DEBUG("Data Manager: Received data update - Power: %d W, Cadence: %d RPM", power, cadence);
-    
+    data_manager_source_t *p_source = &m_sources[slot];
+    uint32_t now = app_timer_cnt_get();
+
+    NRF_LOG_DEBUG("Data Manager: Received data update from slot %d - Power: %d W, Cadence: %d RPM", slot, power, cadence);
+
+    if (p_source->p_iface->is_active()) {
+        uint32_t dt_ms = p_source->has_data ?
+                         TICKS_TO_MS(app_timer_cnt_diff_compute(sample_ticks, p_source->last_rx_ticks)) : 0;
+        sample_filter_apply(&p_source->filter, &power, &cadence, dt_ms);
+
+        update_quality(p_source, now);
+        p_source->power = power;
+        p_source->cadence = cadence;
+        p_source->last_rx_ticks = sample_ticks;
+        p_source->has_data = true;
+        boot_profile_mark(BOOT_PHASE_FIRST_DATA);
+    } else {
+        // The source reports its link as lost, e.g. zero values after a timeout
+        p_source->quality = 0;
+        p_source->has_data = false;
+        p_source->has_heart_rate = false;
+        sample_filter_reset(&p_source->filter);
+    }
+
+    uint8_t power_slot = select_source(DATA_BUS_TOPIC_POWER, now);
+    uint8_t cadence_slot = select_source(DATA_BUS_TOPIC_CADENCE, now);
+    log_selection("power", m_power_slot, power_slot);
+    log_selection("cadence", m_cadence_slot, cadence_slot);
+    m_power_slot = power_slot;
+    m_cadence_slot = cadence_slot;
+
+    // The power source paces the model so it is fed at one source's rate
+    uint8_t pacing_slot = (power_slot != DATA_MANAGER_MAX_SOURCES) ? power_slot : cadence_slot;
+
+    if (pacing_slot == DATA_MANAGER_MAX_SOURCES) {
+        // Nothing to fail over to, pass the source's own loss indication on as before
+        cycling_data_update(power, cadence, sample_ticks);
+        data_bus_publish_status(0);
+        return;
+    }
+
+    if (pacing_slot != slot) {
+        return;  // Kept as a backup, or only contributes a field read on the pacing sample
+    }
+
+    uint16_t fused_power = (power_slot != DATA_MANAGER_MAX_SOURCES) ? m_sources[power_slot].power : 0;
+    uint8_t fused_cadence = (cadence_slot != DATA_MANAGER_MAX_SOURCES) ? m_sources[cadence_slot].cadence : 0;
+
     // Update cycling data model
-    cycling_data_update(power, cadence);
-    
-    cycling_data_t current_data = cycling_data_get();
-    NRF_LOG_DEBUG("Data Manager: Updated cycling data model - Power: %d W, Cadence: %d RPM", 
-                 current_data.instantaneous_power, current_data.instantaneous_cadence);
+    cycling_data_update(fused_power, fused_cadence, sample_ticks);
+
+    const cycling_data_t *p_current_data = cycling_data_get();
+    NRF_LOG_DEBUG("Data Manager: Updated cycling data model - Power: %d W, Cadence: %d RPM",
+                 p_current_data->instantaneous_power, p_current_data->instantaneous_cadence);
+
+    data_bus_publish_status(DATA_BUS_STATUS_SOURCE_ACTIVE);
 
-    #if defined(DEBUG) && !defined(RELEASE)
-        bsp_board_led_invert(3);       // Toggle LED2
-    #endif
+    LED_SEQ_DEBUG_PLAY(LED_SEQ_DATA);
 
 }
 
+// Data source callbacks carry no context, one trampoline per slot
+static void data_source_callback_0(uint16_t power, uint8_t cadence, uint32_t ticks) { data_source_callback(0, power, cadence, ticks); }
+static void data_source_callback_1(uint16_t power, uint8_t cadence, uint32_t ticks) { data_source_callback(1, power, cadence, ticks); }
+static void data_source_callback_2(uint16_t power, uint8_t cadence, uint32_t ticks) { data_source_callback(2, power, cadence, ticks); }
+
+static const data_update_callback_t m_slot_callbacks[DATA_MANAGER_MAX_SOURCES] = {
+    data_source_callback_0,
+    data_source_callback_1,
+    data_source_callback_2,
+};
+
 /**
  * @brief Get the interface for the specified data source type
- * 
+ *
  * @param type The type of data source to get
  * @return const data_source_interface_t* Pointer to the data source interface, or NULL if not found
  */
@@ -47,49 +314,80 @@ static const data_source_interface_t* data_source_get_interface(data_source_type
     {
         case DATA_SOURCE_ANT_PLUS:
             return ant_data_source_get_interface();
-            
+
         case DATA_SOURCE_KEISER_M3I:
+        case DATA_SOURCE_KEISER_GYM:
             return keiser_m3i_data_source_get_interface();
-            
+
+        case DATA_SOURCE_ANT_AGGREGATOR:
+            return ant_aggregator_get_interface();
+
         case DATA_SOURCE_BLE_PROPRIETARY:
-            // Will be implemented later
-            return NULL;
-            
+            return ble_central_data_source_get_interface();
+
+        case DATA_SOURCE_REED:
+            return reed_data_source_get_interface();
+
         case DATA_SOURCE_NONE:
             return NULL;
-            
+
         default:
             NRF_LOG_ERROR("Data Manager: Unknown data source type: %d", type);
             return NULL;
     }
 }
 
-bool data_manager_init(void) {
-    // Initialize the cycling data model
-    if (!cycling_data_init()) {
-        NRF_LOG_ERROR("Failed to initialize cycling data model");
-        return false;
+/**
+ * @brief Stop all sources and free their slots
+ */
+static void stop_all_sources(void)
+{
+    for (uint8_t i = 0; i < DATA_MANAGER_MAX_SOURCES; i++)
+    {
+        if (m_sources[i].type != DATA_SOURCE_NONE) {
+            m_sources[i].p_iface->stop();
+        }
+        memset(&m_sources[i], 0, sizeof(m_sources[i]));
+        m_sources[i].type = DATA_SOURCE_NONE;
     }
-    
-    NRF_LOG_INFO("Data Manager: Initialized");
-    return true;
+
+    m_power_slot = DATA_MANAGER_MAX_SOURCES;
+    m_cadence_slot = DATA_MANAGER_MAX_SOURCES;
+    m_heart_rate_slot = DATA_MANAGER_MAX_SOURCES;
 }
 
-bool data_manager_set_data_source(data_source_type_t type, uint16_t device_id)
+/**
+ * @brief Initialize and start a source in a free slot
+ */
+static bool start_source(data_source_type_t type, uint16_t device_id, uint8_t priority)
 {
-    NRF_LOG_INFO("Data Manager: Setting data source type: %d", type);
-    
-    // Stop current data source if active
-    if (m_active_source != NULL)
+    uint8_t slot = DATA_MANAGER_MAX_SOURCES;
+
+    for (uint8_t i = 0; i < DATA_MANAGER_MAX_SOURCES; i++)
     {
-        NRF_LOG_INFO("Data Manager: Stopping current data source");
-        m_active_source->stop();
-        m_active_source = NULL;
+        // Sources keep module-level state, each type can only run once
+        if (m_sources[i].type == type) {
+            NRF_LOG_ERROR("Data Manager: Source type %d already running", type);
+            return false;
+        }
+        if (uses_scanner(type) && uses_scanner(m_sources[i].type)) {
+            NRF_LOG_ERROR("Data Manager: Source type %d needs the scanner, type %d already uses it",
+                          type, m_sources[i].type);
+            return false;
+        }
+        if (m_sources[i].type == DATA_SOURCE_NONE && slot == DATA_MANAGER_MAX_SOURCES) {
+            slot = i;
+        }
+    }
+
+    if (slot == DATA_MANAGER_MAX_SOURCES) {
+        NRF_LOG_ERROR("Data Manager: No free source slot");
+        return false;
     }
 
     // Get new data source interface
-    m_active_source = data_source_get_interface(type);
-    if (m_active_source == NULL)
+    const data_source_interface_t *p_iface = data_source_get_interface(type);
+    if (p_iface == NULL)
     {
         NRF_LOG_ERROR("Data Manager: Failed to get data source interface for type: %d", type);
         return false;
@@ -99,57 +397,179 @@ bool data_manager_set_data_source(data_source_type_t type, uint16_t device_id)
     data_source_config_t config = {
         .type = type,
         .device_id = device_id,
-        .data_callback = data_source_callback
+        .data_callback = m_slot_callbacks[slot]
     };
 
+    // Claim the slot first, a source may deliver data from start()
+    memset(&m_sources[slot], 0, sizeof(m_sources[slot]));
+    m_sources[slot].type = type;
+    m_sources[slot].p_iface = p_iface;
+    m_sources[slot].priority = priority;
+    m_sources[slot].fields = fields_for_type(type);
+    sample_filter_init(&m_sources[slot].filter, filter_config_for_type(type));
+
     // Initialize data source
-    if (!m_active_source->init(&config))
+    if (!p_iface->init(&config))
     {
         NRF_LOG_ERROR("Data Manager: Failed to initialize data source");
-        m_active_source = NULL;
+        m_sources[slot].type = DATA_SOURCE_NONE;
         return false;
     }
 
     // Start data source
-    if (!m_active_source->start())
+    if (!p_iface->start())
     {
         NRF_LOG_ERROR("Data Manager: Failed to start data source");
-        m_active_source = NULL;
+        m_sources[slot].type = DATA_SOURCE_NONE;
         return false;
     }
 
+    return true;
+}
+
+bool data_manager_init(void) {
+    // Initialize the cycling data model
+    if (!cycling_data_init()) {
+        NRF_LOG_ERROR("Failed to initialize cycling data model");
+        return false;
+    }
+
+    for (uint8_t i = 0; i < DATA_MANAGER_MAX_SOURCES; i++) {
+        m_sources[i].type = DATA_SOURCE_NONE;
+    }
+
+    NRF_LOG_INFO("Data Manager: Initialized");
+    return true;
+}
+
+bool data_manager_set_data_source(data_source_type_t type, uint16_t device_id)
+{
+    NRF_LOG_INFO("Data Manager: Setting data source type: %d", type);
+
+    // Stop current data sources if active
+    if (m_active_source_type != DATA_SOURCE_NONE)
+    {
+        NRF_LOG_INFO("Data Manager: Stopping current data sources");
+    }
+    stop_all_sources();
+    m_active_source_type = DATA_SOURCE_NONE;
+
+    if (!start_source(type, device_id, 0))
+    {
+        return false;
+    }
+
+    m_active_source_type = type;
     NRF_LOG_INFO("Data Manager: Successfully set and started data source");
     return true;
 }
 
+bool data_manager_add_data_source(data_source_type_t type, uint16_t device_id, uint8_t priority)
+{
+    // Multi-bike modes publish every bike on its own, there is no single rider to fuse
+    if (m_active_source_type == DATA_SOURCE_NONE ||
+        m_active_source_type == DATA_SOURCE_KEISER_GYM ||
+        m_active_source_type == DATA_SOURCE_ANT_AGGREGATOR ||
+        type == DATA_SOURCE_KEISER_GYM ||
+        type == DATA_SOURCE_ANT_AGGREGATOR)
+    {
+        NRF_LOG_WARNING("Data Manager: Source type %d can not be added to mode %d", type, m_active_source_type);
+        return false;
+    }
+
+    if (!start_source(type, device_id, priority))
+    {
+        return false;
+    }
+
+    NRF_LOG_INFO("Data Manager: Added data source type %d with priority %d", type, priority);
+    return true;
+}
+
 data_source_type_t data_manager_get_active_source_type(void) {
     return m_active_source_type;
 }
 
 bool data_manager_start_collection(void) {
-    if (m_active_source == NULL) {
+    if (m_active_source_type == DATA_SOURCE_NONE) {
         NRF_LOG_ERROR("Data Manager: No active data source to start");
         return false;
     }
-    
+
     // Reset the cycling data model
     cycling_data_reset();
-    
+    boot_profile_mark(BOOT_PHASE_SOURCE_STARTED);
+
     NRF_LOG_INFO("Data Manager: Started data collection");
     return true;
 }
 
 void data_manager_stop_collection(void) {
-    if (m_active_source != NULL && m_active_source->is_active()) {
-        m_active_source->stop();
+    bool stopped = false;
+
+    for (uint8_t i = 0; i < DATA_MANAGER_MAX_SOURCES; i++)
+    {
+        if (m_sources[i].type != DATA_SOURCE_NONE && m_sources[i].p_iface->is_active()) {
+            m_sources[i].p_iface->stop();
+            stopped = true;
+        }
+    }
+
+    if (stopped) {
+        data_bus_publish_status(0);
         NRF_LOG_INFO("Data Manager: Stopped data collection");
     }
 }
 
 bool data_manager_is_active(void) {
-    return (m_active_source != NULL && m_active_source->is_active());
+    for (uint8_t i = 0; i < DATA_MANAGER_MAX_SOURCES; i++)
+    {
+        if (m_sources[i].type != DATA_SOURCE_NONE && m_sources[i].p_iface->is_active()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void data_manager_report_heart_rate(data_source_type_t type, uint8_t bpm) {
+    uint8_t slot = DATA_MANAGER_MAX_SOURCES;
+    for (uint8_t i = 0; i < DATA_MANAGER_MAX_SOURCES; i++)
+    {
+        if (m_sources[i].type == type && type != DATA_SOURCE_NONE) {
+            slot = i;
+        }
+    }
+    if (slot == DATA_MANAGER_MAX_SOURCES || !m_sources[slot].p_iface->is_active()) {
+        return;
+    }
+
+    uint32_t now = app_timer_cnt_get();
+    m_sources[slot].has_heart_rate = (bpm != 0);
+    m_sources[slot].heart_rate = bpm;
+    m_sources[slot].heart_rate_rx_ticks = now;
+
+    uint8_t heart_rate_slot = select_source(DATA_BUS_TOPIC_HEART_RATE, now);
+    log_selection("heart rate", m_heart_rate_slot, heart_rate_slot);
+
+    if (heart_rate_slot == slot) {
+        data_bus_publish_heart_rate(bpm);
+    } else if (heart_rate_slot == DATA_MANAGER_MAX_SOURCES && m_heart_rate_slot != DATA_MANAGER_MAX_SOURCES) {
+        data_bus_publish_heart_rate(0);  // The last strap is gone
+    }
+    m_heart_rate_slot = heart_rate_slot;
 }
 
-cycling_data_t data_manager_get_latest_data(void) {
+bool data_manager_get_filter_stats(data_source_type_t type, sample_filter_stats_t *p_stats) {
+    for (uint8_t i = 0; i < DATA_MANAGER_MAX_SOURCES; i++)
+    {
+        if (m_sources[i].type == type && type != DATA_SOURCE_NONE) {
+            *p_stats = m_sources[i].filter.stats;
+            return true;
+        }
+    }
+    return false;
+}
+
+const cycling_data_t* data_manager_get_latest_data(void) {
     return cycling_data_get();
-} 
\ No newline at end of file
+}
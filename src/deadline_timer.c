@@ -0,0 +1,207 @@
+/**
+ * @file deadline_timer.c
+ * @brief Implementation of the Deadline Timer Scheduler
+ */
+
+#include "includes/deadline_timer.h"
+#include "app_timer.h"
+#include "app_error.h"
+#include "app_util_platform.h"
+#include "nrf_log.h"
+
+#define MAX_SLEEP_TICKS  APP_TIMER_TICKS(256000)  // Well inside the 1024 s RTC range, keeps the extended time valid
+#define MINUTE_TICKS     APP_TIMER_TICKS(60000)
+
+typedef struct {
+    deadline_timer_handler_t handler;
+    void *p_context;
+    uint32_t deadline;   // Extended ticks, see now_ticks()
+    uint32_t period;     // Ticks, 0 for single shot
+    uint32_t slack;      // Ticks
+    bool repeated;
+    bool active;
+} deadline_timer_t;
+
+APP_TIMER_DEF(m_wake_timer);
+
+static deadline_timer_t m_timers[DEADLINE_TIMER_MAX];
+static uint8_t m_timer_count = 0;
+
+// 32-bit time extended from the 24-bit RTC, wraps after 72 hours
+static uint32_t m_now = 0;
+static uint32_t m_last_cnt = 0;
+
+static bool m_programmed = false;
+static uint32_t m_programmed_at = 0;
+
+static uint32_t m_minute_start = 0;
+static uint32_t m_wakeups = 0;
+static uint32_t m_expiries = 0;
+static uint32_t m_wakeups_per_min = 0;
+static uint32_t m_expiries_per_min = 0;
+
+/**
+ * @brief Current extended time, call with interrupts masked
+ */
+static uint32_t now_ticks(void) {
+    uint32_t cnt = app_timer_cnt_get();
+    m_now += app_timer_cnt_diff_compute(cnt, m_last_cnt);
+    m_last_cnt = cnt;
+    return m_now;
+}
+
+/**
+ * @brief Whether extended time a is before b
+ */
+static bool before(uint32_t a, uint32_t b) {
+    return (int32_t)(a - b) < 0;
+}
+
+/**
+ * @brief Program the wake timer for the most urgent timer, call with interrupts masked
+ *
+ * @param force Reprogram even when the wake is already early enough
+ */
+static void reschedule(bool force) {
+    uint32_t now = now_ticks();
+    bool any = false;
+    uint32_t wake = 0;
+
+    for (uint8_t i = 0; i < m_timer_count; i++) {
+        if (!m_timers[i].active) continue;
+
+        uint32_t latest = m_timers[i].deadline + m_timers[i].slack;
+        if (!any || before(latest, wake)) {
+            wake = latest;
+            any = true;
+        }
+    }
+
+    if (!any) {
+        if (m_programmed) {
+            (void)app_timer_stop(m_wake_timer);
+            m_programmed = false;
+        }
+        return;
+    }
+
+    // A pending wake that comes earlier just finds nothing due and reschedules
+    if (m_programmed && !force && !before(wake, m_programmed_at)) {
+        return;
+    }
+
+    uint32_t ticks = before(now, wake) ? wake - now : 0;
+    if (ticks > MAX_SLEEP_TICKS) {
+        ticks = MAX_SLEEP_TICKS;
+    }
+    if (ticks < APP_TIMER_MIN_TIMEOUT_TICKS) {
+        ticks = APP_TIMER_MIN_TIMEOUT_TICKS;
+    }
+
+    (void)app_timer_stop(m_wake_timer);
+    uint32_t err_code = app_timer_start(m_wake_timer, ticks, NULL);
+    APP_ERROR_CHECK(err_code);
+
+    m_programmed = true;
+    m_programmed_at = now + ticks;
+}
+
+static void wake_timer_handler(void *p_context) {
+    uint32_t now;
+
+    CRITICAL_REGION_ENTER();
+    m_programmed = false;
+    now = now_ticks();
+    m_wakeups++;
+    if (!before(now, m_minute_start + MINUTE_TICKS)) {
+        m_wakeups_per_min = m_wakeups;
+        m_expiries_per_min = m_expiries;
+        m_wakeups = 0;
+        m_expiries = 0;
+        m_minute_start = now;
+    }
+    CRITICAL_REGION_EXIT();
+
+    for (uint8_t i = 0; i < m_timer_count; i++) {
+        deadline_timer_t *p_timer = &m_timers[i];
+        bool due = false;
+
+        CRITICAL_REGION_ENTER();
+        if (p_timer->active && !before(now, p_timer->deadline)) {
+            due = true;
+            m_expiries++;
+            if (p_timer->repeated) {
+                // Keep the phase, skip periods that were missed entirely
+                p_timer->deadline += p_timer->period;
+                if (!before(now, p_timer->deadline)) {
+                    p_timer->deadline = now + p_timer->period;
+                }
+            } else {
+                p_timer->active = false;
+            }
+        }
+        CRITICAL_REGION_EXIT();
+
+        // The handler may start or stop any timer, this one included
+        if (due) {
+            p_timer->handler(p_timer->p_context);
+        }
+    }
+
+    CRITICAL_REGION_ENTER();
+    reschedule(true);
+    CRITICAL_REGION_EXIT();
+}
+
+void deadline_timer_init(void) {
+    uint32_t err_code = app_timer_create(&m_wake_timer, APP_TIMER_MODE_SINGLE_SHOT, wake_timer_handler);
+    APP_ERROR_CHECK(err_code);
+
+    m_last_cnt = app_timer_cnt_get();
+    m_minute_start = m_now;
+}
+
+ret_code_t deadline_timer_create(deadline_timer_id_t *p_id, deadline_timer_mode_t mode,
+                                 uint32_t slack_ms, deadline_timer_handler_t handler) {
+    if (m_timer_count >= DEADLINE_TIMER_MAX) {
+        NRF_LOG_ERROR("🚨 Deadline timer: All %d timers in use", DEADLINE_TIMER_MAX);
+        return NRF_ERROR_NO_MEM;
+    }
+
+    deadline_timer_t *p_timer = &m_timers[m_timer_count];
+    p_timer->handler = handler;
+    p_timer->repeated = (mode == DEADLINE_TIMER_MODE_REPEATED);
+    p_timer->slack = APP_TIMER_TICKS(slack_ms);
+    p_timer->active = false;
+
+    *p_id = m_timer_count++;
+    return NRF_SUCCESS;
+}
+
+void deadline_timer_start(deadline_timer_id_t id, uint32_t timeout_ms, void *p_context) {
+    deadline_timer_t *p_timer = &m_timers[id];
+    uint32_t ticks = APP_TIMER_TICKS(timeout_ms);
+
+    CRITICAL_REGION_ENTER();
+    p_timer->p_context = p_context;
+    p_timer->period = p_timer->repeated ? ticks : 0;
+    p_timer->deadline = now_ticks() + ticks;
+    p_timer->active = true;
+    reschedule(false);
+    CRITICAL_REGION_EXIT();
+}
+
+void deadline_timer_stop(deadline_timer_id_t id) {
+    CRITICAL_REGION_ENTER();
+    m_timers[id].active = false;
+    // The pending wake is left alone, it only costs one early wake-up
+    CRITICAL_REGION_EXIT();
+}
+
+uint32_t deadline_timer_wakeups_per_min(void) {
+    return m_wakeups_per_min;
+}
+
+uint32_t deadline_timer_expiries_per_min(void) {
+    return m_expiries_per_min;
+}
@@ -0,0 +1,148 @@
+/**
+ * @file diagnostics.c
+ * @brief Implementation of the Runtime Diagnostics Counters
+ */
+
+#include "includes/diagnostics.h"
+#include "includes/data_manager.h"
+#include "includes/deadline_timer.h"
+#include "includes/boot_profile.h"
+#include "includes/presence_wake.h"
+#include "app_timer.h"
+#include "includes/timer_ticks.h"
+#include "app_error.h"
+#include "app_util_platform.h"
+#include "nrf.h"
+#include "nrf_log.h"
+
+#define DIAG_SLEEP_MAGIC      0xD1A65EE9
+#define UPTIME_FOLD_MS        256000  // Well inside the 1024 s RTC range
+#define UPTIME_FOLD_SLACK_MS  60000
+
+/**
+ * @brief Deep sleep count, kept in no-init RAM through System OFF and the
+ *        resets in and out of presence listening
+ */
+typedef struct {
+    uint32_t magic;
+    uint32_t sleeps;
+    uint32_t check;  // Complement of sleeps
+} diag_sleep_record_t;
+
+uint32_t m_diag_counters[DIAG_COUNTER_COUNT];
+
+static diag_sleep_record_t m_sleep_record __attribute__((section(".app_noinit")));
+
+static uint32_t m_reset_reason = 0;
+static uint32_t m_uptime_s = 0;
+static uint32_t m_uptime_ticks = 0;     // Part of a second not yet added to m_uptime_s
+static uint32_t m_last_tick_cnt = 0;
+static deadline_timer_id_t m_uptime_timer;
+
+/**
+ * @brief Add the RTC ticks since the last call to the uptime
+ *
+ * The RTC wraps after 1024 s, the timer makes sure this runs more often
+ * than that even when nobody reads the uptime.
+ */
+static void uptime_fold(void) {
+    CRITICAL_REGION_ENTER();
+    uint32_t now = app_timer_cnt_get();
+    m_uptime_ticks += app_timer_cnt_diff_compute(now, m_last_tick_cnt);
+    m_last_tick_cnt = now;
+
+    m_uptime_s += m_uptime_ticks / TIMER_TICKS_FREQ;
+    m_uptime_ticks %= TIMER_TICKS_FREQ;
+    CRITICAL_REGION_EXIT();
+}
+
+static void uptime_timer_handler(void *p_context) {
+    uptime_fold();
+}
+
+void diagnostics_init(void) {
+    // Owned by the SoftDevice once it is enabled, read it directly before that
+    m_reset_reason = NRF_POWER->RESETREAS;
+    NRF_POWER->RESETREAS = m_reset_reason;  // Write 1 to clear
+
+    m_last_tick_cnt = app_timer_cnt_get();
+
+    uint32_t err_code = deadline_timer_create(&m_uptime_timer, DEADLINE_TIMER_MODE_REPEATED,
+                                              UPTIME_FOLD_SLACK_MS, uptime_timer_handler);
+    APP_ERROR_CHECK(err_code);
+    deadline_timer_start(m_uptime_timer, UPTIME_FOLD_MS, NULL);
+
+    // Power-on and brown-out leave random RAM, the check tells it apart from a count
+    if (m_sleep_record.magic != DIAG_SLEEP_MAGIC || m_sleep_record.check != ~m_sleep_record.sleeps) {
+        m_sleep_record.magic = DIAG_SLEEP_MAGIC;
+        m_sleep_record.sleeps = 0;
+        m_sleep_record.check = ~m_sleep_record.sleeps;
+    }
+    m_diag_counters[DIAG_SLEEP_ENTRY] = m_sleep_record.sleeps;
+
+    NRF_LOG_INFO("🔁 Reset reason: 0x%08X", m_reset_reason);
+}
+
+void diagnostics_sleep_entry(void) {
+    DIAG_INC(DIAG_SLEEP_ENTRY);
+    m_sleep_record.sleeps = m_diag_counters[DIAG_SLEEP_ENTRY];
+    m_sleep_record.check = ~m_sleep_record.sleeps;
+}
+
+uint32_t diagnostics_uptime_s(void) {
+    uptime_fold();
+    return m_uptime_s;
+}
+
+uint32_t diagnostics_reset_reason(void) {
+    return m_reset_reason;
+}
+
+/**
+ * @brief Store a little-endian uint32
+ */
+static uint8_t put_u32(uint8_t *p_buf, uint32_t value) {
+    p_buf[0] = (uint8_t)(value & 0xFF);
+    p_buf[1] = (uint8_t)((value >> 8) & 0xFF);
+    p_buf[2] = (uint8_t)((value >> 16) & 0xFF);
+    p_buf[3] = (uint8_t)((value >> 24) & 0xFF);
+    return 4;
+}
+
+uint16_t diagnostics_encode(uint8_t *p_buf) {
+    uint16_t len = 0;
+
+    len += put_u32(&p_buf[len], diagnostics_uptime_s());
+    len += put_u32(&p_buf[len], m_reset_reason);
+
+    for (uint8_t i = 0; i < DIAG_COUNTER_COUNT; i++) {
+        len += put_u32(&p_buf[len], m_diag_counters[i]);
+    }
+
+    // Filter rejections summed over the sources, only the configured ones ever count
+    sample_filter_stats_t total = {0};
+    for (uint8_t type = DATA_SOURCE_ANT_PLUS; type <= DATA_SOURCE_REED; type++) {
+        sample_filter_stats_t stats;
+        if (data_manager_get_filter_stats((data_source_type_t)type, &stats)) {
+            total.out_of_range += stats.out_of_range;
+            total.outliers += stats.outliers;
+            total.slew_limited += stats.slew_limited;
+        }
+    }
+    len += put_u32(&p_buf[len], total.out_of_range);
+    len += put_u32(&p_buf[len], total.outliers);
+    len += put_u32(&p_buf[len], total.slew_limited);
+
+    len += put_u32(&p_buf[len], deadline_timer_wakeups_per_min());
+    len += put_u32(&p_buf[len], deadline_timer_expiries_per_min());
+
+    len += put_u32(&p_buf[len], boot_profile_ms(BOOT_PHASE_FIRST_ADV));
+    len += put_u32(&p_buf[len], boot_profile_ms(BOOT_PHASE_FIRST_DATA));
+
+    // Only a wake from System OFF, by the reed switch, or from presence listening is a reacquisition
+    bool woke = (m_reset_reason & POWER_RESETREAS_OFF_Msk) || presence_wake_woke();
+    len += put_u32(&p_buf[len], woke ?
+                                boot_profile_ms(BOOT_PHASE_FIRST_WATT) : BOOT_PROFILE_NOT_REACHED);
+
+    return len;
+}
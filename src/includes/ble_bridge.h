@@ -16,6 +16,8 @@
 /**
  * @brief Initialize the BLE bridge
  * 
+ * Subscribes to power and cadence on the data bus.
+ * 
  * @return true if initialization was successful, false otherwise
  */
 bool ble_bridge_init(void);
@@ -39,15 +41,6 @@ void ble_bridge_stop(void);
  */
 bool ble_bridge_is_active(void);
 
-/**
- * @brief Update the BLE services with new data
- * 
- * This function should be called when new data is available from the data model.
- * 
- * @param data The new cycling data
- */
-void ble_bridge_update_data(cycling_data_t data);
-
 /**
  * @brief Callback function for BLE events
  * 
@@ -68,6 +61,14 @@ void ble_bridge_data_source_lost(void);
  */
 void ble_bridge_reset_data_timestamp(void);
 
+/**
+ * @brief Hold off the inactivity sleep for one inactivity timeout
+ *
+ * For sources that are served without a rider connection, the gym table
+ * and the aggregator, call on every bike sample.
+ */
+void ble_bridge_keep_alive(void);
+
 /**
  * @brief Set the ANT+ scan mode
  * 
@@ -75,4 +76,24 @@ void ble_bridge_reset_data_timestamp(void);
  */
 void ble_bridge_set_ant_scan_mode(bool enabled);
 
+/**
+ * @brief Set the Keiser gym mode
+ * 
+ * In gym mode the bridge publishes the table of all bikes in range instead
+ * of a single rider. The receiver keeps the bridge awake while any bike is seen.
+ * 
+ * @param enabled true to enable, false to disable
+ */
+void ble_bridge_set_gym_mode(bool enabled);
+
+/**
+ * @brief Set the ANT+ aggregator mode
+ * 
+ * In aggregator mode the bridge publishes one record per configured power
+ * meter. The aggregator keeps the bridge awake while any of them is transmitting.
+ * 
+ * @param enabled true to enable, false to disable
+ */
+void ble_bridge_set_aggregator_mode(bool enabled);
+
 #endif /* BLE_BRIDGE_H */ 
\ No newline at end of file
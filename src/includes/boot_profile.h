@@ -0,0 +1,55 @@
+/**
+ * @file boot_profile.h
+ * @brief Boot Phase Timestamps
+ *
+ * Records when each startup phase completes, in RAM, on the app_timer
+ * clock. The RTC starts in timers_init() a few microseconds after reset,
+ * the time spent in the bootloader is not included.
+ *
+ * Each phase keeps its first mark, later marks of the same phase are
+ * ignored, so the hot paths can mark unconditionally.
+ */
+
+#ifndef BOOT_PROFILE_H
+#define BOOT_PROFILE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define BOOT_PROFILE_NOT_REACHED  0xFFFFFFFF  /**< boot_profile_ms() of a phase that has not completed */
+
+/**
+ * @brief Boot phases, in the order main() normally reaches them
+ */
+typedef enum {
+    BOOT_PHASE_TIMERS = 0,      /**< app_timer running, time base starts */
+    BOOT_PHASE_SOFTDEVICE,      /**< BLE and ANT stacks enabled */
+    BOOT_PHASE_FDS_STARTED,     /**< fds_init() queued, flash scan runs in the background */
+    BOOT_PHASE_GATT_TABLE,      /**< Services that need no configuration are in the table */
+    BOOT_PHASE_FDS_READY,       /**< Configuration loaded from flash */
+    BOOT_PHASE_ADV_INIT,        /**< GAP parameters, advertising data and remaining services set up */
+    BOOT_PHASE_SOURCE_STARTED,  /**< Data source started */
+    BOOT_PHASE_FIRST_ADV,       /**< First advertisement started */
+    BOOT_PHASE_FIRST_DATA,      /**< First sample from the data source (ANT+ in the default mode) */
+    BOOT_PHASE_FIRST_WATT,      /**< First ANT+ power page with non-zero power */
+    BOOT_PHASE_COUNT
+} boot_phase_t;
+
+/**
+ * @brief Record the completion of a phase, safe from interrupt context
+ */
+void boot_profile_mark(boot_phase_t phase);
+
+/**
+ * @brief Milliseconds from the start of the time base to a phase
+ *
+ * @return Time in ms, BOOT_PROFILE_NOT_REACHED if the phase was not marked
+ */
+uint32_t boot_profile_ms(boot_phase_t phase);
+
+/**
+ * @brief Log every recorded phase and its duration
+ */
+void boot_profile_log(void);
+
+#endif /* BOOT_PROFILE_H */
@@ -6,11 +6,18 @@
 #define MANUFACTURER_NAME "Magpern Devops"  // Manufacturer name
 
 #define APP_ADV_INTERVAL 40       // BLE advertising interval (25 ms)
+#define APP_ADV_FAST_DURATION 3000  // Fast advertising after start, data or a disconnect (30 s, 10 ms units)
+#define APP_ADV_SLOW_INTERVAL 1600  // Advertising interval once the fast period is over (1 s)
+#define APP_ADV_WHITELIST_DURATION 500  // Bonded centrals only before advertising to all (5 s, 10 ms units)
 #define APP_ADV_DURATION 18000    // BLE advertising duration (seconds)
 
 #define APP_BLE_CONN_CFG_TAG 1    // BLE stack configuration tag
 
+#ifdef BONDING_ENABLE
+#define IS_SRVC_CHANGED_CHARACT_PRESENT 1  // Bonded centrals cache the table, they must hear when it changes
+#else
 #define IS_SRVC_CHANGED_CHARACT_PRESENT 0  // Whether service change characteristic is present
+#endif
 
 #define MIN_CONN_INTERVAL (80 / 2)  // 50 ms
 #define MAX_CONN_INTERVAL (80)      // 100 ms
@@ -35,6 +42,10 @@
 #define ANT_BPWR_TRANS_TYPE 5  // Transmission Type
 #define ANTPLUS_NETWORK_NUMBER 0  // Network number
 
+#define ANT_AGG_FIRST_CHANNEL 2  // First channel used by the multi-bike aggregator
+#define ANT_AGG_MAX_BIKES 6      // Power meters bridged in aggregator mode, one channel each
+#define ANT_BPWR_TX_CHANNEL 8    // ANT+ power transmitter, after the aggregator channels
+
 #define ANT_PLUS_NETWORK_KEY ((uint8_t[8]){0xB9, 0xA5, 0x21, 0xFB, 0xBD, 0x72, 0xC3, 0x45})  // ANT+ Key
 
 #define WAKEUP_BUTTON_ID                0                                            /**< Button used to wake up the application. */
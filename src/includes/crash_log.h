@@ -0,0 +1,72 @@
+/**
+ * @file crash_log.h
+ * @brief Crash Record in No-Init RAM
+ *
+ * Fatal paths (SDK error handler, SoftDevice assert, HardFault, forced
+ * resets) write a record to RAM that the startup code does not clear.
+ * The next boot validates it, keeps a copy as the last reset record and
+ * clears it, so it can be read over the diagnostics service. Resets that
+ * leave no record (brown-out, watchdog, pin reset) still report RESETREAS.
+ */
+
+#ifndef CRASH_LOG_H
+#define CRASH_LOG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define CRASH_LOG_TRACE_EVENTS  8   /**< Newest trace log events kept in the record */
+#define CRASH_LOG_FILE_LEN      24  /**< End of the source file name, NUL terminated */
+#define CRASH_LOG_ENCODED_LEN   (32 + CRASH_LOG_FILE_LEN + CRASH_LOG_TRACE_EVENTS * 16)  /**< crash_log_encode() output */
+
+/**
+ * @brief What caused the reset
+ */
+typedef enum {
+    CRASH_CAUSE_NONE = 0,     /**< No record, see the reset reason */
+    CRASH_CAUSE_APP_ERROR,    /**< APP_ERROR_CHECK or SDK assert */
+    CRASH_CAUSE_SD_ASSERT,    /**< SoftDevice assert */
+    CRASH_CAUSE_HARDFAULT,    /**< HardFault, error code is SCB->CFSR */
+    CRASH_CAUSE_ADV_FAILED,   /**< Advertising could not be started */
+} crash_cause_t;
+
+/**
+ * @brief Validate and clear the record of the previous run
+ *
+ * Call after diagnostics_init(), before the SoftDevice is enabled.
+ */
+void crash_log_init(void);
+
+/**
+ * @brief Store a record for the next boot
+ *
+ * Safe to call from fault handlers, the reset itself is up to the caller.
+ *
+ * @param cause What is about to reset the device
+ * @param pc Program counter of the fault, 0 if unknown
+ * @param lr Link register of the fault, 0 if unknown
+ * @param error_code Error code, CFSR for a HardFault
+ * @param p_file Source file, may be NULL
+ * @param line Source line
+ */
+void crash_log_record(crash_cause_t cause, uint32_t pc, uint32_t lr, uint32_t error_code,
+                      const char *p_file, uint32_t line);
+
+/**
+ * @brief Whether the previous run ended with a record
+ */
+bool crash_log_has_record(void);
+
+/**
+ * @brief Encode the last reset record for GATT (little-endian)
+ *
+ * Cause (4), reset reason (4), PC (4), LR (4), error code (4), uptime s (4),
+ * line (4), reserved (4), file (CRASH_LOG_FILE_LEN), then the trace events,
+ * oldest first, as trace_log_entry_t. The first 20 bytes fit one notification.
+ *
+ * @param p_buf Buffer of at least CRASH_LOG_ENCODED_LEN bytes
+ * @return uint16_t Encoded length
+ */
+uint16_t crash_log_encode(uint8_t *p_buf);
+
+#endif /* CRASH_LOG_H */
@@ -23,6 +23,38 @@ typedef struct {
     bool data_available;            /**< Indicates if valid data is available */
 } cycling_data_t;
 
+#define CYCLING_DATA_MOVING_AVG_SIZE 6  /**< Samples in the moving average */
+
+/**
+ * @brief One smoothing pipeline instance
+ *
+ * The global model owns one instance; sources that serve several bikes
+ * (e.g. the ANT+ aggregator) keep one per bike.
+ */
+typedef struct {
+    cycling_data_t data;                                      /**< Latest smoothed output */
+    uint16_t power_buffer[CYCLING_DATA_MOVING_AVG_SIZE];      /**< Power history */
+    uint8_t cadence_buffer[CYCLING_DATA_MOVING_AVG_SIZE];     /**< Cadence history */
+    uint8_t buffer_index;                                     /**< Next slot to write */
+    bool buffer_filled;                                       /**< All slots written at least once */
+} cycling_data_pipeline_t;
+
+/**
+ * @brief Reset a pipeline instance
+ * 
+ * @param p_pipeline Pipeline to reset
+ */
+void cycling_data_pipeline_reset(cycling_data_pipeline_t *p_pipeline);
+
+/**
+ * @brief Feed a sample into a pipeline instance
+ * 
+ * @param p_pipeline Pipeline to update
+ * @param power_watts Power in watts
+ * @param cadence_rpm Cadence in RPM
+ */
+void cycling_data_pipeline_update(cycling_data_pipeline_t *p_pipeline, uint16_t power_watts, uint8_t cadence_rpm);
+
 /**
  * @brief Initialize the cycling data model
  * 
@@ -32,29 +64,25 @@ bool cycling_data_init(void);
 
 /**
  * @brief Update cycling data with new values
+ *
+ * Subscribers of the data bus (data_bus.h) are notified of the new data.
  * 
  * @param power_watts Power in watts
  * @param cadence_rpm Cadence in RPM
+ * @param sample_ticks app_timer counter when the sample was received
  */
-void cycling_data_update(uint16_t power_watts, uint8_t cadence_rpm);
+void cycling_data_update(uint16_t power_watts, uint8_t cadence_rpm, uint32_t sample_ticks);
 
 /**
  * @brief Get the current cycling data
  * 
- * @return cycling_data_t The current cycling data
+ * @return const cycling_data_t* The current cycling data, owned by the model
  */
-cycling_data_t cycling_data_get(void);
+const cycling_data_t* cycling_data_get(void);
 
 /**
  * @brief Reset the cycling data model
  */
 void cycling_data_reset(void);
 
-/**
- * @brief Register for cycling data updates
- * 
- * @param callback Function to call when cycling data is updated
- */
-void cycling_data_register_callback(void (*callback)(cycling_data_t data));
-
 #endif /* CYCLING_DATA_MODEL_H */ 
\ No newline at end of file
@@ -0,0 +1,106 @@
+/**
+ * @file data_bus.h
+ * @brief Cycling Data Bus
+ *
+ * Fixed-capacity publish/subscribe bus for the cycling data. Producers
+ * update one shared snapshot per topic; subscribers receive a const
+ * pointer to it, filtered by topic and limited to a declared rate.
+ */
+
+#ifndef DATA_BUS_H
+#define DATA_BUS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "cycling_data_model.h"
+
+#define DATA_BUS_MAX_SUBSCRIBERS 8  /**< Fixed subscriber capacity */
+
+/**
+ * @brief Topics, used as a bit mask
+ */
+typedef enum {
+    DATA_BUS_TOPIC_POWER      = 0x01,  /**< Instantaneous and average power */
+    DATA_BUS_TOPIC_CADENCE    = 0x02,  /**< Instantaneous and average cadence */
+    DATA_BUS_TOPIC_HEART_RATE = 0x04,  /**< Heart rate from the bike, if it has one */
+    DATA_BUS_TOPIC_SPEED      = 0x08,  /**< Speed */
+    DATA_BUS_TOPIC_STATUS     = 0x10,  /**< Data source status */
+} data_bus_topic_t;
+
+#define DATA_BUS_TOPIC_ALL 0x1F
+
+/**
+ * @brief Status flags carried on DATA_BUS_TOPIC_STATUS
+ */
+#define DATA_BUS_STATUS_SOURCE_ACTIVE 0x01  /**< The data source delivers data */
+
+/**
+ * @brief Shared snapshot, one instance owned by the bus
+ */
+typedef struct {
+    uint32_t version;              /**< Incremented on every publish */
+    uint32_t timestamp_ticks;      /**< app_timer counter of the last publish */
+    uint32_t sample_ticks;         /**< app_timer counter when the cycling sample was received, radio RX time where available */
+    cycling_data_t cycling;        /**< Power and cadence */
+    uint8_t heart_rate_bpm;        /**< Heart rate in BPM, 0 when unknown */
+    uint16_t speed_kmh_x100;       /**< Speed in 0.01 km/h */
+    uint8_t status;                /**< DATA_BUS_STATUS_* flags */
+} data_bus_snapshot_t;
+
+/**
+ * @brief Subscriber handler
+ *
+ * @param p_snapshot Snapshot, valid until the handler returns
+ * @param topics Topics updated since this subscriber was last called
+ */
+typedef void (*data_bus_handler_t)(const data_bus_snapshot_t *p_snapshot, uint8_t topics);
+
+/**
+ * @brief Subscribe to the bus
+ *
+ * @param handler Function to call on updates
+ * @param topic_mask Topics of interest (data_bus_topic_t bits)
+ * @param min_interval_ms Minimum time between calls, 0 for every update. Updates
+ *                        in between are merged into one call at the end of
+ *                        the interval.
+ * @return true if subscribed, false if the bus is full
+ */
+bool data_bus_subscribe(data_bus_handler_t handler, uint8_t topic_mask, uint16_t min_interval_ms);
+
+/**
+ * @brief Remove a subscriber
+ *
+ * @param handler Handler passed to data_bus_subscribe()
+ */
+void data_bus_unsubscribe(data_bus_handler_t handler);
+
+/**
+ * @brief Publish power and cadence
+ *
+ * @param p_data New cycling data
+ * @param sample_ticks app_timer counter when the sample was received
+ */
+void data_bus_publish_cycling(const cycling_data_t *p_data, uint32_t sample_ticks);
+
+/**
+ * @brief Publish heart rate
+ *
+ * @param bpm Heart rate in BPM
+ */
+void data_bus_publish_heart_rate(uint8_t bpm);
+
+/**
+ * @brief Publish speed
+ *
+ * @param speed_kmh_x100 Speed in 0.01 km/h
+ */
+void data_bus_publish_speed(uint16_t speed_kmh_x100);
+
+/**
+ * @brief Publish data source status
+ *
+ * @param status DATA_BUS_STATUS_* flags
+ */
+void data_bus_publish_status(uint8_t status);
+
+#endif /* DATA_BUS_H */
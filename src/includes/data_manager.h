@@ -13,6 +13,13 @@
 #include <stdbool.h>
 #include "data_source.h"
 #include "cycling_data_model.h"
+#include "sample_filter.h"
+
+#define DATA_MANAGER_MAX_SOURCES      3     /**< Sources running concurrently */
+#define DATA_MANAGER_SOURCE_STALE_MS  1500  /**< A source is failed over after this long without data */
+#define DATA_MANAGER_QUALITY_MAX      100
+#define DATA_MANAGER_QUALITY_STEP     10    /**< Quality gained per sample */
+#define DATA_MANAGER_MIN_QUALITY      50    /**< Quality needed to take a field back from a healthy backup */
 
 /**
  * @brief Initialize the data manager
@@ -24,12 +31,30 @@ bool data_manager_init(void);
 /**
  * @brief Set the active data source
  * 
+ * Stops every running source, including added backups.
+ * 
  * @param type The type of data source to use
  * @param device_id Device ID for ANT+ data source (ignored for other sources)
  * @return true if successful, false otherwise
  */
 bool data_manager_set_data_source(data_source_type_t type, uint16_t device_id);
 
+/**
+ * @brief Run an additional data source next to the active one
+ * 
+ * Power, cadence and heart rate are fused per field: the healthy source with
+ * the lowest priority value provides the field, and a stale or lost source is
+ * replaced by the next one on its next sample instead of reporting zero.
+ * Keiser and the BLE central source both drive the scanner, so only one of
+ * them can run at a time.
+ * 
+ * @param type The type of data source to add
+ * @param device_id Device ID for the source
+ * @param priority Lower values are preferred, the active source has priority 0
+ * @return true if the source was started, false otherwise
+ */
+bool data_manager_add_data_source(data_source_type_t type, uint16_t device_id, uint8_t priority);
+
 /**
  * @brief Get the current active data source type
  * 
@@ -56,11 +81,31 @@ void data_manager_stop_collection(void);
  */
 bool data_manager_is_active(void);
 
+/**
+ * @brief Report a heart rate from a running source
+ * 
+ * Heart rate is fused like power and cadence and published on the data bus
+ * when the reporting source owns the field.
+ * 
+ * @param type Type of the reporting source
+ * @param bpm Heart rate in BPM, 0 when the source has no strap
+ */
+void data_manager_report_heart_rate(data_source_type_t type, uint8_t bpm);
+
+/**
+ * @brief Get the sample filter counters of a running source
+ * 
+ * @param type Source type
+ * @param p_stats Filled with the counters
+ * @return true if a source of this type is running, false otherwise
+ */
+bool data_manager_get_filter_stats(data_source_type_t type, sample_filter_stats_t *p_stats);
+
 /**
  * @brief Get the latest cycling data
  * 
- * @return cycling_data_t The latest cycling data
+ * @return const cycling_data_t* The latest cycling data, owned by the data model
  */
-cycling_data_t data_manager_get_latest_data(void);
+const cycling_data_t* data_manager_get_latest_data(void);
 
 #endif /* DATA_MANAGER_H */ 
\ No newline at end of file
@@ -20,6 +20,9 @@ typedef enum {
     DATA_SOURCE_ANT_PLUS = 0,  /**< ANT+ data source */
     DATA_SOURCE_KEISER_M3I = 1,  /**< Keiser M3i BLE data source */
     DATA_SOURCE_BLE_PROPRIETARY = 2,  /**< Proprietary BLE data source */
+    DATA_SOURCE_KEISER_GYM = 3,  /**< Keiser M3i gym receiver, tracks all bikes in range */
+    DATA_SOURCE_ANT_AGGREGATOR = 4,  /**< Several ANT+ power meters, one channel each */
+    DATA_SOURCE_REED = 5,  /**< Reed switch cadence and speed, no radio */
     DATA_SOURCE_NONE = 0xff  /**< No data source */
 } data_source_type_t;
 
@@ -28,8 +31,10 @@ typedef enum {
  * 
  * @param power_watts Power in watts
  * @param cadence_rpm Cadence in RPM
+ * @param sample_ticks app_timer counter when the sample was received, the radio
+ *                     RX time where the source has it
  */
-typedef void (*data_update_callback_t)(uint16_t power_watts, uint8_t cadence_rpm);
+typedef void (*data_update_callback_t)(uint16_t power_watts, uint8_t cadence_rpm, uint32_t sample_ticks);
 
 /**
  * @brief Data source configuration
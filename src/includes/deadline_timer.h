@@ -0,0 +1,80 @@
+/**
+ * @file deadline_timer.h
+ * @brief Deadline Timer Scheduler
+ *
+ * Software timers multiplexed on one app_timer. Every timer has a slack,
+ * how late it may fire. The scheduler sleeps until the earliest deadline
+ * plus slack and then fires every timer whose deadline has passed, so
+ * tolerant timers ride along on wake-ups that happen anyway instead of
+ * waking the CPU on their own.
+ *
+ * Restarting a running timer (data timeouts retriggered per packet) does
+ * not touch the RTC when it only moves the deadline later, the scheduler
+ * wakes at the old time and goes back to sleep.
+ *
+ * Handlers run in the app_timer context, like app_timer handlers.
+ */
+
+#ifndef DEADLINE_TIMER_H
+#define DEADLINE_TIMER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sdk_errors.h"
+
+#define DEADLINE_TIMER_MAX  16  /**< Timers that can be created */
+
+typedef uint8_t deadline_timer_id_t;
+
+typedef void (*deadline_timer_handler_t)(void *p_context);
+
+/**
+ * @brief Timer modes, same meaning as for app_timer
+ */
+typedef enum {
+    DEADLINE_TIMER_MODE_SINGLE_SHOT,
+    DEADLINE_TIMER_MODE_REPEATED
+} deadline_timer_mode_t;
+
+/**
+ * @brief Initialize the scheduler, call after app_timer_init()
+ */
+void deadline_timer_init(void);
+
+/**
+ * @brief Create a timer
+ *
+ * @param p_id Receives the timer ID
+ * @param mode Single shot or repeated
+ * @param slack_ms How late the timer may fire, 0 for exact
+ * @param handler Called on expiry
+ * @return NRF_SUCCESS, or NRF_ERROR_NO_MEM when all timers are taken
+ */
+ret_code_t deadline_timer_create(deadline_timer_id_t *p_id, deadline_timer_mode_t mode,
+                                 uint32_t slack_ms, deadline_timer_handler_t handler);
+
+/**
+ * @brief Start or restart a timer
+ *
+ * @param id Timer to start
+ * @param timeout_ms Time to the first expiry, and the period of a repeated timer
+ * @param p_context Passed to the handler
+ */
+void deadline_timer_start(deadline_timer_id_t id, uint32_t timeout_ms, void *p_context);
+
+/**
+ * @brief Stop a timer, stopping a stopped timer is allowed
+ */
+void deadline_timer_stop(deadline_timer_id_t id);
+
+/**
+ * @brief Scheduler wake-ups during the last full minute
+ */
+uint32_t deadline_timer_wakeups_per_min(void);
+
+/**
+ * @brief Timer expiries during the last full minute, above the wake-ups when timers were merged
+ */
+uint32_t deadline_timer_expiries_per_min(void);
+
+#endif /* DEADLINE_TIMER_H */
@@ -0,0 +1,80 @@
+/**
+ * @file diagnostics.h
+ * @brief Runtime Diagnostics Counters
+ *
+ * Event counters for field debugging without RTT. The hot paths only do
+ * DIAG_INC(), a plain increment at a fixed address. Handlers at different
+ * priorities may very rarely lose a count, which is accepted instead of a
+ * critical section per event.
+ */
+
+#ifndef DIAGNOSTICS_H
+#define DIAGNOSTICS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Counted events
+ */
+typedef enum {
+    DIAG_ANT_RX = 0,           /**< ANT+ broadcast received on the power channel */
+    DIAG_ANT_RX_FAIL,          /**< Expected ANT+ message missed */
+    DIAG_ANT_RX_OVERFLOW,      /**< ANT+ RX buffer overflow */
+    DIAG_ANT_SEARCH_TIMEOUT,   /**< ANT+ channel search timed out */
+    DIAG_KEISER_SEEN,          /**< Keiser advertisements from any bike */
+    DIAG_KEISER_MATCHED,       /**< Keiser advertisements from the configured bike */
+    DIAG_HVX_OK,               /**< CPS/FTMS notifications accepted by the SoftDevice */
+    DIAG_HVX_FAIL,             /**< CPS/FTMS notifications rejected by the SoftDevice */
+    DIAG_FTMS_DEDUP_SKIP,      /**< FTMS notifications skipped as duplicates */
+    DIAG_CPS_DEDUP_SKIP,       /**< CPS notifications skipped as duplicates */
+    DIAG_CONN_PARAM_UPDATE,    /**< Connection parameter updates on the peripheral link */
+    DIAG_SLEEP_ENTRY,          /**< Deep sleeps, System OFF or presence listening, kept across the wake-up resets */
+    DIAG_OUTPUT_HELD,          /**< Bridge output ticks that repeated a held value, no sample covered them */
+    DIAG_COUNTER_COUNT
+} diag_counter_t;
+
+#define DIAGNOSTICS_ENCODED_LEN  (8 + DIAG_COUNTER_COUNT * 4 + 12 + 8 + 12)  /**< diagnostics_encode() output */
+
+extern uint32_t m_diag_counters[DIAG_COUNTER_COUNT];
+
+#define DIAG_INC(counter) (m_diag_counters[(counter)]++)
+
+/**
+ * @brief Latch and clear the reset reason, call before the SoftDevice is enabled
+ *        and after deadline_timer_init()
+ */
+void diagnostics_init(void);
+
+/**
+ * @brief Count a deep sleep entry, call from enter_deep_sleep()
+ */
+void diagnostics_sleep_entry(void);
+
+/**
+ * @brief Seconds since reset, read from the RTC
+ */
+uint32_t diagnostics_uptime_s(void);
+
+/**
+ * @brief RESETREAS bits of the last reset
+ */
+uint32_t diagnostics_reset_reason(void);
+
+/**
+ * @brief Encode all counters for GATT (little-endian uint32)
+ *
+ * Uptime s, reset reason, the counters in diag_counter_t order, then the
+ * sample filter out of range / outlier / slew limited totals of all
+ * sources, the timer wake-ups and expiries of the last minute, then the
+ * boot time in ms to the first advertisement, to the first source
+ * sample and, after a wake from System OFF or presence listening, to the
+ * first ANT+ watt (0xFFFFFFFF until reached). The first 20 bytes fit one
+ * notification.
+ *
+ * @param p_buf Buffer of at least DIAGNOSTICS_ENCODED_LEN bytes
+ * @return uint16_t Encoded length
+ */
+uint16_t diagnostics_encode(uint8_t *p_buf);
+
+#endif /* DIAGNOSTICS_H */
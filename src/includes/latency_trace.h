@@ -0,0 +1,99 @@
+/**
+ * @file latency_trace.h
+ * @brief Sample Latency Tracer
+ *
+ * Follows samples from radio RX to the accepted BLE notification and keeps
+ * a fixed-bucket histogram per hop, so p50/p95/max can be read back over
+ * the diagnostics service or RTT. A connection is traced the same way up
+ * to its first accepted notification, which shows how quickly a central
+ * gets data after a reconnect.
+ */
+
+#ifndef LATENCY_TRACE_H
+#define LATENCY_TRACE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define LATENCY_TRACE_BUCKETS      16  /**< Histogram buckets, see latency_trace.c for the bounds */
+#define LATENCY_TRACE_ENCODED_LEN  (LATENCY_HOP_COUNT * 14)  /**< latency_trace_encode() output */
+
+/**
+ * @brief Measured hops
+ */
+typedef enum {
+    LATENCY_HOP_RX_TO_MODEL = 0,  /**< Radio RX to the cycling data model update */
+    LATENCY_HOP_MODEL_TO_QUEUED,  /**< Model update to the bridge taking the sample */
+    LATENCY_HOP_QUEUED_TO_HVX,    /**< Bridge to the first accepted notification carrying the sample */
+    LATENCY_HOP_RX_TO_HVX,        /**< End to end */
+    LATENCY_HOP_CONNECT_TO_HVX,   /**< Peripheral connection to its first accepted notification */
+    LATENCY_HOP_COUNT
+} latency_hop_t;
+
+/**
+ * @brief Summary of one hop
+ */
+typedef struct {
+    uint32_t count;   /**< Samples recorded */
+    uint32_t p50_us;  /**< Upper bound of the bucket holding the median */
+    uint32_t p95_us;  /**< Upper bound of the bucket holding the 95th percentile */
+    uint32_t max_us;  /**< Exact maximum */
+} latency_trace_summary_t;
+
+/**
+ * @brief A sample reached the cycling data model
+ *
+ * @param rx_ticks app_timer counter of the sample's RX
+ */
+void latency_trace_model(uint32_t rx_ticks);
+
+/**
+ * @brief The bridge took a sample for the next notification
+ *
+ * @param rx_ticks app_timer counter of the sample's RX
+ * @param model_ticks app_timer counter of the model update
+ */
+void latency_trace_queued(uint32_t rx_ticks, uint32_t model_ticks);
+
+/**
+ * @brief A central connected to the peripheral
+ */
+void latency_trace_connected(void);
+
+/**
+ * @brief A notification was accepted by the SoftDevice
+ *
+ * Only the first notification after a new sample completes its trace, and
+ * only the first one after a connection completes the connection trace.
+ */
+void latency_trace_hvx(void);
+
+/**
+ * @brief Get the summary of one hop
+ *
+ * @param hop Hop to summarize
+ * @param p_summary Filled with the summary
+ */
+void latency_trace_get(latency_hop_t hop, latency_trace_summary_t *p_summary);
+
+/**
+ * @brief Encode all hops (little-endian)
+ *
+ * Per hop: count (2, saturating), p50 us (4), p95 us (4), max us (4).
+ *
+ * @param p_buf Buffer of at least LATENCY_TRACE_ENCODED_LEN bytes
+ * @return uint16_t Encoded length
+ */
+uint16_t latency_trace_encode(uint8_t *p_buf);
+
+/**
+ * @brief Write all hops to the log
+ */
+void latency_trace_log(void);
+
+/**
+ * @brief Clear all histograms
+ */
+void latency_trace_reset(void);
+
+#endif /* LATENCY_TRACE_H */
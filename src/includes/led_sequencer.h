@@ -0,0 +1,65 @@
+/**
+ * @file led_sequencer.h
+ * @brief Asynchronous LED Pattern Sequencer
+ *
+ * Plays on/off patterns on the board LEDs from a timer, so blinking never
+ * blocks the caller. Which LED a pattern uses is set per board in
+ * the board header (LED_SEQ_*_LED), a board can leave a pattern out with
+ * LED_SEQ_LED_NONE.
+ *
+ * Usage:
+ *   led_seq_play(LED_SEQ_BOOT);
+ *   LED_SEQ_DEBUG_PLAY(LED_SEQ_ANT_RX);  // Debug builds only
+ */
+
+#ifndef LED_SEQUENCER_H
+#define LED_SEQUENCER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define LED_SEQ_LED_NONE  0xFF  /**< Board has no LED for the pattern */
+#define LED_SEQ_SLACK_MS  20    /**< Steps may end this much late, see deadline_timer.h */
+
+/**
+ * @brief Patterns, the table in led_sequencer.c holds the steps
+ */
+typedef enum {
+    LED_SEQ_BOOT = 0,    /**< Morse ".-." (R) once after reset */
+    LED_SEQ_HEARTBEAT,   /**< Short flash, bridge alive */
+    LED_SEQ_ANT_RX,      /**< Short flash per ANT+ message */
+    LED_SEQ_DATA,        /**< Short flash per sample in the data manager */
+    LED_SEQ_PATTERN_COUNT
+} led_seq_pattern_t;
+
+/**
+ * @brief Initialize the sequencer, call after timers_init()
+ */
+void led_seq_init(void);
+
+/**
+ * @brief Start a pattern on its LED
+ *
+ * A pattern replaces the one playing on the same LED unless that one has
+ * a higher priority, the flashes never cut the boot pattern short.
+ * Safe to call from interrupt context.
+ */
+void led_seq_play(led_seq_pattern_t pattern);
+
+/**
+ * @brief Stop all patterns and turn the LEDs off
+ */
+void led_seq_stop_all(void);
+
+/**
+ * @brief Whether any pattern is still playing
+ */
+bool led_seq_is_busy(void);
+
+#if defined(DEBUG) && !defined(RELEASE)
+#define LED_SEQ_DEBUG_PLAY(pattern)  led_seq_play(pattern)
+#else
+#define LED_SEQ_DEBUG_PLAY(pattern)  ((void)0)
+#endif
+
+#endif /* LED_SEQUENCER_H */
@@ -0,0 +1,51 @@
+/**
+ * @file presence_wake.h
+ * @brief Low-Power ANT+ Presence Wake
+ *
+ * Replaces System OFF for boards that cannot rely on the reed switch. The
+ * device resets into a listening loop in System ON: every
+ * PRESENCE_WAKE_INTERVAL_MS the RTC wakes the chip for a
+ * PRESENCE_WAKE_LISTEN_MS search on the cached channel ID of the meter,
+ * the rest of the time the chip idles with only the RTC running. Hearing
+ * the meter, or a reed pulse, resets into a normal boot.
+ *
+ * Built with PRESENCE_WAKE=1, see tools/presence_energy.py for choosing
+ * the interval.
+ */
+
+#ifndef PRESENCE_WAKE_H
+#define PRESENCE_WAKE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef PRESENCE_WAKE_INTERVAL_MS
+#define PRESENCE_WAKE_INTERVAL_MS  30000  /**< Start of one listen window to the next */
+#endif
+#define PRESENCE_WAKE_LISTEN_MS    300    /**< Search window, one BPWR message period plus margin */
+#define PRESENCE_WAKE_CHANNEL      0      /**< Shares the scan channel, nothing else is open while listening */
+
+/**
+ * @brief Reset into the listening loop instead of System OFF
+ *
+ * Call from enter_deep_sleep(), does not return on success.
+ *
+ * @return false if no meter was acquired before, there is nothing to listen for
+ */
+bool presence_wake_enter(void);
+
+/**
+ * @brief Run the listening loop if the last reset was presence_wake_enter()
+ *
+ * Call once the SoftDevice is enabled, before anything starts the radio.
+ * Returns at once on a normal boot, otherwise resets when the meter is
+ * heard or the reed switch closes.
+ */
+void presence_wake_run(void);
+
+/**
+ * @brief Whether this boot follows a wake from the listening loop
+ */
+bool presence_wake_woke(void);
+
+#endif /* PRESENCE_WAKE_H */
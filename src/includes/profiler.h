@@ -0,0 +1,102 @@
+/**
+ * @file profiler.h
+ * @brief Cycle Counter Profiler
+ *
+ * Measures named code sections with the Cortex-M4 DWT cycle counter and
+ * keeps min/avg/max and a log2 histogram per section. The macros compile
+ * away in RELEASE builds.
+ *
+ * Usage:
+ *   PROFILE_BEGIN(PROFILE_FTMS_TICK);
+ *   ...
+ *   PROFILE_END(PROFILE_FTMS_TICK);
+ */
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#if defined(DEBUG) && !defined(RELEASE)
+#define PROFILER_ENABLED 1
+#else
+#define PROFILER_ENABLED 0
+#endif
+
+#define PROFILER_HISTOGRAM_BINS  20  /**< Bin n holds 2^n..2^(n+1)-1 cycles, the last bin everything above */
+
+/**
+ * @brief Profiled sections
+ */
+typedef enum {
+    PROFILE_ANT_BPWR_EVT = 0,   /**< ant_bpwr_evt_handler() */
+    PROFILE_KEISER_ADV,         /**< process_adv_data() */
+    PROFILE_CYCLING_UPDATE,     /**< cycling_data_update() including the data bus subscribers */
+    PROFILE_FTMS_TICK,          /**< ble_ftms_tick() */
+    PROFILE_SECTION_COUNT
+} profile_section_t;
+
+#if PROFILER_ENABLED
+
+/**
+ * @brief Statistics of one section
+ */
+typedef struct {
+    uint32_t count;                               /**< Completed measurements */
+    uint32_t min_cycles;                          /**< Shortest run */
+    uint32_t max_cycles;                          /**< Longest run */
+    uint64_t total_cycles;                        /**< Sum of all runs, for the average */
+    uint32_t histogram[PROFILER_HISTOGRAM_BINS];  /**< Runs per power of two */
+} profile_stats_t;
+
+/**
+ * @brief Enable the DWT cycle counter
+ */
+void profiler_init(void);
+
+/**
+ * @brief Current cycle count
+ */
+uint32_t profiler_cycles(void);
+
+/**
+ * @brief Add one measurement to a section
+ *
+ * @param section Section the cycles belong to
+ * @param cycles Cycles spent in the section
+ */
+void profiler_record(profile_section_t section, uint32_t cycles);
+
+/**
+ * @brief Get the statistics of a section
+ *
+ * @param section Section to read
+ * @return const profile_stats_t* Statistics owned by the profiler
+ */
+const profile_stats_t* profiler_get(profile_section_t section);
+
+/**
+ * @brief Write all sections to the log (RTT)
+ */
+void profiler_log(void);
+
+/**
+ * @brief Clear all sections
+ */
+void profiler_reset(void);
+
+#define PROFILE_BEGIN(section) uint32_t profile_start_##section = profiler_cycles()
+#define PROFILE_END(section)   profiler_record((section), profiler_cycles() - profile_start_##section)
+
+#else
+
+#define profiler_init()        ((void)0)
+#define profiler_log()         ((void)0)
+#define profiler_reset()       ((void)0)
+#define PROFILE_BEGIN(section) ((void)0)
+#define PROFILE_END(section)   ((void)0)
+
+#endif // PROFILER_ENABLED
+
+#endif /* PROFILER_H */
@@ -0,0 +1,83 @@
+/**
+ * @file resampler.h
+ * @brief Fixed-Rate Resampler
+ *
+ * Turns irregular timestamped power and cadence samples into values at the
+ * times an output stream asks for them, by zero-order hold or linear
+ * interpolation between the two newest samples.
+ */
+
+#ifndef RESAMPLER_H
+#define RESAMPLER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define RESAMPLER_FLAG_EXTRAPOLATED 0x01  /**< No input covers the output time, the value is held */
+
+/**
+ * @brief Resampling method
+ */
+typedef enum {
+    RESAMPLER_ZOH = 0,  /**< Newest sample at or before the output time */
+    RESAMPLER_LINEAR,   /**< Interpolated between the samples around the output time */
+} resampler_mode_t;
+
+/**
+ * @brief One output value
+ */
+typedef struct {
+    uint16_t power;
+    uint8_t cadence;
+    uint8_t flags;  /**< RESAMPLER_FLAG_* */
+} resampler_sample_t;
+
+/**
+ * @brief Resampler instance
+ */
+typedef struct {
+    resampler_mode_t mode;
+    uint16_t delay_ms;      /**< Output time lags the request by this much, linear mode needs about one input period */
+    uint16_t max_hold_ms;   /**< Older inputs are not used at all */
+    uint32_t ticks[2];      /**< app_timer counter of the previous [0] and newest [1] input */
+    uint16_t power[2];
+    uint8_t cadence[2];
+    uint8_t count;          /**< Inputs held, up to 2 */
+    bool fresh;             /**< An input arrived since the last output */
+} resampler_t;
+
+/**
+ * @brief Initialize a resampler instance
+ *
+ * @param p_resampler Instance to initialize
+ * @param mode Resampling method
+ * @param delay_ms Output delay, 0 for the lowest latency
+ * @param max_hold_ms Inputs older than this are treated as lost
+ */
+void resampler_init(resampler_t *p_resampler, resampler_mode_t mode, uint16_t delay_ms, uint16_t max_hold_ms);
+
+/**
+ * @brief Add an input sample
+ *
+ * @param p_resampler Instance
+ * @param ticks app_timer counter when the sample was taken
+ * @param power Power in watts
+ * @param cadence Cadence in RPM
+ */
+void resampler_push(resampler_t *p_resampler, uint32_t ticks, uint16_t power, uint8_t cadence);
+
+/**
+ * @brief Produce the output value for now
+ *
+ * In linear mode a value is extrapolated when the output time is past the
+ * newest input; in zero-order hold mode when no input arrived since the
+ * previous output. Extrapolated values hold the newest input.
+ *
+ * @param p_resampler Instance
+ * @param now_ticks Current app_timer counter
+ * @param p_sample Filled with the output value
+ * @return true if a value was produced, false if there is no input younger than max_hold_ms
+ */
+bool resampler_output(resampler_t *p_resampler, uint32_t now_ticks, resampler_sample_t *p_sample);
+
+#endif /* RESAMPLER_H */
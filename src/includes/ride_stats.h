@@ -0,0 +1,105 @@
+/**
+ * @file ride_stats.h
+ * @brief Ride Statistics Engine
+ *
+ * Incremental ride statistics fed with every power sample: max power,
+ * energy, average and normalized power and the best 5 s / 1 min / 5 min /
+ * 20 min power. Integer arithmetic only, O(1) work per sample.
+ */
+
+#ifndef RIDE_STATS_H
+#define RIDE_STATS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define RIDE_STATS_RING_LEN         1200  /**< 1 s power history, as long as the longest window (20 min) */
+#define RIDE_STATS_NP_WINDOW_S      30    /**< Rolling average used for normalized power */
+#define RIDE_STATS_GAP_HOLD_S       3     /**< Gaps up to this long hold the last power, longer gaps count as stopped */
+#define RIDE_STATS_MAX_SESSIONS     4     /**< Sessions kept in flash */
+#define RIDE_STATS_SAVE_INTERVAL_S  300   /**< Session summary is written to flash this often while riding, the first save gives it a slot */
+#define RIDE_STATS_ENCODED_LEN      20    /**< ride_stats_encode() output, fits one notification */
+
+/**
+ * @brief Best average power windows
+ */
+typedef enum {
+    RIDE_STATS_BEST_5S = 0,
+    RIDE_STATS_BEST_1MIN,
+    RIDE_STATS_BEST_5MIN,
+    RIDE_STATS_BEST_20MIN,
+    RIDE_STATS_BEST_COUNT
+} ride_stats_best_t;
+
+/**
+ * @brief Summary of one session
+ */
+typedef struct {
+    uint16_t session_id;                          /**< Incremented on every boot */
+    uint16_t max_power;                           /**< Highest single sample in watts */
+    uint32_t duration_s;                          /**< Seconds with data */
+    uint32_t energy_j;                            /**< Work in joules */
+    uint16_t avg_power;                           /**< Energy / duration in watts */
+    uint16_t normalized_power;                    /**< 4th root of the mean 4th power of the 30 s average */
+    uint16_t best_power[RIDE_STATS_BEST_COUNT];   /**< Best average power per window, 0 until the window is filled */
+} ride_stats_summary_t;
+
+/**
+ * @brief Initialize the engine, load the stored sessions and open a new one
+ *
+ * The new session is only added to the stored sessions once it is saved
+ * with riding time, so power-on without a ride does not cost a slot.
+ */
+void ride_stats_init(void);
+
+/**
+ * @brief Start a new session in RAM, the previous one stays in flash
+ */
+void ride_stats_reset(void);
+
+/**
+ * @brief Feed one power sample
+ *
+ * Samples are averaged into 1 s bins; all statistics are updated when a
+ * bin closes.
+ *
+ * @param power_watts Instantaneous power in watts
+ */
+void ride_stats_update(uint16_t power_watts);
+
+/**
+ * @brief Get the summary of the current session
+ *
+ * @return const ride_stats_summary_t* Summary owned by the engine
+ */
+const ride_stats_summary_t* ride_stats_get(void);
+
+/**
+ * @brief Get a stored session
+ *
+ * @param index 0 is the newest stored session (the current one once saved), 1 the session before it
+ * @return const ride_stats_summary_t* Stored summary, NULL if there is none
+ */
+const ride_stats_summary_t* ride_stats_get_stored(uint8_t index);
+
+/**
+ * @brief Write the current session summary to flash
+ *
+ * Does nothing before the session has riding time. Runs the FDS garbage
+ * collection and saves again when flash is full.
+ */
+void ride_stats_save(void);
+
+/**
+ * @brief Encode a summary for GATT (little-endian)
+ *
+ * Session ID (2), duration s (2, saturates at 18 h), energy kJ (2), max (2),
+ * average (2), normalized (2), best 5 s / 1 min / 5 min / 20 min (2 each).
+ *
+ * @param p_summary Summary to encode
+ * @param p_buf Buffer of at least RIDE_STATS_ENCODED_LEN bytes
+ * @return uint16_t Encoded length
+ */
+uint16_t ride_stats_encode(const ride_stats_summary_t *p_summary, uint8_t *p_buf);
+
+#endif /* RIDE_STATS_H */
@@ -0,0 +1,105 @@
+/**
+ * @file sample_filter.h
+ * @brief Sample Filter
+ *
+ * Robust filter stage for raw source samples, run before they reach the
+ * cycling data model. Rejects implausible values, replaces isolated
+ * spikes or the whole sample by the median of a short window, and can
+ * limit how fast a field may rise.
+ */
+
+#ifndef SAMPLE_FILTER_H
+#define SAMPLE_FILTER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define SAMPLE_FILTER_WINDOW    5   /**< Samples kept per field, largest supported median */
+
+/**
+ * @brief Robust filter applied to one field
+ */
+typedef enum {
+    SAMPLE_FILTER_OFF = 0,   /**< Only the range check and slew limit */
+    SAMPLE_FILTER_MEDIAN3,   /**< Median of the last 3 samples, delays steps by 1 sample */
+    SAMPLE_FILTER_MEDIAN5,   /**< Median of the last 5 samples, delays steps by 2 samples */
+    SAMPLE_FILTER_SPIKE,     /**< Isolated single-sample spikes dropped; a jump above min_deviation waits one sample for confirmation, others pass at once */
+} sample_filter_mode_t;
+
+/**
+ * @brief Filter settings of one field
+ */
+typedef struct {
+    sample_filter_mode_t mode;
+    uint16_t max_value;       /**< Larger samples are dropped */
+    uint16_t max_rise_per_s;  /**< Slew limit for rising values, 0 = off. Drops are never limited */
+    uint16_t min_deviation;   /**< Jump that must be confirmed by the next sample, and the change a median must make to count as an outlier */
+} sample_filter_field_config_t;
+
+/**
+ * @brief Filter settings of one data source
+ */
+typedef struct {
+    sample_filter_field_config_t power;
+    sample_filter_field_config_t cadence;
+} sample_filter_config_t;
+
+/**
+ * @brief Rejection counters, kept for diagnostics
+ */
+typedef struct {
+    uint32_t out_of_range;  /**< Samples above max_value */
+    uint32_t outliers;      /**< Isolated spikes dropped, or samples moved by a median */
+    uint32_t slew_limited;  /**< Samples clamped by the slew limit */
+} sample_filter_stats_t;
+
+/**
+ * @brief State of one field
+ */
+typedef struct {
+    uint16_t window[SAMPLE_FILTER_WINDOW];  /**< Raw accepted samples, oldest overwritten */
+    uint8_t index;                          /**< Next slot to write */
+    uint8_t count;                          /**< Samples in the window */
+    uint16_t last_output;
+    uint16_t pending;                       /**< Jump waiting for the next sample, SAMPLE_FILTER_SPIKE */
+    bool has_pending;
+} sample_filter_field_t;
+
+/**
+ * @brief Filter instance, one per data source
+ */
+typedef struct {
+    const sample_filter_config_t *p_config;
+    sample_filter_field_t power;
+    sample_filter_field_t cadence;
+    sample_filter_stats_t stats;
+} sample_filter_t;
+
+/**
+ * @brief Initialize a filter instance
+ *
+ * @param p_filter Instance to initialize
+ * @param p_config Settings, must stay valid while the instance is used
+ */
+void sample_filter_init(sample_filter_t *p_filter, const sample_filter_config_t *p_config);
+
+/**
+ * @brief Forget the sample history, e.g. after the source lost its link
+ *
+ * The counters are kept.
+ *
+ * @param p_filter Instance to reset
+ */
+void sample_filter_reset(sample_filter_t *p_filter);
+
+/**
+ * @brief Filter one sample in place
+ *
+ * @param p_filter Instance
+ * @param p_power Power in watts, replaced by the filtered value
+ * @param p_cadence Cadence in RPM, replaced by the filtered value
+ * @param dt_ms Time since the previous sample, used by the slew limit
+ */
+void sample_filter_apply(sample_filter_t *p_filter, uint16_t *p_power, uint8_t *p_cadence, uint32_t dt_ms);
+
+#endif /* SAMPLE_FILTER_H */
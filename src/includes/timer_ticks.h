@@ -0,0 +1,26 @@
+/**
+ * @file timer_ticks.h
+ * @brief app_timer Tick Conversions
+ *
+ * app_timer runs RTC1 with the prescaler APP_TIMER_CONFIG_RTC_FREQUENCY, so
+ * app_timer_cnt_get() counts at APP_TIMER_CLOCK_FREQ / (prescaler + 1), not
+ * at the 32768 Hz of the LFCLK. APP_TIMER_TICKS() converts milliseconds to
+ * ticks, these convert tick differences back.
+ */
+
+#ifndef TIMER_TICKS_H
+#define TIMER_TICKS_H
+
+#include <stdint.h>
+#include "app_timer.h"
+
+/** RTC1 ticks per second as seen by app_timer_cnt_get() */
+#define TIMER_TICKS_FREQ  (APP_TIMER_CLOCK_FREQ / (APP_TIMER_CONFIG_RTC_FREQUENCY + 1))
+
+/** Tick difference to milliseconds, rounded down */
+#define TICKS_TO_MS(ticks) ((uint32_t)(((uint64_t)(ticks) * 1000) / TIMER_TICKS_FREQ))
+
+/** Tick difference to microseconds, rounded down */
+#define TICKS_TO_US(ticks) ((uint32_t)(((uint64_t)(ticks) * 1000000) / TIMER_TICKS_FREQ))
+
+#endif // TIMER_TICKS_H
@@ -0,0 +1,74 @@
+/**
+ * @file trace_log.h
+ * @brief Binary Trace Log
+ *
+ * Hot path events are stored as an event ID plus two raw arguments in a
+ * RAM ring, no string formatting on target. The format strings live in
+ * the .trace_fmt section, which the linker keeps in the ELF but never
+ * loads, so the event ID is the offset of the string in that section.
+ * tools/trace_decode.py turns a ring dump back into text with the ELF.
+ *
+ * Tracing stays enabled in RELEASE builds; a call costs a short critical
+ * section and four word stores.
+ */
+
+#ifndef TRACE_LOG_H
+#define TRACE_LOG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef TRACE_LOG_ENABLED
+#define TRACE_LOG_ENABLED 1
+#endif
+
+#define TRACE_LOG_ENTRIES  16  /**< Ring size, power of two; the dump must fit one attribute (510 bytes) */
+
+/**
+ * @brief One event, little-endian words as dumped
+ */
+typedef struct {
+    uint32_t ticks;    /**< app_timer (RTC1) counter, 24 bits */
+    uint32_t id;       /**< Offset of the format string in .trace_fmt */
+    uint32_t args[2];  /**< Raw arguments, unused ones are 0 */
+} trace_log_entry_t;
+
+/**
+ * @brief The ring as dumped to the host
+ */
+typedef struct {
+    uint32_t next;                                /**< Events written since reset, the slot is next % TRACE_LOG_ENTRIES */
+    trace_log_entry_t entries[TRACE_LOG_ENTRIES];
+} trace_log_t;
+
+#define TRACE_LOG_ENCODED_LEN  sizeof(trace_log_t)
+
+#if TRACE_LOG_ENABLED
+
+/**
+ * @brief Store one event, use the TRACE_LOG macros instead
+ */
+void trace_log_write(uint32_t id, uint32_t arg0, uint32_t arg1);
+
+/**
+ * @brief The ring, for the diagnostics service and the crash record
+ */
+const trace_log_t* trace_log_get(void);
+
+#define TRACE_LOG_INTERNAL(fmt, arg0, arg1)                                                     \
+    do {                                                                                         \
+        static const char trace_fmt_[] __attribute__((section(".trace_fmt"), used)) = fmt;       \
+        trace_log_write((uint32_t)(uintptr_t)trace_fmt_, (uint32_t)(arg0), (uint32_t)(arg1));    \
+    } while (0)
+
+#else
+
+#define TRACE_LOG_INTERNAL(fmt, arg0, arg1) ((void)0)
+
+#endif // TRACE_LOG_ENABLED
+
+#define TRACE_LOG0(fmt)             TRACE_LOG_INTERNAL(fmt, 0, 0)
+#define TRACE_LOG1(fmt, arg0)       TRACE_LOG_INTERNAL(fmt, arg0, 0)
+#define TRACE_LOG2(fmt, arg0, arg1) TRACE_LOG_INTERNAL(fmt, arg0, arg1)
+
+#endif /* TRACE_LOG_H */
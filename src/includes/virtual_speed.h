@@ -0,0 +1,82 @@
+/**
+ * @file virtual_speed.h
+ * @brief Virtual Speed Model
+ *
+ * Speed a rider would reach on flat road with no wind at the current power,
+ * plus the distance and elapsed time accumulated from it. Rider mass, CdA
+ * and Crr come from the device config; power is mapped to speed through a
+ * table built once at init, so no cubic is solved per sample.
+ */
+
+#ifndef VIRTUAL_SPEED_H
+#define VIRTUAL_SPEED_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define VIRTUAL_SPEED_TABLE_STEP_W   4     /**< Power between two table entries */
+#define VIRTUAL_SPEED_TABLE_MAX_W    2000  /**< Power of the last table entry, higher power is clamped */
+#define VIRTUAL_SPEED_TABLE_LEN      ((VIRTUAL_SPEED_TABLE_MAX_W / VIRTUAL_SPEED_TABLE_STEP_W) + 1)
+#define VIRTUAL_SPEED_GAP_MS         3000  /**< Longer gaps between samples count as stopped */
+
+// Defaults used when the config holds no physics parameters
+#define VIRTUAL_SPEED_DEFAULT_MASS_KG_X10     800   /**< Rider and bike, 80 kg */
+#define VIRTUAL_SPEED_DEFAULT_CDA_X10000      3200  /**< 0.32 m^2, hoods */
+#define VIRTUAL_SPEED_DEFAULT_CRR_X100000     400   /**< 0.0040, road tyres */
+
+/**
+ * @brief Virtual speed state
+ */
+typedef struct {
+    uint16_t speed_kmh_x100;  /**< Instantaneous speed, 0.01 km/h (FTMS resolution) */
+    uint32_t distance_m;      /**< Total distance in metres */
+    uint32_t elapsed_s;       /**< Seconds spent moving */
+} virtual_speed_t;
+
+/**
+ * @brief Build the power to speed table from the configured parameters
+ */
+void virtual_speed_init(void);
+
+/**
+ * @brief Feed one power sample and accumulate distance and time
+ *
+ * Called with the power sent to the rider, so the reported speed and the
+ * distance integrated from it come from the same input.
+ *
+ * @param power_watts Power in watts
+ */
+void virtual_speed_update(uint16_t power_watts);
+
+/**
+ * @brief Feed a measured speed instead of one derived from power
+ *
+ * Used while a wheel sensor reports speed. Distance and elapsed time keep
+ * accumulating in the same state, so switching between the two inputs
+ * does not restart the ride.
+ *
+ * @param speed_kmh_x100 Speed in 0.01 km/h
+ */
+void virtual_speed_update_measured(uint16_t speed_kmh_x100);
+
+/**
+ * @brief Steady-state speed for a power, from the table
+ *
+ * @param power_watts Power in watts
+ * @return uint16_t Speed in 0.01 km/h
+ */
+uint16_t virtual_speed_from_power(uint16_t power_watts);
+
+/**
+ * @brief Get the current speed, distance and elapsed time
+ *
+ * @return const virtual_speed_t* State owned by the model
+ */
+const virtual_speed_t* virtual_speed_get(void);
+
+/**
+ * @brief Clear distance and elapsed time
+ */
+void virtual_speed_reset(void);
+
+#endif /* VIRTUAL_SPEED_H */
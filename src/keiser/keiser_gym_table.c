@@ -0,0 +1,163 @@
+#include "keiser_gym_table.h"
+#include <string.h>
+#include "app_timer.h"
+#include "includes/timer_ticks.h"
+#include "nrf_log.h"
+
+static keiser_gym_entry_t m_entries[KEISER_GYM_MAX_BIKES];
+static uint8_t m_count = 0;
+static uint8_t m_generation = 0;  // Changes whenever a bike is added or removed
+
+// Milliseconds since an entry was last heard
+static uint32_t entry_age_ms(const keiser_gym_entry_t *p_entry, uint32_t now_ticks)
+{
+    return TICKS_TO_MS(app_timer_cnt_diff_compute(now_ticks, p_entry->last_seen_ticks));
+}
+
+// Get the n-th entry in use, in slot order
+static const keiser_gym_entry_t* entry_at(uint8_t index)
+{
+    for (uint8_t i = 0; i < KEISER_GYM_MAX_BIKES; i++)
+    {
+        if (!m_entries[i].in_use) continue;
+        if (index == 0) return &m_entries[i];
+        index--;
+    }
+    return NULL;
+}
+
+void keiser_gym_table_reset(void)
+{
+    memset(m_entries, 0, sizeof(m_entries));
+    m_count = 0;
+    m_generation++;
+}
+
+void keiser_gym_table_update(const uint8_t *p_mac, const keiser_m3i_data_t *p_data, uint32_t now_ticks)
+{
+    keiser_gym_entry_t *p_free = NULL;
+    keiser_gym_entry_t *p_oldest = NULL;
+
+    for (uint8_t i = 0; i < KEISER_GYM_MAX_BIKES; i++)
+    {
+        keiser_gym_entry_t *p_entry = &m_entries[i];
+
+        if (!p_entry->in_use)
+        {
+            if (p_free == NULL) p_free = p_entry;
+            continue;
+        }
+
+        if (memcmp(p_entry->mac, p_mac, BLE_GAP_ADDR_LEN) == 0)
+        {
+            p_entry->data = *p_data;
+            p_entry->last_seen_ticks = now_ticks;
+            return;
+        }
+
+        if (p_oldest == NULL || entry_age_ms(p_entry, now_ticks) > entry_age_ms(p_oldest, now_ticks))
+        {
+            p_oldest = p_entry;
+        }
+    }
+
+    if (p_free == NULL)
+    {
+        // Table full - replace the bike we have not heard from for the longest time
+        NRF_LOG_WARNING("Keiser Gym: Table full, replacing bike %d", p_oldest->data.equipment_id);
+        p_free = p_oldest;
+        m_count--;
+    }
+
+    memcpy(p_free->mac, p_mac, BLE_GAP_ADDR_LEN);
+    p_free->data = *p_data;
+    p_free->last_seen_ticks = now_ticks;
+    p_free->in_use = true;
+    m_count++;
+    m_generation++;
+
+    NRF_LOG_INFO("Keiser Gym: Tracking bike %d (%d bikes)", p_data->equipment_id, m_count);
+}
+
+void keiser_gym_table_expire(uint32_t now_ticks)
+{
+    for (uint8_t i = 0; i < KEISER_GYM_MAX_BIKES; i++)
+    {
+        if (m_entries[i].in_use && entry_age_ms(&m_entries[i], now_ticks) >= KEISER_GYM_EXPIRE_MS)
+        {
+            NRF_LOG_INFO("Keiser Gym: Bike %d expired", m_entries[i].data.equipment_id);
+            m_entries[i].in_use = false;
+            m_count--;
+            m_generation++;
+        }
+    }
+}
+
+uint8_t keiser_gym_table_count(void)
+{
+    return m_count;
+}
+
+uint8_t keiser_gym_table_generation(void)
+{
+    return m_generation;
+}
+
+uint16_t keiser_gym_table_encode_snapshot(uint8_t *p_buf, uint16_t buf_len, uint8_t first, uint32_t now_ticks)
+{
+    if (buf_len < KEISER_GYM_SNAPSHOT_HDR_LEN) return 0;
+
+    p_buf[0] = m_count;
+    p_buf[1] = first;
+    uint16_t len = KEISER_GYM_SNAPSHOT_HDR_LEN;
+
+    for (uint8_t index = first; index < m_count; index++)
+    {
+        if (len + KEISER_GYM_SNAPSHOT_ENTRY_LEN > buf_len) break;
+
+        const keiser_gym_entry_t *p_entry = entry_at(index);
+        if (p_entry == NULL) break;
+
+        uint32_t age = entry_age_ms(p_entry, now_ticks) / KEISER_GYM_AGE_UNIT_MS;
+
+        p_buf[len++] = p_entry->data.equipment_id;
+        p_buf[len++] = p_entry->data.power & 0xFF;
+        p_buf[len++] = (p_entry->data.power >> 8) & 0xFF;
+        p_buf[len++] = p_entry->data.cadence & 0xFF;
+        p_buf[len++] = (p_entry->data.cadence >> 8) & 0xFF;
+        p_buf[len++] = (uint8_t)(p_entry->data.heart_rate / 10);
+        p_buf[len++] = p_entry->data.gear;
+        p_buf[len++] = (age > 0xFF) ? 0xFF : (uint8_t)age;
+    }
+
+    return len;
+}
+
+uint16_t keiser_gym_table_encode_broadcast(uint8_t *p_buf, uint16_t buf_len, uint8_t first, uint32_t now_ticks)
+{
+    if (buf_len < KEISER_GYM_BROADCAST_HDR_LEN) return 0;
+
+    p_buf[0] = m_count;
+    p_buf[1] = first;
+    uint16_t len = KEISER_GYM_BROADCAST_HDR_LEN;
+
+    for (uint8_t index = first; index < m_count; index++)
+    {
+        if (len + KEISER_GYM_BROADCAST_ENTRY_LEN > buf_len) break;
+
+        const keiser_gym_entry_t *p_entry = entry_at(index);
+        if (p_entry == NULL) break;
+
+        bool stale = entry_age_ms(p_entry, now_ticks) >= KEISER_GYM_STALE_MS;
+        uint16_t power = stale ? 0 : p_entry->data.power;
+        uint16_t cadence_rpm = stale ? 0 : (p_entry->data.cadence / 10);
+
+        p_buf[len++] = p_entry->data.equipment_id;
+        p_buf[len++] = power & 0xFF;
+        p_buf[len++] = (power >> 8) & 0xFF;
+        p_buf[len++] = (cadence_rpm > 0xFF) ? 0xFF : (uint8_t)cadence_rpm;
+        p_buf[len++] = (uint8_t)(p_entry->data.heart_rate / 10);
+    }
+
+    return len;
+}
@@ -0,0 +1,91 @@
+#ifndef KEISER_GYM_TABLE_H
+#define KEISER_GYM_TABLE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "keiser_m3i_data_source.h"
+
+// Gym table constants
+#define KEISER_GYM_MAX_BIKES          16     // Fixed table capacity
+#define KEISER_GYM_STALE_MS           3000   // Entry flagged stale after this long without a packet
+#define KEISER_GYM_EXPIRE_MS          30000  // Entry removed after this long without a packet
+
+// GATT snapshot encoding: header + fixed size entries
+#define KEISER_GYM_SNAPSHOT_HDR_LEN   2      // Total bikes (1) + index of first entry in this frame (1)
+#define KEISER_GYM_SNAPSHOT_ENTRY_LEN 8      // Equipment ID (1) + Power (2) + Cadence x10 (2) + HR (1) + Gear (1) + Age (1)
+#define KEISER_GYM_SNAPSHOT_MAX_LEN   (KEISER_GYM_SNAPSHOT_HDR_LEN + (KEISER_GYM_MAX_BIKES * KEISER_GYM_SNAPSHOT_ENTRY_LEN))
+
+// Broadcast encoding: header + compact entries, sized to fit manufacturer data in one scan response
+#define KEISER_GYM_BROADCAST_HDR_LEN   2     // Total bikes (1) + index of first entry in this frame (1)
+#define KEISER_GYM_BROADCAST_ENTRY_LEN 5     // Equipment ID (1) + Power (2) + Cadence RPM (1) + HR (1)
+
+#define KEISER_GYM_AGE_UNIT_MS        100    // Age field resolution, saturates at 255
+
+// One tracked bike
+typedef struct {
+    uint8_t  mac[BLE_GAP_ADDR_LEN];  // Peer address as reported by the stack (little-endian)
+    keiser_m3i_data_t data;          // Latest parsed packet
+    uint32_t last_seen_ticks;        // app_timer counter at last packet
+    bool     in_use;
+} keiser_gym_entry_t;
+
+/**
+ * @brief Clear the table
+ */
+void keiser_gym_table_reset(void);
+
+/**
+ * @brief Insert or refresh a bike, keyed by MAC address
+ * 
+ * When the table is full the least recently seen bike is replaced.
+ * 
+ * @param p_mac Peer address (little-endian)
+ * @param p_data Parsed Keiser data
+ * @param now_ticks Current app_timer counter
+ */
+void keiser_gym_table_update(const uint8_t *p_mac, const keiser_m3i_data_t *p_data, uint32_t now_ticks);
+
+/**
+ * @brief Remove bikes not heard for KEISER_GYM_EXPIRE_MS
+ * 
+ * @param now_ticks Current app_timer counter
+ */
+void keiser_gym_table_expire(uint32_t now_ticks);
+
+/**
+ * @brief Number of bikes currently tracked
+ */
+uint8_t keiser_gym_table_count(void);
+
+/**
+ * @brief Generation of the table membership
+ * 
+ * Changes whenever a bike is added or removed, which shifts the index of
+ * the bikes behind it. Frames encoded under different generations must not
+ * be combined.
+ */
+uint8_t keiser_gym_table_generation(void);
+
+/**
+ * @brief Encode a GATT snapshot frame
+ * 
+ * @param p_buf Output buffer
+ * @param buf_len Size of the output buffer
+ * @param first Index of the first tracked bike to encode
+ * @param now_ticks Current app_timer counter, used for the age field
+ * @return uint16_t Number of bytes written
+ */
+uint16_t keiser_gym_table_encode_snapshot(uint8_t *p_buf, uint16_t buf_len, uint8_t first, uint32_t now_ticks);
+
+/**
+ * @brief Encode a compact broadcast frame
+ * 
+ * @param p_buf Output buffer
+ * @param buf_len Size of the output buffer
+ * @param first Index of the first tracked bike to encode
+ * @param now_ticks Current app_timer counter, stale bikes are sent with zero power and cadence
+ * @return uint16_t Number of bytes written
+ */
+uint16_t keiser_gym_table_encode_broadcast(uint8_t *p_buf, uint16_t buf_len, uint8_t first, uint32_t now_ticks);
+
+#endif // KEISER_GYM_TABLE_H
@@ -2,16 +2,24 @@
 #include "nrf_log.h"
 #include "app_timer.h"
 #include "cycling_data_model.h"
+#include "data_manager.h"
+#include "profiler.h"
+#include "diagnostics.h"
+#include "trace_log.h"
+#include "deadline_timer.h"
 #include "nrf_sdh_ble.h"
 #include "nrf_sdh.h"
 #include "ble.h"
 #include "ble_custom_config.h"
+#include "keiser_gym_table.h"
+#include "ble_bridge.h"
 
 // Define the BLE observer priority for our module
 #define KEISER_M3I_BLE_OBSERVER_PRIO 2
 
 // Forward declarations
 static void timeout_timer_handler(void *p_context);
+static void scan_resume_timer_handler(void *p_context);
 static void process_adv_data(const ble_gap_evt_adv_report_t *p_adv_report);
 static void ble_evt_handler(ble_evt_t const *p_ble_evt, void *p_context);
 
@@ -24,15 +32,21 @@ static keiser_m3i_config_t m_keiser_config = {
     .target_mac = {0x24, 0xEC, 0x4A, 0x2C, 0x6E, 0xE1}  // Initialize with MAC from ble_custom_config.h
 };
 static bool m_is_active = false;
-static app_timer_id_t m_timeout_timer_id;
+static bool m_gym_mode = false;  // Track every bike in range instead of a single target
+static bool m_scan_started = false;  // Scanning is ours; other sources may use the scanner too
+static deadline_timer_id_t m_timeout_timer_id;   // Retriggered per packet, tolerant
+static app_timer_id_t m_scan_resume_timer_id;     // Exact, the scan window must open before the packet
 static keiser_m3i_data_t m_last_data = {0};
+static keiser_scan_mode_t m_scan_mode = KEISER_SCAN_MODE_WIDE;
+static bool m_scan_restart_pending = false;  // Scan was stopped (not just paused) and needs full params on resume
+static ble_gap_addr_t m_target_addr;  // Target address as reported by the stack, incl. address type
 static uint8_t m_adv_report_buffer[BLE_GAP_SCAN_BUFFER_MIN];  // Buffer for advertising reports
 static ble_gap_scan_params_t m_scan_params = {
-    .active = 1,  // Active scanning
-    .interval = MSEC_TO_UNITS(100, UNIT_0_625_MS),  // Scan interval
-    .window = MSEC_TO_UNITS(100, UNIT_0_625_MS),    // Scan window
+    .active = 0,  // Passive scanning - Keiser data is in the advertising packet, no scan requests needed
+    .interval = MSEC_TO_UNITS(KEISER_SCAN_WIDE_INTERVAL_MS, UNIT_0_625_MS),  // Scan interval
+    .window = MSEC_TO_UNITS(KEISER_SCAN_WIDE_WINDOW_MS, UNIT_0_625_MS),      // Scan window
     .timeout = 0,  // No timeout
-    .filter_policy = BLE_GAP_SCAN_FP_ACCEPT_ALL,  // Accept all advertisements
+    .filter_policy = BLE_GAP_SCAN_FP_ACCEPT_ALL,  // Accept all until the target has been heard once
     .scan_phys = BLE_GAP_PHY_1MBPS  // Use 1M PHY
 };
 static ble_data_t m_adv_report = {
@@ -40,13 +54,87 @@ static ble_data_t m_adv_report = {
     .len = BLE_GAP_SCAN_BUFFER_MIN
 };
 
-// Initialize the timeout timer
+// Initialize the timeout and scan resume timers
 static void init_timeout_timer(void)
 {
-    uint32_t err_code = app_timer_create(&m_timeout_timer_id,
-                                       APP_TIMER_MODE_SINGLE_SHOT,
-                                       timeout_timer_handler);
+    uint32_t err_code = deadline_timer_create(&m_timeout_timer_id,
+                                              DEADLINE_TIMER_MODE_SINGLE_SHOT,
+                                              KEISER_M3I_ADV_TIMEOUT_SLACK_MS,
+                                              timeout_timer_handler);
     APP_ERROR_CHECK(err_code);
+
+    err_code = app_timer_create(&m_scan_resume_timer_id,
+                                APP_TIMER_MODE_SINGLE_SHOT,
+                                scan_resume_timer_handler);
+    APP_ERROR_CHECK(err_code);
+}
+
+// Resume a paused scan, or restart it with m_scan_params if it was stopped
+static void scan_resume(void)
+{
+    uint32_t err_code;
+
+    if (m_scan_restart_pending)
+    {
+        err_code = sd_ble_gap_scan_start(&m_scan_params, &m_adv_report);
+        if (err_code == NRF_SUCCESS)
+        {
+            m_scan_restart_pending = false;
+        }
+    }
+    else
+    {
+        err_code = sd_ble_gap_scan_start(NULL, &m_adv_report);
+    }
+
+    if (err_code != NRF_SUCCESS)
+    {
+        NRF_LOG_ERROR("Keiser M3i: Failed to continue scanning: %d", err_code);
+    }
+}
+
+// Stop scanning and apply the parameters for the requested mode; scanning restarts on next resume
+static void scan_set_mode(keiser_scan_mode_t mode)
+{
+    // The whitelist cannot be changed while the scanner is using it
+    uint32_t err_code = sd_ble_gap_scan_stop();
+    if (err_code != NRF_SUCCESS && err_code != NRF_ERROR_INVALID_STATE)
+    {
+        NRF_LOG_WARNING("Keiser M3i: Failed to stop scan for mode change: %d", err_code);
+    }
+
+    if (mode == KEISER_SCAN_MODE_LOCKED)
+    {
+        ble_gap_addr_t const * p_whitelist[] = { &m_target_addr };
+        err_code = sd_ble_gap_whitelist_set(p_whitelist, 1);
+        if (err_code == NRF_SUCCESS)
+        {
+            m_scan_params.filter_policy = BLE_GAP_SCAN_FP_WHITELIST;
+        }
+        else
+        {
+            // Still lock the timing, process_adv_data() keeps filtering on MAC
+            NRF_LOG_WARNING("Keiser M3i: Whitelist not available (%d), filtering in software", err_code);
+            m_scan_params.filter_policy = BLE_GAP_SCAN_FP_ACCEPT_ALL;
+        }
+    }
+    else
+    {
+        (void)sd_ble_gap_whitelist_set(NULL, 0);
+        m_scan_params.filter_policy = BLE_GAP_SCAN_FP_ACCEPT_ALL;
+    }
+
+    m_scan_mode = mode;
+    m_scan_restart_pending = true;
+
+    NRF_LOG_INFO("Keiser M3i: Scan mode %s",
+                 (mode == KEISER_SCAN_MODE_LOCKED) ? "LOCKED" : "WIDE");
+}
+
+// Scan resume handler - fires just before the next expected advertising event
+static void scan_resume_timer_handler(void *p_context)
+{
+    scan_resume();
 }
 
 // Timeout handler - called when we haven't received data for too long
@@ -54,11 +142,19 @@ static void timeout_timer_handler(void *p_context)
 {
     m_is_active = false;
     NRF_LOG_INFO("Keiser M3i data source timeout - no data received");
+
+    // Lost the bike, go back to wide scanning until it is heard again
+    app_timer_stop(m_scan_resume_timer_id);
+    if (m_scan_mode != KEISER_SCAN_MODE_WIDE)
+    {
+        scan_set_mode(KEISER_SCAN_MODE_WIDE);
+        scan_resume();
+    }
     
     // Notify data manager of timeout
     if (m_config.data_callback != NULL)
     {
-        m_config.data_callback(0, 0);  // Send zero values to indicate timeout
+        m_config.data_callback(0, 0, app_timer_cnt_get());  // Send zero values to indicate timeout
     }
 }
 
@@ -102,11 +198,39 @@ static bool parse_keiser_data(const uint8_t *p_data, uint8_t data_len, keiser_m3
     return true;
 }
 
+// Gym mode: record every Keiser packet in the gym table and keep scanning wide
+static void process_gym_adv_data(const ble_gap_evt_adv_report_t *p_adv_report)
+{
+    uint8_t *p_data = p_adv_report->data.p_data;
+    uint8_t data_len = p_adv_report->data.len;
+
+    for (uint8_t i = 0; i + 20 <= data_len; i++)
+    {
+        if (p_data[i] != 0xFF) continue;  // Skip if not manufacturer data
+
+        uint16_t manufacturer_id = (p_data[i + 2] << 8) | p_data[i + 1];
+        if (manufacturer_id != KEISER_M3I_MANUFACTURER_ID) continue;
+
+        keiser_m3i_data_t new_data;
+        new_data.manufacturer_id = manufacturer_id;
+
+        if (parse_keiser_data(&p_data[i + 3], 17, &new_data))
+        {
+            keiser_gym_table_update(p_adv_report->peer_addr.addr, &new_data, app_timer_cnt_get());
+            ble_bridge_keep_alive();
+        }
+        break;
+    }
+
+    scan_resume();
+}
+
 // Process advertising data from Keiser M3i
 static void process_adv_data(const ble_gap_evt_adv_report_t *p_adv_report)
 {
     uint8_t *p_data = p_adv_report->data.p_data;
     uint8_t data_len = p_adv_report->data.len;
+    bool target_seen = false;
 
     for (uint8_t i = 0; i < data_len - 1; i++)
     {
@@ -117,23 +241,16 @@ static void process_adv_data(const ble_gap_evt_adv_report_t *p_adv_report)
         uint16_t manufacturer_id = (p_data[i + 2] << 8) | p_data[i + 1];
         if (manufacturer_id != KEISER_M3I_MANUFACTURER_ID) continue;
 
+        DIAG_INC(DIAG_KEISER_SEEN);
+
         // Now check MAC address
         if (!mac_address_match(p_adv_report->peer_addr.addr, m_keiser_config.target_mac))
             break;  // Not our target device
 
-        // Format MAC string for logging
-        char mac_str[18];
-        snprintf(mac_str, sizeof(mac_str), "%02X:%02X:%02X:%02X:%02X:%02X",
-                 p_adv_report->peer_addr.addr[5], p_adv_report->peer_addr.addr[4],
-                 p_adv_report->peer_addr.addr[3], p_adv_report->peer_addr.addr[2],
-                 p_adv_report->peer_addr.addr[1], p_adv_report->peer_addr.addr[0]);
-
-        NRF_LOG_DEBUG("Keiser M3i: Found manufacturer data 0x%04X from %s",
-                     manufacturer_id, mac_str);
-
+        // Only the target gets here, no need to format its MAC for every report
         if (i + 20 > data_len)
         {
-            NRF_LOG_WARNING("Keiser M3i: Not enough bytes for Keiser data from %s", mac_str);
+            TRACE_LOG1("Keiser M3i: Not enough bytes for Keiser data (%u)", data_len);
             break;
         }
 
@@ -142,37 +259,53 @@ static void process_adv_data(const ble_gap_evt_adv_report_t *p_adv_report)
 
         if (!parse_keiser_data(&p_data[i + 3], 17, &new_data)) break;
 
-        NRF_LOG_DEBUG("Keiser M3i: Power: %d W, Cadence: %d RPM from %s",
-                     new_data.power, new_data.cadence / 10, mac_str);
+        TRACE_LOG2("Keiser M3i: Power: %u W, Cadence: %u RPM", new_data.power, new_data.cadence / 10);
 
         m_last_data = new_data;
         m_is_active = true;
+        target_seen = true;
+        DIAG_INC(DIAG_KEISER_MATCHED);
 
         if (m_config.data_callback)
         {
             uint8_t cadence_rpm = new_data.cadence / 10;
-            m_config.data_callback(new_data.power, cadence_rpm);
+            m_config.data_callback(new_data.power, cadence_rpm, app_timer_cnt_get());
+
+            // The M3i reports heart rate in 0.1 BPM, 0 without a chest strap
+            data_manager_report_heart_rate(m_config.type, (uint8_t)(new_data.heart_rate / 10));
         }
         else
         {
             NRF_LOG_WARNING("Keiser M3i: No data callback registered!");
         }
 
-        uint32_t err_code = app_timer_stop(m_timeout_timer_id);
-        APP_ERROR_CHECK(err_code);
-        err_code = app_timer_start(m_timeout_timer_id,
-                                   APP_TIMER_TICKS(KEISER_M3I_ADV_TIMEOUT_MS),
-                                   NULL);
-        APP_ERROR_CHECK(err_code);
+        deadline_timer_start(m_timeout_timer_id, KEISER_M3I_ADV_TIMEOUT_MS, NULL);
 
         break;  // We processed our target device
     }
 
-    // Resume scanning
-    uint32_t err_code = sd_ble_gap_scan_start(NULL, &m_adv_report);
+    if (!target_seen)
+    {
+        // Not our bike, keep listening
+        scan_resume();
+        return;
+    }
+
+    // First packet from the target: lock onto its address and advertising interval
+    if (m_scan_mode == KEISER_SCAN_MODE_WIDE)
+    {
+        m_target_addr = p_adv_report->peer_addr;
+        scan_set_mode(KEISER_SCAN_MODE_LOCKED);
+    }
+
+    // Stay paused until just before the next advertising event. If that packet is
+    // missed the scanner keeps listening and catches the one after it.
+    uint32_t err_code = app_timer_start(m_scan_resume_timer_id,
+                                        APP_TIMER_TICKS(KEISER_M3I_ADV_INTERVAL_MS - KEISER_SCAN_LOCK_GUARD_MS),
+                                        NULL);
     if (err_code != NRF_SUCCESS)
     {
-        NRF_LOG_ERROR("Keiser M3i: Failed to continue scanning: %d", err_code);
+        scan_resume();
     }
 }
 
@@ -182,10 +315,25 @@ static void process_adv_data(const ble_gap_evt_adv_report_t *p_adv_report)
 // BLE event handler
 static void ble_evt_handler(ble_evt_t const *p_ble_evt, void *p_context)
 {
+    if (!m_scan_started)
+    {
+        return;
+    }
+
     switch (p_ble_evt->header.evt_id)
     {
         case BLE_GAP_EVT_ADV_REPORT:
-            process_adv_data(&p_ble_evt->evt.gap_evt.params.adv_report);
+            if (m_gym_mode)
+            {
+                process_gym_adv_data(&p_ble_evt->evt.gap_evt.params.adv_report);
+            }
+            else
+            {
+                // Timed here, process_adv_data() has several exits
+                PROFILE_BEGIN(PROFILE_KEISER_ADV);
+                process_adv_data(&p_ble_evt->evt.gap_evt.params.adv_report);
+                PROFILE_END(PROFILE_KEISER_ADV);
+            }
             break;
 
         default:
@@ -203,6 +351,8 @@ bool keiser_m3i_init(data_source_config_t* config)
     
     m_config = *config;
     m_is_active = false;
+    m_gym_mode = (config->type == DATA_SOURCE_KEISER_GYM);
+    keiser_gym_table_reset();
     
     // Initialize timeout timer
     init_timeout_timer();
@@ -228,6 +378,31 @@ bool keiser_m3i_start(void)
         return false;
     }
 
+    // Gym mode listens to every bike, no target MAC needed
+    if (m_gym_mode)
+    {
+        uint32_t err_code = sd_ble_gap_scan_stop();
+        if (err_code != NRF_SUCCESS && err_code != NRF_ERROR_INVALID_STATE)
+        {
+            NRF_LOG_ERROR("Keiser M3i: Failed to stop existing scan: %d", err_code);
+            return false;
+        }
+
+        scan_set_mode(KEISER_SCAN_MODE_WIDE);
+        err_code = sd_ble_gap_scan_start(&m_scan_params, &m_adv_report);
+        if (err_code != NRF_SUCCESS)
+        {
+            NRF_LOG_ERROR("Keiser M3i: Failed to start gym scanning: %d", err_code);
+            return false;
+        }
+
+        NRF_LOG_INFO("Keiser M3i: Started gym scanning, up to %d bikes", KEISER_GYM_MAX_BIKES);
+        m_scan_restart_pending = false;
+        m_scan_started = true;
+        m_is_active = true;
+        return true;
+    }
+
     // Verify MAC address is set
     bool mac_is_zero = true;
     for (uint8_t i = 0; i < BLE_GAP_ADDR_LEN; i++)
@@ -257,6 +432,9 @@ bool keiser_m3i_start(void)
         NRF_LOG_ERROR("Keiser M3i: Failed to stop existing scan: %d", err_code);
         return false;
     }
+
+    // Always start wide; the scheduler locks on after the first packet
+    scan_set_mode(KEISER_SCAN_MODE_WIDE);
     
     // Start scanning with our static parameters
     err_code = sd_ble_gap_scan_start(&m_scan_params, &m_adv_report);
@@ -267,6 +445,8 @@ bool keiser_m3i_start(void)
     }
     
     NRF_LOG_INFO("Keiser M3i: Started BLE scanning");
+    m_scan_restart_pending = false;
+    m_scan_started = true;
     m_is_active = true;
     return true;
 }
@@ -276,11 +456,20 @@ void keiser_m3i_stop(void)
 {
     // Stop scanning
     uint32_t err_code = sd_ble_gap_scan_stop();
-    APP_ERROR_CHECK(err_code);
+    if (err_code != NRF_ERROR_INVALID_STATE)
+    {
+        APP_ERROR_CHECK(err_code);
+    }
     
-    // Stop timeout timer
-    err_code = app_timer_stop(m_timeout_timer_id);
+    // Stop timeout and scan resume timers
+    deadline_timer_stop(m_timeout_timer_id);
+    err_code = app_timer_stop(m_scan_resume_timer_id);
     APP_ERROR_CHECK(err_code);
+
+    (void)sd_ble_gap_whitelist_set(NULL, 0);
+    m_scan_mode = KEISER_SCAN_MODE_WIDE;
+    m_scan_restart_pending = false;
+    m_scan_started = false;
     
     m_is_active = false;
 }
@@ -12,6 +12,20 @@
 #define KEISER_M3I_MANUFACTURER_ID 0x0102  // Keiser's manufacturer ID
 #define KEISER_M3I_ADV_INTERVAL_MS 320     // Advertising interval in milliseconds
 #define KEISER_M3I_ADV_TIMEOUT_MS  1000    // Timeout for not receiving data
+#define KEISER_M3I_ADV_TIMEOUT_SLACK_MS 250  // The timeout may fire this much later
+
+// Scan scheduler constants
+#define KEISER_SCAN_WIDE_INTERVAL_MS 100   // Wide scan: interval == window, radio on continuously
+#define KEISER_SCAN_WIDE_WINDOW_MS   100
+#define KEISER_SCAN_LOCK_GUARD_MS    15    // Resume scanning this long before the next expected packet, see tools/keiser_scan_duty.py
+
+/**
+ * @brief Keiser M3i scan scheduler modes
+ */
+typedef enum {
+    KEISER_SCAN_MODE_WIDE = 0,    // Passive, accept all, continuous - used until the target is heard
+    KEISER_SCAN_MODE_LOCKED = 1,  // Passive, whitelist on target, resumed just before each advertising event
+} keiser_scan_mode_t;
 
 // Keiser M3i data structure
 typedef struct {
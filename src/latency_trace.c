@@ -0,0 +1,167 @@
+/**
+ * @file latency_trace.c
+ * @brief Implementation of the Sample Latency Tracer
+ */
+
+#include "includes/latency_trace.h"
+#include <string.h>
+#include "app_timer.h"
+#include "includes/timer_ticks.h"
+#include "nrf_log.h"
+
+// Upper bucket bounds in us, the last bucket takes everything above
+static const uint32_t m_bucket_us[LATENCY_TRACE_BUCKETS - 1] = {
+    125, 250, 500, 1000, 2000, 5000, 10000, 20000, 50000, 100000, 200000, 500000, 1000000, 2000000, 5000000
+};
+
+typedef struct {
+    uint32_t buckets[LATENCY_TRACE_BUCKETS];
+    uint32_t count;
+    uint32_t max_us;
+} latency_histogram_t;
+
+static latency_histogram_t m_hops[LATENCY_HOP_COUNT];
+
+static const char * const m_hop_names[LATENCY_HOP_COUNT] = {
+    "RX->model", "model->queued", "queued->HVX", "RX->HVX", "connect->HVX"
+};
+
+// Sample waiting for its first notification
+static bool m_pending = false;
+static uint32_t m_pending_rx_ticks = 0;
+static uint32_t m_pending_queued_ticks = 0;
+
+// Connection waiting for its first notification
+static bool m_conn_pending = false;
+static uint32_t m_conn_ticks = 0;
+
+/**
+ * @brief Add one measurement to a hop, returns it in us
+ */
+static uint32_t record(latency_hop_t hop, uint32_t from_ticks, uint32_t to_ticks) {
+    latency_histogram_t *p_hop = &m_hops[hop];
+    uint32_t us = TICKS_TO_US(app_timer_cnt_diff_compute(to_ticks, from_ticks));
+
+    uint8_t bucket = 0;
+    while (bucket < LATENCY_TRACE_BUCKETS - 1 && us > m_bucket_us[bucket]) {
+        bucket++;
+    }
+
+    p_hop->buckets[bucket]++;
+    p_hop->count++;
+    if (us > p_hop->max_us) {
+        p_hop->max_us = us;
+    }
+    return us;
+}
+
+/**
+ * @brief Percentile from the histogram, as the upper bound of its bucket
+ */
+static uint32_t percentile(const latency_histogram_t *p_hop, uint8_t percent) {
+    if (p_hop->count == 0) {
+        return 0;
+    }
+
+    uint64_t target = ((uint64_t)p_hop->count * percent + 99) / 100;
+    uint32_t cumulative = 0;
+
+    for (uint8_t i = 0; i < LATENCY_TRACE_BUCKETS - 1; i++) {
+        cumulative += p_hop->buckets[i];
+        if (cumulative >= target) {
+            // The bound can not be above the largest value seen
+            return (m_bucket_us[i] < p_hop->max_us) ? m_bucket_us[i] : p_hop->max_us;
+        }
+    }
+    return p_hop->max_us;
+}
+
+void latency_trace_model(uint32_t rx_ticks) {
+    record(LATENCY_HOP_RX_TO_MODEL, rx_ticks, app_timer_cnt_get());
+}
+
+void latency_trace_queued(uint32_t rx_ticks, uint32_t model_ticks) {
+    uint32_t now = app_timer_cnt_get();
+
+    record(LATENCY_HOP_MODEL_TO_QUEUED, model_ticks, now);
+
+    // A newer sample replaces one that was never sent
+    m_pending = true;
+    m_pending_rx_ticks = rx_ticks;
+    m_pending_queued_ticks = now;
+}
+
+void latency_trace_connected(void) {
+    m_conn_pending = true;
+    m_conn_ticks = app_timer_cnt_get();
+}
+
+void latency_trace_hvx(void) {
+    uint32_t now = app_timer_cnt_get();
+
+    if (m_conn_pending) {
+        uint32_t us = record(LATENCY_HOP_CONNECT_TO_HVX, m_conn_ticks, now);
+        m_conn_pending = false;
+        NRF_LOG_INFO("⏱️ Connected: first notification after %u ms", us / 1000);
+    }
+
+    if (!m_pending) {
+        return;
+    }
+
+    record(LATENCY_HOP_QUEUED_TO_HVX, m_pending_queued_ticks, now);
+    record(LATENCY_HOP_RX_TO_HVX, m_pending_rx_ticks, now);
+    m_pending = false;
+}
+
+void latency_trace_get(latency_hop_t hop, latency_trace_summary_t *p_summary) {
+    const latency_histogram_t *p_hop = &m_hops[hop];
+
+    p_summary->count = p_hop->count;
+    p_summary->p50_us = percentile(p_hop, 50);
+    p_summary->p95_us = percentile(p_hop, 95);
+    p_summary->max_us = p_hop->max_us;
+}
+
+/**
+ * @brief Store a little-endian uint32
+ */
+static uint8_t put_u32(uint8_t *p_buf, uint32_t value) {
+    p_buf[0] = (uint8_t)(value & 0xFF);
+    p_buf[1] = (uint8_t)((value >> 8) & 0xFF);
+    p_buf[2] = (uint8_t)((value >> 16) & 0xFF);
+    p_buf[3] = (uint8_t)((value >> 24) & 0xFF);
+    return 4;
+}
+
+uint16_t latency_trace_encode(uint8_t *p_buf) {
+    uint16_t len = 0;
+
+    for (uint8_t hop = 0; hop < LATENCY_HOP_COUNT; hop++) {
+        latency_trace_summary_t summary;
+        latency_trace_get((latency_hop_t)hop, &summary);
+
+        uint16_t count = (summary.count > 0xFFFF) ? 0xFFFF : (uint16_t)summary.count;
+        p_buf[len++] = (uint8_t)(count & 0xFF);
+        p_buf[len++] = (uint8_t)((count >> 8) & 0xFF);
+        len += put_u32(&p_buf[len], summary.p50_us);
+        len += put_u32(&p_buf[len], summary.p95_us);
+        len += put_u32(&p_buf[len], summary.max_us);
+    }
+    return len;
+}
+
+void latency_trace_log(void) {
+    for (uint8_t hop = 0; hop < LATENCY_HOP_COUNT; hop++) {
+        latency_trace_summary_t summary;
+        latency_trace_get((latency_hop_t)hop, &summary);
+
+        NRF_LOG_INFO("⏱️ Latency %s: n=%u p50=%u us p95=%u us max=%u us",
+                     m_hop_names[hop], summary.count, summary.p50_us, summary.p95_us, summary.max_us);
+    }
+}
+
+void latency_trace_reset(void) {
+    memset(m_hops, 0, sizeof(m_hops));
+    m_pending = false;
+}
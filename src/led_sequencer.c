@@ -0,0 +1,190 @@
+/**
+ * @file led_sequencer.c
+ * @brief Implementation of the Asynchronous LED Pattern Sequencer
+ */
+
+#include "includes/led_sequencer.h"
+#include "includes/deadline_timer.h"
+#include "app_timer.h"
+#include "includes/timer_ticks.h"
+#include "app_error.h"
+#include "app_util.h"
+#include "app_util_platform.h"
+#include "boards.h"
+
+// Boards without their own mapping use the PCA10056 LEDs
+#ifndef LED_SEQ_BOOT_LED
+#define LED_SEQ_BOOT_LED       0
+#endif
+#ifndef LED_SEQ_HEARTBEAT_LED
+#define LED_SEQ_HEARTBEAT_LED  1
+#endif
+#ifndef LED_SEQ_ANT_RX_LED
+#define LED_SEQ_ANT_RX_LED     3
+#endif
+#ifndef LED_SEQ_DATA_LED
+#define LED_SEQ_DATA_LED       3
+#endif
+
+#define DOT_MS    200
+#define DASH_MS   (DOT_MS * 3)
+#define FLASH_MS  30
+
+/**
+ * @brief One pattern, steps alternate on and off starting with on
+ */
+typedef struct {
+    const uint16_t *p_steps;  // Step durations in ms
+    uint8_t step_count;
+    uint8_t led;              // bsp_board LED index or LED_SEQ_LED_NONE
+    uint8_t priority;         // Higher priorities are not replaced by lower ones
+} led_seq_def_t;
+
+typedef struct {
+    const led_seq_def_t *p_def;  // NULL when idle
+    uint8_t step;
+    uint32_t remaining;          // Ticks left in the current step
+} led_seq_channel_t;
+
+static const uint16_t m_boot_steps[] = {
+    DOT_MS, DOT_MS,     // .
+    DASH_MS, DOT_MS,    // -
+    DOT_MS, DOT_MS,     // .
+};
+static const uint16_t m_flash_steps[] = { FLASH_MS };
+
+static const led_seq_def_t m_patterns[LED_SEQ_PATTERN_COUNT] = {
+    [LED_SEQ_BOOT]      = { m_boot_steps,  ARRAY_SIZE(m_boot_steps),  LED_SEQ_BOOT_LED,      1 },
+    [LED_SEQ_HEARTBEAT] = { m_flash_steps, ARRAY_SIZE(m_flash_steps), LED_SEQ_HEARTBEAT_LED, 0 },
+    [LED_SEQ_ANT_RX]    = { m_flash_steps, ARRAY_SIZE(m_flash_steps), LED_SEQ_ANT_RX_LED,    0 },
+    [LED_SEQ_DATA]      = { m_flash_steps, ARRAY_SIZE(m_flash_steps), LED_SEQ_DATA_LED,      0 },
+};
+
+static led_seq_channel_t m_channels[LEDS_NUMBER];
+static deadline_timer_id_t m_timer;
+static bool m_initialized = false;
+static uint32_t m_last_ticks = 0;
+
+static void led_set(uint8_t led, bool on) {
+    if (on) {
+        bsp_board_led_on(led);
+    } else {
+        bsp_board_led_off(led);
+    }
+}
+
+/**
+ * @brief Move every channel forward to now, call with interrupts masked
+ */
+static void advance(void) {
+    uint32_t now = app_timer_cnt_get();
+    uint32_t elapsed = app_timer_cnt_diff_compute(now, m_last_ticks);
+    m_last_ticks = now;
+
+    for (uint8_t led = 0; led < LEDS_NUMBER; led++) {
+        led_seq_channel_t *p_ch = &m_channels[led];
+        uint32_t left = elapsed;
+
+        while (p_ch->p_def != NULL && left >= p_ch->remaining) {
+            left -= p_ch->remaining;
+            p_ch->step++;
+            if (p_ch->step >= p_ch->p_def->step_count) {
+                p_ch->p_def = NULL;
+                led_set(led, false);
+                break;
+            }
+            p_ch->remaining = APP_TIMER_TICKS(p_ch->p_def->p_steps[p_ch->step]);
+            led_set(led, (p_ch->step & 1) == 0);
+        }
+
+        if (p_ch->p_def != NULL) {
+            p_ch->remaining -= left;
+        }
+    }
+}
+
+/**
+ * @brief Wake at the end of the shortest step, call with interrupts masked
+ */
+static void program(void) {
+    bool any = false;
+    uint32_t next = 0;
+
+    for (uint8_t led = 0; led < LEDS_NUMBER; led++) {
+        if (m_channels[led].p_def != NULL && (!any || m_channels[led].remaining < next)) {
+            next = m_channels[led].remaining;
+            any = true;
+        }
+    }
+
+    if (!any) {
+        deadline_timer_stop(m_timer);
+        return;
+    }
+
+    // Round up, an early wake would only find the step still running
+    deadline_timer_start(m_timer, CEIL_DIV(next * 1000, TIMER_TICKS_FREQ), NULL);
+}
+
+static void led_seq_timer_handler(void *p_context) {
+    CRITICAL_REGION_ENTER();
+    advance();
+    program();
+    CRITICAL_REGION_EXIT();
+}
+
+void led_seq_init(void) {
+    ret_code_t err_code = deadline_timer_create(&m_timer, DEADLINE_TIMER_MODE_SINGLE_SHOT,
+                                                LED_SEQ_SLACK_MS, led_seq_timer_handler);
+    APP_ERROR_CHECK(err_code);
+
+    m_last_ticks = app_timer_cnt_get();
+    m_initialized = true;
+}
+
+void led_seq_play(led_seq_pattern_t pattern) {
+    if (!m_initialized || pattern >= LED_SEQ_PATTERN_COUNT) {
+        return;
+    }
+
+    const led_seq_def_t *p_def = &m_patterns[pattern];
+    if (p_def->led >= LEDS_NUMBER) {
+        return;
+    }
+
+    CRITICAL_REGION_ENTER();
+    advance();
+
+    led_seq_channel_t *p_ch = &m_channels[p_def->led];
+    if (p_ch->p_def == NULL || p_ch->p_def->priority <= p_def->priority) {
+        p_ch->p_def = p_def;
+        p_ch->step = 0;
+        p_ch->remaining = APP_TIMER_TICKS(p_def->p_steps[0]);
+        led_set(p_def->led, true);
+        program();
+    }
+    CRITICAL_REGION_EXIT();
+}
+
+void led_seq_stop_all(void) {
+    if (!m_initialized) {
+        return;
+    }
+
+    CRITICAL_REGION_ENTER();
+    for (uint8_t led = 0; led < LEDS_NUMBER; led++) {
+        m_channels[led].p_def = NULL;
+        led_set(led, false);
+    }
+    deadline_timer_stop(m_timer);
+    CRITICAL_REGION_EXIT();
+}
+
+bool led_seq_is_busy(void) {
+    for (uint8_t led = 0; led < LEDS_NUMBER; led++) {
+        if (m_channels[led].p_def != NULL) {
+            return true;
+        }
+    }
+    return false;
+}
@@ -66,6 +66,10 @@
 #include "reed_sensor.h"
 #include "ble_setup.h"
 #include "ble_custom_config.h"
+#include "device_info.h"
+#ifdef BONDING_ENABLE
+#include "ble_bonding.h"
+#endif
 #include "nfc_handler.h"
 #include "boards.h"
 #include "nrf_delay.h"
@@ -75,10 +79,14 @@
 #include "includes/ble_bridge.h"
 #include "includes/cycling_data_model.h"
 #include "includes/data_source.h"
-
-// Shutdown timer
-APP_TIMER_DEF(m_shutdown_timer);
-APP_TIMER_DEF(m_ble_delay_timer);
+#include "includes/profiler.h"
+#include "includes/diagnostics.h"
+#include "includes/crash_log.h"
+#include "includes/deadline_timer.h"
+#include "includes/led_sequencer.h"
+#include "includes/boot_profile.h"
+#include "includes/presence_wake.h"
+#include "ant/ant_bpwr_tx.h"
 
 /**@brief Callback function for asserts in the SoftDevice.
  *
@@ -103,41 +111,27 @@ void assert_nrf_callback(uint16_t line_num, const uint8_t * p_file_name)
 void enter_deep_sleep(void)
 {
     // Turn off all LEDs before sleep
-    for (int i = 0; i < LEDS_NUMBER; ++i) {
-        bsp_board_led_off(i);
-    }
+    led_seq_stop_all();
+
+    diagnostics_sleep_entry();
+
+#ifdef PRESENCE_WAKE_ENABLED
+    // Does not return once a meter was acquired, until then only the reed switch can wake
+    (void)presence_wake_enter();
+#endif
 
     // Enable reed sensor for wake
     reed_sensor_enable();
 
+    // Keep the no-init RAM at the top of RAM (RAM8 section 5) for the ANT+ channel cache
+    (void)sd_power_ram_power_set(8, POWER_RAM_POWER_S5RETENTION_Msk);
+
     // Enter Deep Sleep
     NRF_LOG_INFO("🛑 System entering deep sleep. Waiting for flywheel movement...");
     nrf_gpio_cfg_sense_input(REED_SWITCH_PIN, NRF_GPIO_PIN_PULLUP, NRF_GPIO_PIN_SENSE_LOW);
     sd_power_system_off();
 }
 
-/**
- * @brief Timer handler for delayed shutdown
- */
-static void shutdown_timer_handler(void * p_context)
-{
-    // If no BLE connection after timeout, shut down
-    if (m_conn_handle == BLE_CONN_HANDLE_INVALID) 
-    {
-        NRF_LOG_INFO("No BLE connection after timeout. Shutting down...");
-        
-        // Stop all components
-        ble_bridge_stop();
-        data_manager_stop_collection();
-
-        enter_deep_sleep();
-    }
-    else
-    {
-        NRF_LOG_INFO("BLE is still connected; delaying shutdown...");
-    }
-}
-
 /**
  * @brief Timer initialization.
  */
@@ -147,44 +141,22 @@ static void timers_init(void)
     uint32_t err_code = app_timer_init();
     APP_ERROR_CHECK(err_code);
 
-    // Create shutdown timer
-    err_code = app_timer_create(&m_shutdown_timer, APP_TIMER_MODE_SINGLE_SHOT, shutdown_timer_handler);
-    APP_ERROR_CHECK(err_code);
-
-    // Create BLE delay timer
-    err_code = app_timer_create(&m_ble_delay_timer, APP_TIMER_MODE_REPEATED, shutdown_timer_handler);
-    APP_ERROR_CHECK(err_code);
-}
-
-#define DOT_DURATION     200
-#define DASH_DURATION    (DOT_DURATION * 3)
-#define SYMBOL_PAUSE     DOT_DURATION
-
-void morse_dot(void) {
-    bsp_board_led_on(BSP_BOARD_LED_0);
-    nrf_delay_ms(DOT_DURATION);
-    bsp_board_led_off(BSP_BOARD_LED_0);
-    nrf_delay_ms(SYMBOL_PAUSE);
+    // Tolerant timers share one app_timer, see deadline_timer.h
+    deadline_timer_init();
 }
 
-void morse_dash(void) {
-    bsp_board_led_on(BSP_BOARD_LED_0);
-    nrf_delay_ms(DASH_DURATION);
-    bsp_board_led_off(BSP_BOARD_LED_0);
-    nrf_delay_ms(SYMBOL_PAUSE);
-}
-
-void morse_r(void) {
-    morse_dot();    // .
-    morse_dash();   // -
-    morse_dot();    // .
-}
-
-// Callback for cycling data updates
-static void cycling_data_callback(cycling_data_t data)
+/**@brief Start the configured backup source next to the main one, failures are not fatal.
+ */
+static void backup_source_start(void)
 {
-    // Forward data to BLE bridge
-    ble_bridge_update_data(data);
+    if (m_backup_source_type == DATA_SOURCE_NONE || m_backup_source_type == m_data_source_type) {
+        return;
+    }
+
+    NRF_LOG_INFO("🔧 Adding backup data source type %d", m_backup_source_type);
+    if (!data_manager_add_data_source(m_backup_source_type, m_backup_device_id, 1)) {
+        NRF_LOG_WARNING("⚠️ Backup data source not started, running without failover");
+    }
 }
 
 /**@brief Application main function.
@@ -193,7 +165,6 @@ int main(void)
 {
     bsp_board_init(BSP_INIT_LEDS);
     bsp_board_leds_off();  // Turn off all LEDs
-    morse_r();  // Flash ".-." (R) on LED_1
 
     uint32_t err_code;
 
@@ -202,24 +173,45 @@ int main(void)
     NRF_LOG_DEFAULT_BACKENDS_INIT();
 
     timers_init();
+    boot_profile_mark(BOOT_PHASE_TIMERS);
+    led_seq_init();
+    led_seq_play(LED_SEQ_BOOT);  // Flash ".-." (R) while the radio comes up
+    profiler_init();
+    diagnostics_init();
+    crash_log_init();
     err_code = nrf_pwr_mgmt_init();
     APP_ERROR_CHECK(err_code);
 
     softdevice_setup();  // Initializes BLE and ANT+ stacks
+    boot_profile_mark(BOOT_PHASE_SOFTDEVICE);
 
-    // Initialize FDS first
-    custom_service_init();  // Initialize FDS
+    // Only returns on a normal boot or once the meter is heard again
+    presence_wake_run();
+
+    // FDS scans its flash pages in the background while the GATT table is built
+    custom_service_init();
+    boot_profile_mark(BOOT_PHASE_FDS_STARTED);
 
     reed_sensor_init(NULL);
 
-    // Initialize BLE stack components
+    // Initialize BLE stack components that need no configuration
     gatt_init();
+    services_init();
+    boot_profile_mark(BOOT_PHASE_GATT_TABLE);
+
+    // Name, advertising data and the mode specific services come from the configuration
+    custom_service_wait_ready();
+    boot_profile_mark(BOOT_PHASE_FDS_READY);
     gap_params_init();
     advertising_init();
-    services_init();
+    services_config_init();
     conn_params_init();
+    boot_profile_mark(BOOT_PHASE_ADV_INIT);
 
 #ifdef BONDING_ENABLE
+    // Needs FDS, the bonded centrals are known before the first advertisement.
+    // Only the LEDs are configured at boot, an unconfigured button pin reads low, as pressed.
+    bsp_board_init(BSP_INIT_BUTTONS);
     bool erase_bonds = bsp_button_is_pressed(BOND_DELETE_ALL_BUTTON_ID);
     peer_manager_init(erase_bonds);
     if (erase_bonds) {
@@ -247,9 +239,6 @@ int main(void)
         return -1;
     }
     
-    // Register callback for cycling data updates
-    cycling_data_register_callback(cycling_data_callback);
-    
     // Get device ID from settings
     uint16_t device_id = m_ant_device_id;
         
@@ -279,8 +268,83 @@ int main(void)
                 return -1;
             }
             
+            backup_source_start();
+
+            // Re-broadcast the bike as an ANT+ power meter for head units, under its own device number
+            if (m_ant_tx_enabled) {
+                uint16_t tx_device_id = m_ant_tx_device_id ? m_ant_tx_device_id : get_ant_device_number();
+                NRF_LOG_INFO("📡 ANT+ power re-broadcast as device %d", tx_device_id);
+                ant_bpwr_tx_start(tx_device_id);
+            }
+
             // Start BLE bridge
             ble_bridge_start();
+        } else if (m_data_source_type == DATA_SOURCE_BLE_PROPRIETARY) {
+            NRF_LOG_INFO("🔧 Using BLE Cycling Power / FTMS sensor");
+
+            if (!data_manager_set_data_source(DATA_SOURCE_BLE_PROPRIETARY, device_id)) {
+                NRF_LOG_ERROR("Failed to set BLE sensor data source");
+                return -1;
+            }
+
+            if (!data_manager_start_collection()) {
+                NRF_LOG_ERROR("Failed to start data collection");
+                return -1;
+            }
+
+            backup_source_start();
+
+            // Start BLE bridge
+            ble_bridge_start();
+        } else if (m_data_source_type == DATA_SOURCE_REED) {
+            NRF_LOG_INFO("🔧 Using reed sensor cadence");
+
+            if (!data_manager_set_data_source(DATA_SOURCE_REED, device_id)) {
+                NRF_LOG_ERROR("Failed to set reed sensor data source");
+                return -1;
+            }
+
+            if (!data_manager_start_collection()) {
+                NRF_LOG_ERROR("Failed to start data collection");
+                return -1;
+            }
+
+            backup_source_start();
+
+            // Start BLE bridge
+            ble_bridge_start();
+        } else if (m_data_source_type == DATA_SOURCE_KEISER_GYM) {
+            NRF_LOG_INFO("🔧 Using Keiser M3i gym receiver");
+
+            if (!data_manager_set_data_source(DATA_SOURCE_KEISER_GYM, device_id)) {
+                NRF_LOG_ERROR("Failed to set Keiser gym data source");
+                return -1;
+            }
+
+            if (!data_manager_start_collection()) {
+                NRF_LOG_ERROR("Failed to start data collection");
+                return -1;
+            }
+
+            // Publish the bike table instead of a single rider
+            ble_bridge_set_gym_mode(true);
+            ble_bridge_start();
+        } else if (m_data_source_type == DATA_SOURCE_ANT_AGGREGATOR) {
+            NRF_LOG_INFO("🔧 Using ANT+ multi-bike aggregator");
+
+            if (!data_manager_set_data_source(DATA_SOURCE_ANT_AGGREGATOR, device_id)) {
+                NRF_LOG_ERROR("Failed to set ANT+ aggregator data source");
+                return -1;
+            }
+
+            if (!data_manager_start_collection()) {
+                NRF_LOG_ERROR("Failed to start data collection");
+                return -1;
+            }
+
+            // Publish one record per power meter instead of a single rider
+            ble_bridge_set_aggregator_mode(true);
+            ble_bridge_start();
         } else {
             NRF_LOG_INFO("🔧 Using ANT+ data source");
             
@@ -292,6 +356,8 @@ int main(void)
                 if (!data_manager_start_collection()) {
                     NRF_LOG_ERROR("Failed to start data collection");
                 }
+
+                backup_source_start();
                 
                 // Start BLE bridge
                 ble_bridge_start();
@@ -299,6 +365,8 @@ int main(void)
         }
     }
 
+    boot_profile_log();
+
     for (;;)
     {
         if (NRF_LOG_PROCESS() == false)
@@ -0,0 +1,226 @@
+/**
+ * @file presence_wake.c
+ * @brief Implementation of the Low-Power ANT+ Presence Wake
+ */
+
+#include "includes/presence_wake.h"
+#include "common_definitions.h"
+#include "ant/ant_data_source.h"
+#include "reed_sensor.h"
+
+#include "nrf_sdh_ant.h"
+#include "ant_parameters.h"
+#include "ant_interface.h"
+#include "ant_channel_config.h"
+#include "ant_bpwr.h"
+#include "app_timer.h"
+#include "app_error.h"
+#include "nrf_pwr_mgmt.h"
+#include "nrf_log.h"
+#include "nrf_log_ctrl.h"
+#include "nrf.h"
+
+#define PRESENCE_MAGIC  0x9E5E11CE
+
+// Upper bound for the search in 2.5 s units, the window timer closes the channel first
+#define PRESENCE_SEARCH_TIMEOUT  1
+
+typedef enum {
+    PRESENCE_STATE_LISTEN = 1,  // Reset into the listening loop
+    PRESENCE_STATE_WOKEN,       // Reset out of it into a normal boot
+} presence_state_t;
+
+/**
+ * @brief Listening state, survives the resets in and out of the loop
+ */
+typedef struct {
+    uint32_t magic;
+    uint16_t device_id;
+    uint8_t trans_type;
+    uint8_t state;
+    uint32_t listens;  // Windows without the meter
+    uint32_t check;    // Complement of the words above
+} presence_record_t;
+
+static presence_record_t m_record __attribute__((section(".app_noinit")));
+
+APP_TIMER_DEF(m_presence_timer);
+
+static bool m_woke = false;
+static volatile bool m_listening = false;
+static volatile bool m_heard = false;
+static volatile bool m_closed = false;
+static volatile bool m_timer_fired = false;
+
+static void presence_ant_evt_handler(ant_evt_t * p_ant_evt, void * p_context);
+
+NRF_SDH_ANT_OBSERVER(m_presence_observer, APP_ANT_OBSERVER_PRIO, presence_ant_evt_handler, NULL);
+
+static uint32_t record_check(const presence_record_t *p_record) {
+    return ~(p_record->magic ^ ((uint32_t)p_record->device_id | ((uint32_t)p_record->trans_type << 16) |
+                                ((uint32_t)p_record->state << 24)) ^ p_record->listens);
+}
+
+static bool record_valid(void) {
+    return m_record.magic == PRESENCE_MAGIC && m_record.check == record_check(&m_record);
+}
+
+static void record_set_state(presence_state_t state) {
+    m_record.state = state;
+    m_record.magic = PRESENCE_MAGIC;
+    m_record.check = record_check(&m_record);
+}
+
+static void presence_ant_evt_handler(ant_evt_t * p_ant_evt, void * p_context) {
+    if (!m_listening || p_ant_evt->channel != PRESENCE_WAKE_CHANNEL) {
+        return;
+    }
+
+    switch (p_ant_evt->event) {
+        case EVENT_RX:
+            m_heard = true;
+            break;
+
+        case EVENT_CHANNEL_CLOSED:
+            m_closed = true;
+            break;
+
+        default:
+            break;
+    }
+}
+
+static void presence_timer_handler(void *p_context) {
+    m_timer_fired = true;
+}
+
+static void presence_reed_handler(void) {
+    m_heard = true;
+}
+
+/**
+ * @brief Sleep until the flag is set or the meter is heard
+ */
+static void wait_for(volatile bool *p_flag) {
+    while (!*p_flag && !m_heard) {
+        if (NRF_LOG_PROCESS() == false) {
+            nrf_pwr_mgmt_run();
+        }
+    }
+}
+
+static void listen_channel_init(void) {
+    ret_code_t err_code = sd_ant_network_address_set(ANTPLUS_NETWORK_NUMBER, ANT_PLUS_NETWORK_KEY);
+    APP_ERROR_CHECK(err_code);
+
+    ant_channel_config_t channel_config = {
+        .channel_number    = PRESENCE_WAKE_CHANNEL,
+        .channel_type      = CHANNEL_TYPE_SLAVE,
+        .ext_assign        = 0,
+        .rf_freq           = BPWR_ANTPLUS_RF_FREQ,
+        .transmission_type = m_record.trans_type,
+        .device_type       = 11, // ANT+ Bike Power
+        .device_number     = m_record.device_id,
+        .channel_period    = BPWR_MSG_PERIOD,
+        .network_number    = ANTPLUS_NETWORK_NUMBER,
+    };
+    err_code = ant_channel_init(&channel_config);
+    APP_ERROR_CHECK(err_code);
+
+    err_code = sd_ant_channel_search_timeout_set(PRESENCE_WAKE_CHANNEL, PRESENCE_SEARCH_TIMEOUT);
+    APP_ERROR_CHECK(err_code);
+    err_code = sd_ant_channel_low_priority_rx_search_timeout_set(PRESENCE_WAKE_CHANNEL, 0);
+    APP_ERROR_CHECK(err_code);
+}
+
+/**
+ * @brief One search window, true if the meter was heard
+ */
+static bool listen_once(void) {
+    m_closed = false;
+    m_timer_fired = false;
+
+    ret_code_t err_code = sd_ant_channel_open(PRESENCE_WAKE_CHANNEL);
+    APP_ERROR_CHECK(err_code);
+    err_code = app_timer_start(m_presence_timer, APP_TIMER_TICKS(PRESENCE_WAKE_LISTEN_MS), NULL);
+    APP_ERROR_CHECK(err_code);
+
+    wait_for(&m_timer_fired);
+    (void)app_timer_stop(m_presence_timer);
+
+    // The search may have timed out on its own, closing again is harmless
+    (void)sd_ant_channel_close(PRESENCE_WAKE_CHANNEL);
+    wait_for(&m_closed);
+
+    return m_heard;
+}
+
+bool presence_wake_enter(void) {
+    uint16_t device_id;
+    uint8_t trans_type;
+
+    if (!ant_data_source_cached_channel(&device_id, &trans_type)) {
+        return false;
+    }
+
+    m_record.device_id = device_id;
+    m_record.trans_type = trans_type;
+    m_record.listens = 0;
+    record_set_state(PRESENCE_STATE_LISTEN);
+
+    NRF_LOG_INFO("💤 Listening for ANT+ device %d every %d ms", device_id, PRESENCE_WAKE_INTERVAL_MS);
+    NRF_LOG_FINAL_FLUSH();
+
+    // A clean start leaves only the SoftDevice and the RTC running
+    NVIC_SystemReset();
+    return true;
+}
+
+void presence_wake_run(void) {
+    if (!record_valid()) {
+        return;
+    }
+
+    if (m_record.state == PRESENCE_STATE_WOKEN) {
+        m_woke = true;
+        NRF_LOG_INFO("📡 Woken after %d presence listens", m_record.listens);
+        m_record.magic = 0;
+        return;
+    }
+
+    ret_code_t err_code = app_timer_create(&m_presence_timer, APP_TIMER_MODE_SINGLE_SHOT, presence_timer_handler);
+    APP_ERROR_CHECK(err_code);
+
+    // The reed switch still wakes the bridge at once
+    reed_sensor_init(presence_reed_handler);
+    reed_sensor_enable();
+
+    listen_channel_init();
+    m_listening = true;
+
+    while (!listen_once()) {
+        m_record.listens++;
+        record_set_state(PRESENCE_STATE_LISTEN);
+
+        m_timer_fired = false;
+        err_code = app_timer_start(m_presence_timer,
+                                   APP_TIMER_TICKS(PRESENCE_WAKE_INTERVAL_MS - PRESENCE_WAKE_LISTEN_MS), NULL);
+        APP_ERROR_CHECK(err_code);
+        wait_for(&m_timer_fired);
+        (void)app_timer_stop(m_presence_timer);
+
+        if (m_heard) {
+            break;
+        }
+    }
+
+    m_listening = false;
+    NRF_LOG_INFO("📡 Presence heard after %d listens, waking up", m_record.listens);
+    record_set_state(PRESENCE_STATE_WOKEN);
+    NRF_LOG_FINAL_FLUSH();
+    NVIC_SystemReset();
+}
+
+bool presence_wake_woke(void) {
+    return m_woke;
+}
@@ -0,0 +1,92 @@
+/**
+ * @file profiler.c
+ * @brief Implementation of the Cycle Counter Profiler
+ */
+
+#include "includes/profiler.h"
+
+#if PROFILER_ENABLED
+
+#include <string.h>
+#include "nrf.h"
+#include "app_util_platform.h"
+#include "nrf_log.h"
+
+static profile_stats_t m_sections[PROFILE_SECTION_COUNT];
+
+static const char * const m_section_names[PROFILE_SECTION_COUNT] = {
+    "ant_bpwr_evt", "keiser_adv", "cycling_update", "ftms_tick"
+};
+
+void profiler_init(void) {
+    // The counter only runs with the trace block enabled, also without a debugger attached
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    profiler_reset();
+    NRF_LOG_INFO("✅ Profiler enabled (DWT CYCCNT, %u MHz)", SystemCoreClock / 1000000);
+}
+
+uint32_t profiler_cycles(void) {
+    return DWT->CYCCNT;
+}
+
+void profiler_record(profile_section_t section, uint32_t cycles) {
+    profile_stats_t *p_stats = &m_sections[section];
+
+    // floor(log2), zero cycles share the first bin with one cycle
+    uint8_t bin = (cycles == 0) ? 0 : (uint8_t)(31 - __CLZ(cycles));
+    if (bin >= PROFILER_HISTOGRAM_BINS) {
+        bin = PROFILER_HISTOGRAM_BINS - 1;
+    }
+
+    // Handlers run at different priorities, keep the update atomic
+    CRITICAL_REGION_ENTER();
+    p_stats->histogram[bin]++;
+    p_stats->count++;
+    p_stats->total_cycles += cycles;
+    if (cycles < p_stats->min_cycles) {
+        p_stats->min_cycles = cycles;
+    }
+    if (cycles > p_stats->max_cycles) {
+        p_stats->max_cycles = cycles;
+    }
+    CRITICAL_REGION_EXIT();
+}
+
+const profile_stats_t* profiler_get(profile_section_t section) {
+    return &m_sections[section];
+}
+
+void profiler_log(void) {
+    for (uint8_t section = 0; section < PROFILE_SECTION_COUNT; section++) {
+        const profile_stats_t *p_stats = &m_sections[section];
+
+        if (p_stats->count == 0) {
+            NRF_LOG_INFO("📊 %s: no samples", m_section_names[section]);
+            continue;
+        }
+
+        NRF_LOG_INFO("📊 %s: n=%u min=%u avg=%u max=%u cycles",
+                     m_section_names[section], p_stats->count, p_stats->min_cycles,
+                     (uint32_t)(p_stats->total_cycles / p_stats->count), p_stats->max_cycles);
+
+        for (uint8_t bin = 0; bin < PROFILER_HISTOGRAM_BINS; bin++) {
+            if (p_stats->histogram[bin] > 0) {
+                NRF_LOG_INFO("    >= %u cycles: %u", 1UL << bin, p_stats->histogram[bin]);
+            }
+        }
+    }
+}
+
+void profiler_reset(void) {
+    CRITICAL_REGION_ENTER();
+    memset(m_sections, 0, sizeof(m_sections));
+    for (uint8_t section = 0; section < PROFILE_SECTION_COUNT; section++) {
+        m_sections[section].min_cycles = UINT32_MAX;
+    }
+    CRITICAL_REGION_EXIT();
+}
+
+#endif // PROFILER_ENABLED
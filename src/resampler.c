@@ -0,0 +1,77 @@
+/**
+ * @file resampler.c
+ * @brief Implementation of the Fixed-Rate Resampler
+ */
+
+#include "includes/resampler.h"
+#include <string.h>
+#include "app_timer.h"
+#include "includes/timer_ticks.h"
+
+void resampler_init(resampler_t *p_resampler, resampler_mode_t mode, uint16_t delay_ms, uint16_t max_hold_ms) {
+    memset(p_resampler, 0, sizeof(*p_resampler));
+    p_resampler->mode = mode;
+    p_resampler->delay_ms = delay_ms;
+    p_resampler->max_hold_ms = max_hold_ms;
+}
+
+void resampler_push(resampler_t *p_resampler, uint32_t ticks, uint16_t power, uint8_t cadence) {
+    p_resampler->ticks[0] = p_resampler->ticks[1];
+    p_resampler->power[0] = p_resampler->power[1];
+    p_resampler->cadence[0] = p_resampler->cadence[1];
+
+    p_resampler->ticks[1] = ticks;
+    p_resampler->power[1] = power;
+    p_resampler->cadence[1] = cadence;
+
+    if (p_resampler->count < 2) {
+        p_resampler->count++;
+    }
+    p_resampler->fresh = true;
+}
+
+/**
+ * @brief Linear interpolation, back_ms before the newest input of an interval_ms long segment
+ */
+static uint16_t interpolate(uint16_t previous, uint16_t newest, uint32_t back_ms, uint32_t interval_ms) {
+    int32_t delta = (int32_t)newest - (int32_t)previous;
+    return (uint16_t)((int32_t)newest - (delta * (int32_t)back_ms) / (int32_t)interval_ms);
+}
+
+bool resampler_output(resampler_t *p_resampler, uint32_t now_ticks, resampler_sample_t *p_sample) {
+    if (p_resampler->count == 0) {
+        return false;
+    }
+
+    uint32_t since_newest_ms = TICKS_TO_MS(app_timer_cnt_diff_compute(now_ticks, p_resampler->ticks[1]));
+    if (since_newest_ms > p_resampler->max_hold_ms) {
+        return false;
+    }
+
+    p_sample->power = p_resampler->power[1];
+    p_sample->cadence = p_resampler->cadence[1];
+    p_sample->flags = 0;
+
+    if (since_newest_ms >= p_resampler->delay_ms) {
+        // The output time is at or past the newest input
+        if (p_resampler->mode == RESAMPLER_LINEAR ? (since_newest_ms > p_resampler->delay_ms) : !p_resampler->fresh) {
+            p_sample->flags |= RESAMPLER_FLAG_EXTRAPOLATED;
+        }
+    } else if (p_resampler->count == 2) {
+        // The output time lies before the newest input
+        uint32_t back_ms = p_resampler->delay_ms - since_newest_ms;
+        uint32_t interval_ms = TICKS_TO_MS(app_timer_cnt_diff_compute(p_resampler->ticks[1], p_resampler->ticks[0]));
+
+        if (p_resampler->mode == RESAMPLER_LINEAR && back_ms < interval_ms) {
+            p_sample->power = interpolate(p_resampler->power[0], p_resampler->power[1], back_ms, interval_ms);
+            p_sample->cadence = (uint8_t)interpolate(p_resampler->cadence[0], p_resampler->cadence[1], back_ms, interval_ms);
+        } else {
+            // Zero-order hold, or the output time is before the previous input too
+            p_sample->power = p_resampler->power[0];
+            p_sample->cadence = p_resampler->cadence[0];
+        }
+    }
+
+    p_resampler->fresh = false;
+    return true;
+}
@@ -0,0 +1,374 @@
+/**
+ * @file ride_stats.c
+ * @brief Implementation of the Ride Statistics Engine
+ */
+
+#include "includes/ride_stats.h"
+#include <string.h>
+#include "app_timer.h"
+#include "includes/timer_ticks.h"
+#include "app_util.h"
+#include "fds.h"
+#include "nrf_log.h"
+#include "app_error.h"
+
+#define RIDE_STATS_FILE     (0x8012)
+#define RIDE_STATS_REC_KEY  (0x7030)
+
+// Session ID, duration, energy, max, average, normalized, best windows
+STATIC_ASSERT(RIDE_STATS_ENCODED_LEN == 2 + 2 + 2 + 2 + 2 + 2 + 2 * RIDE_STATS_BEST_COUNT);
+
+// Window lengths in seconds, indexed by ride_stats_best_t
+static const uint16_t m_best_window_s[RIDE_STATS_BEST_COUNT] = {5, 60, 300, 1200};
+
+// 1 s power history shared by all windows, each window keeps a running sum over its tail
+static uint16_t m_ring[RIDE_STATS_RING_LEN];
+static uint16_t m_ring_head = 0;                         // Next slot to write
+static uint32_t m_ring_filled = 0;                       // Seconds written since the last reset, saturates
+static uint32_t m_window_sum[RIDE_STATS_BEST_COUNT];
+static uint32_t m_np_sum = 0;                            // Running sum of the last RIDE_STATS_NP_WINDOW_S seconds
+
+// Current 1 s bin
+static uint32_t m_bin_sum = 0;
+static uint16_t m_bin_count = 0;
+static uint32_t m_bin_ms = 0;                            // Time elapsed in the current bin
+static uint16_t m_last_second_power = 0;
+static uint32_t m_last_sample_ticks = 0;
+static bool m_started = false;
+
+// Accumulators
+static uint64_t m_np_fourth_sum = 0;                     // Sum of (30 s average)^4
+static uint32_t m_np_count = 0;
+static ride_stats_summary_t m_current;
+
+// Stored sessions, newest first
+typedef struct {
+    uint8_t count;
+    uint8_t reserved[3];
+    ride_stats_summary_t sessions[RIDE_STATS_MAX_SESSIONS];
+} ride_stats_history_t;
+
+static ride_stats_history_t m_history;
+static ride_stats_history_t m_history_record __attribute__((aligned(4)));  // Buffer handed to FDS
+static uint32_t m_last_save_s = 0;
+static bool m_committed = false;                         // The current session has its slot in m_history
+static bool m_gc_pending = false;                        // A save is waiting for our garbage collection
+
+/**
+ * @brief Integer square root of a 64-bit value
+ */
+static uint32_t isqrt64(uint64_t value) {
+    uint64_t result = 0;
+    uint64_t bit = (uint64_t)1 << 62;
+
+    while (bit > value) {
+        bit >>= 2;
+    }
+
+    while (bit != 0) {
+        if (value >= result + bit) {
+            value -= result + bit;
+            result = (result >> 1) + bit;
+        } else {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+
+    return (uint32_t)result;
+}
+
+/**
+ * @brief Value leaving a window of the given length on the next push
+ *
+ * The ring is cleared on reset, so before a window is filled the value
+ * leaving it is zero.
+ */
+static uint16_t ring_tail(uint16_t window_s) {
+    uint16_t index = (m_ring_head + RIDE_STATS_RING_LEN - window_s) % RIDE_STATS_RING_LEN;
+    return m_ring[index];
+}
+
+/**
+ * @brief Push one second of power into the history and the windows
+ *
+ * @param watts Power of the second
+ * @param riding The second had data (counted for duration, energy and NP)
+ */
+static void close_second(uint16_t watts, bool riding) {
+    // Windows first, the tail is read before its slot may be overwritten
+    for (uint8_t i = 0; i < RIDE_STATS_BEST_COUNT; i++) {
+        m_window_sum[i] += watts;
+        m_window_sum[i] -= ring_tail(m_best_window_s[i]);
+    }
+    m_np_sum += watts;
+    m_np_sum -= ring_tail(RIDE_STATS_NP_WINDOW_S);
+
+    m_ring[m_ring_head] = watts;
+    m_ring_head = (m_ring_head + 1) % RIDE_STATS_RING_LEN;
+    if (m_ring_filled < UINT32_MAX) {
+        m_ring_filled++;
+    }
+
+    for (uint8_t i = 0; i < RIDE_STATS_BEST_COUNT; i++) {
+        if (m_ring_filled >= m_best_window_s[i]) {
+            uint16_t avg = (uint16_t)(m_window_sum[i] / m_best_window_s[i]);
+            if (avg > m_current.best_power[i]) {
+                m_current.best_power[i] = avg;
+            }
+        }
+    }
+
+    if (!riding) {
+        return;
+    }
+
+    m_current.duration_s++;
+    m_current.energy_j += watts;
+
+    if (m_ring_filled >= RIDE_STATS_NP_WINDOW_S) {
+        uint64_t avg30 = m_np_sum / RIDE_STATS_NP_WINDOW_S;
+        m_np_fourth_sum += avg30 * avg30 * avg30 * avg30;
+        m_np_count++;
+    }
+}
+
+/**
+ * @brief Clear the power history, used on reset and after long gaps
+ */
+static void clear_history(void) {
+    memset(m_ring, 0, sizeof(m_ring));
+    memset(m_window_sum, 0, sizeof(m_window_sum));
+    m_ring_head = 0;
+    m_ring_filled = 0;
+    m_np_sum = 0;
+}
+
+/**
+ * @brief Account for the seconds between two samples
+ */
+static void close_elapsed_seconds(uint32_t seconds) {
+    // The first second is the bin that just closed
+    uint16_t watts = (m_bin_count > 0) ? (uint16_t)(m_bin_sum / m_bin_count) : m_last_second_power;
+    close_second(watts, true);
+    m_last_second_power = watts;
+    m_bin_sum = 0;
+    m_bin_count = 0;
+
+    if (seconds <= 1) {
+        return;
+    }
+
+    // Short gaps hold the last value, the rest of the gap counts as stopped
+    uint32_t hold = (seconds - 1 > RIDE_STATS_GAP_HOLD_S) ? RIDE_STATS_GAP_HOLD_S : seconds - 1;
+    for (uint32_t i = 0; i < hold; i++) {
+        close_second(watts, true);
+    }
+
+    uint32_t stopped = seconds - 1 - hold;
+    if (stopped >= RIDE_STATS_RING_LEN) {
+        clear_history();  // Every window is all zeros after this gap
+        m_ring_filled = RIDE_STATS_RING_LEN;
+        stopped = 0;
+    }
+    for (uint32_t i = 0; i < stopped; i++) {
+        close_second(0, false);
+    }
+    m_last_second_power = 0;
+}
+
+void ride_stats_update(uint16_t power_watts) {
+    uint32_t now = app_timer_cnt_get();
+
+    if (power_watts > m_current.max_power) {
+        m_current.max_power = power_watts;
+    }
+
+    if (!m_started) {
+        m_started = true;
+        m_last_sample_ticks = now;
+        m_bin_ms = 0;
+    } else {
+        m_bin_ms += TICKS_TO_MS(app_timer_cnt_diff_compute(now, m_last_sample_ticks));
+        m_last_sample_ticks = now;
+
+        if (m_bin_ms >= 1000) {
+            uint32_t seconds = m_bin_ms / 1000;
+            m_bin_ms %= 1000;
+            close_elapsed_seconds(seconds);
+        }
+    }
+
+    // The sample belongs to the bin it arrived in
+    m_bin_sum += power_watts;
+    m_bin_count++;
+
+    if (m_current.duration_s >= m_last_save_s + RIDE_STATS_SAVE_INTERVAL_S) {
+        m_last_save_s = m_current.duration_s;
+        ride_stats_save();
+    }
+}
+
+const ride_stats_summary_t* ride_stats_get(void) {
+    // Derived values are only computed when read
+    m_current.avg_power = (m_current.duration_s > 0) ? (uint16_t)(m_current.energy_j / m_current.duration_s) : 0;
+    m_current.normalized_power = (m_np_count > 0) ? (uint16_t)isqrt64(isqrt64(m_np_fourth_sum / m_np_count)) : 0;
+    return &m_current;
+}
+
+const ride_stats_summary_t* ride_stats_get_stored(uint8_t index) {
+    if (index >= m_history.count) {
+        return NULL;
+    }
+    return &m_history.sessions[index];
+}
+
+void ride_stats_reset(void) {
+    // A session that already has a slot keeps it, the next one gets a new ID
+    uint16_t session_id = m_committed ? m_current.session_id + 1 : m_current.session_id;
+
+    clear_history();
+    memset(&m_current, 0, sizeof(m_current));
+    m_current.session_id = session_id;
+    m_bin_sum = 0;
+    m_bin_count = 0;
+    m_bin_ms = 0;
+    m_last_second_power = 0;
+    m_np_fourth_sum = 0;
+    m_np_count = 0;
+    m_last_save_s = 0;
+    m_started = false;
+    m_committed = false;
+}
+
+uint16_t ride_stats_encode(const ride_stats_summary_t *p_summary, uint8_t *p_buf) {
+    uint16_t energy_kj = (p_summary->energy_j / 1000 > 0xFFFF) ? 0xFFFF : (uint16_t)(p_summary->energy_j / 1000);
+    uint16_t duration_s = (p_summary->duration_s > 0xFFFF) ? 0xFFFF : (uint16_t)p_summary->duration_s;
+    uint8_t i = 0;
+
+    p_buf[i++] = (uint8_t)(p_summary->session_id & 0xFF);
+    p_buf[i++] = (uint8_t)(p_summary->session_id >> 8);
+    p_buf[i++] = (uint8_t)(duration_s & 0xFF);
+    p_buf[i++] = (uint8_t)(duration_s >> 8);
+    p_buf[i++] = (uint8_t)(energy_kj & 0xFF);
+    p_buf[i++] = (uint8_t)(energy_kj >> 8);
+    p_buf[i++] = (uint8_t)(p_summary->max_power & 0xFF);
+    p_buf[i++] = (uint8_t)(p_summary->max_power >> 8);
+    p_buf[i++] = (uint8_t)(p_summary->avg_power & 0xFF);
+    p_buf[i++] = (uint8_t)(p_summary->avg_power >> 8);
+    p_buf[i++] = (uint8_t)(p_summary->normalized_power & 0xFF);
+    p_buf[i++] = (uint8_t)(p_summary->normalized_power >> 8);
+    for (uint8_t b = 0; b < RIDE_STATS_BEST_COUNT; b++) {
+        p_buf[i++] = (uint8_t)(p_summary->best_power[b] & 0xFF);
+        p_buf[i++] = (uint8_t)(p_summary->best_power[b] >> 8);
+    }
+
+    return i;
+}
+
+/**
+ * @brief Write m_history_record, collect garbage once if flash is full
+ *
+ * @param allow_gc False for the retry after our own collection
+ */
+static void write_history(bool allow_gc) {
+    fds_record_t record = {
+        .file_id = RIDE_STATS_FILE,
+        .key = RIDE_STATS_REC_KEY,
+        .data = {
+            .p_data = &m_history_record,
+            .length_words = (sizeof(m_history_record) + 3) / 4,
+        }
+    };
+
+    fds_record_desc_t desc = {0};
+    fds_find_token_t ftok = {0};
+    ret_code_t ret;
+
+    if (fds_record_find(RIDE_STATS_FILE, RIDE_STATS_REC_KEY, &desc, &ftok) == NRF_SUCCESS) {
+        ret = fds_record_update(&desc, &record);
+    } else {
+        ret = fds_record_write(&desc, &record);
+    }
+
+    if (ret == FDS_ERR_NO_SPACE_IN_FLASH && allow_gc) {
+        // Every update leaves a dirty record behind, reclaim them and write again
+        ret = fds_gc();
+        m_gc_pending = (ret == NRF_SUCCESS);
+    }
+
+    if (ret != NRF_SUCCESS) {
+        NRF_LOG_WARNING("Ride Stats: Failed to save session %d: %d", m_current.session_id, ret);
+    }
+}
+
+void ride_stats_save(void) {
+    // Sessions without riding would push real rides out of the history
+    if (m_current.duration_s == 0) {
+        return;
+    }
+
+    // Newest session first, the current session replaces its own earlier save
+    if (!m_committed) {
+        memmove(&m_history.sessions[1], &m_history.sessions[0],
+                sizeof(ride_stats_summary_t) * (RIDE_STATS_MAX_SESSIONS - 1));
+        if (m_history.count < RIDE_STATS_MAX_SESSIONS) {
+            m_history.count++;
+        }
+        m_committed = true;
+    }
+    m_history.sessions[0] = *ride_stats_get();
+    m_history_record = m_history;
+
+    write_history(true);
+}
+
+static void fds_evt_handler(fds_evt_t const *p_evt) {
+    if ((p_evt->id == FDS_EVT_WRITE || p_evt->id == FDS_EVT_UPDATE) &&
+        p_evt->write.record_key == RIDE_STATS_REC_KEY) {
+        NRF_LOG_INFO("Ride Stats: Session %s", (p_evt->result == NRF_SUCCESS) ? "stored" : "write failed");
+    }
+
+    // Other modules collect garbage as well, only a collection we asked for retries the save
+    if (p_evt->id == FDS_EVT_GC && m_gc_pending) {
+        m_gc_pending = false;
+        if (p_evt->result == NRF_SUCCESS) {
+            write_history(false);
+        } else {
+            NRF_LOG_WARNING("Ride Stats: Garbage collection failed: %d", p_evt->result);
+        }
+    }
+}
+
+void ride_stats_init(void) {
+    memset(&m_history, 0, sizeof(m_history));
+
+    uint32_t err_code = fds_register(fds_evt_handler);
+    APP_ERROR_CHECK(err_code);
+
+    fds_record_desc_t desc = {0};
+    fds_find_token_t ftok = {0};
+    if (fds_record_find(RIDE_STATS_FILE, RIDE_STATS_REC_KEY, &desc, &ftok) == NRF_SUCCESS) {
+        fds_flash_record_t record;
+        if (fds_record_open(&desc, &record) == NRF_SUCCESS) {
+            // A record of another layout is dropped rather than misread
+            if (record.p_header->length_words == (sizeof(m_history) + 3) / 4) {
+                memcpy(&m_history, record.p_data, sizeof(m_history));
+            } else {
+                NRF_LOG_WARNING("Ride Stats: Stored history has %d words, ignored", record.p_header->length_words);
+            }
+            fds_record_close(&desc);
+        }
+        if (m_history.count > RIDE_STATS_MAX_SESSIONS) {
+            m_history.count = 0;
+        }
+    }
+
+    // The new session only takes a slot on its first save, see ride_stats_save()
+    uint16_t session_id = (m_history.count > 0) ? m_history.sessions[0].session_id + 1 : 1;
+    m_current.session_id = session_id;
+    m_committed = false;
+    ride_stats_reset();
+
+    NRF_LOG_INFO("Ride Stats: Session %d, %d stored", session_id, m_history.count);
+}
@@ -0,0 +1,174 @@
+/**
+ * @file sample_filter.c
+ * @brief Implementation of the Sample Filter
+ */
+
+#include "includes/sample_filter.h"
+#include <string.h>
+
+#define CAS(a, b) do { if ((a) > (b)) { uint16_t t_ = (a); (a) = (b); (b) = t_; } } while (0)
+
+/**
+ * @brief Median of 3, sorting network
+ */
+static uint16_t median3(uint16_t a, uint16_t b, uint16_t c) {
+    CAS(a, b);
+    CAS(b, c);
+    CAS(a, b);
+    return b;
+}
+
+/**
+ * @brief Median of 5, 9 comparator sorting network, sorts v in place
+ */
+static uint16_t median5(uint16_t v[5]) {
+    CAS(v[0], v[1]);
+    CAS(v[3], v[4]);
+    CAS(v[2], v[4]);
+    CAS(v[2], v[3]);
+    CAS(v[0], v[3]);
+    CAS(v[0], v[2]);
+    CAS(v[1], v[4]);
+    CAS(v[1], v[3]);
+    CAS(v[1], v[2]);
+    return v[2];
+}
+
+/**
+ * @brief Distance between two samples
+ */
+static uint16_t abs_diff(uint16_t a, uint16_t b) {
+    return (a > b) ? (a - b) : (b - a);
+}
+
+/**
+ * @brief Sample written n steps before the newest one
+ */
+static uint16_t window_back(const sample_filter_field_t *p_field, uint8_t n) {
+    return p_field->window[(p_field->index + SAMPLE_FILTER_WINDOW - 1 - n) % SAMPLE_FILTER_WINDOW];
+}
+
+/**
+ * @brief Drop isolated single-sample spikes
+ *
+ * A sample that jumps more than min_deviation from the last output is
+ * held back for one sample. If the next sample is back on the side of
+ * the last output, the held one differed from both neighbours in the
+ * same direction and is dropped; otherwise it was a real step and the
+ * newest sample passes. Smaller changes, starting from zero and stopping
+ * to zero pass at once, so only a large jump is delayed, by one sample.
+ */
+static uint16_t spike_reject(sample_filter_field_t *p_field,
+                             const sample_filter_field_config_t *p_config,
+                             uint16_t value,
+                             sample_filter_stats_t *p_stats) {
+    uint16_t previous = p_field->last_output;
+
+    if (p_field->has_pending) {
+        uint16_t held = p_field->pending;
+        p_field->has_pending = false;
+
+        // Outside both neighbours by more than the threshold, on the same side
+        uint16_t low = (previous < value) ? previous : value;
+        uint16_t high = (previous < value) ? value : previous;
+        bool spike = (held > high && held - high > p_config->min_deviation) ||
+                     (held < low && low - held > p_config->min_deviation);
+        if (!spike) {
+            return value;
+        }
+        p_stats->outliers++;
+    }
+
+    if (value != 0 && previous != 0 && abs_diff(value, previous) > p_config->min_deviation) {
+        p_field->pending = value;
+        p_field->has_pending = true;
+        return previous;
+    }
+    return value;
+}
+
+/**
+ * @brief Run one field through range check, robust filter and slew limit
+ */
+static uint16_t filter_field(sample_filter_field_t *p_field,
+                             const sample_filter_field_config_t *p_config,
+                             uint16_t value,
+                             uint32_t dt_ms,
+                             sample_filter_stats_t *p_stats) {
+    // Implausible values never enter the window
+    if (p_config->max_value != 0 && value > p_config->max_value) {
+        p_stats->out_of_range++;
+        return p_field->last_output;
+    }
+
+    p_field->window[p_field->index] = value;
+    p_field->index = (p_field->index + 1) % SAMPLE_FILTER_WINDOW;
+    if (p_field->count < SAMPLE_FILTER_WINDOW) {
+        p_field->count++;
+    }
+
+    // Samples pass unfiltered until the window is filled
+    uint16_t output = value;
+    switch (p_config->mode) {
+        case SAMPLE_FILTER_MEDIAN3:
+            if (p_field->count >= 3) {
+                output = median3(window_back(p_field, 0), window_back(p_field, 1), window_back(p_field, 2));
+                if (abs_diff(output, value) > p_config->min_deviation) {
+                    p_stats->outliers++;
+                }
+            }
+            break;
+
+        case SAMPLE_FILTER_MEDIAN5:
+            if (p_field->count >= SAMPLE_FILTER_WINDOW) {
+                uint16_t sorted[SAMPLE_FILTER_WINDOW];
+                memcpy(sorted, p_field->window, sizeof(sorted));
+                output = median5(sorted);
+                if (abs_diff(output, value) > p_config->min_deviation) {
+                    p_stats->outliers++;
+                }
+            }
+            break;
+
+        case SAMPLE_FILTER_SPIKE:
+            if (p_field->count > 1) {
+                output = spike_reject(p_field, p_config, value, p_stats);
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    // Power and cadence can drop to zero at once but only build up so fast
+    if (p_config->max_rise_per_s != 0 && p_field->count > 1 && output > p_field->last_output) {
+        uint32_t max_step = ((uint32_t)p_config->max_rise_per_s * dt_ms) / 1000;
+        if ((uint32_t)(output - p_field->last_output) > max_step) {
+            output = (uint16_t)(p_field->last_output + max_step);
+            p_stats->slew_limited++;
+        }
+    }
+
+    p_field->last_output = output;
+    return output;
+}
+
+void sample_filter_init(sample_filter_t *p_filter, const sample_filter_config_t *p_config) {
+    memset(p_filter, 0, sizeof(*p_filter));
+    p_filter->p_config = p_config;
+}
+
+void sample_filter_reset(sample_filter_t *p_filter) {
+    memset(&p_filter->power, 0, sizeof(p_filter->power));
+    memset(&p_filter->cadence, 0, sizeof(p_filter->cadence));
+}
+
+void sample_filter_apply(sample_filter_t *p_filter, uint16_t *p_power, uint8_t *p_cadence, uint32_t dt_ms) {
+    if (p_filter->p_config == NULL) {
+        return;
+    }
+
+    *p_power = filter_field(&p_filter->power, &p_filter->p_config->power, *p_power, dt_ms, &p_filter->stats);
+    *p_cadence = (uint8_t)filter_field(&p_filter->cadence, &p_filter->p_config->cadence, *p_cadence, dt_ms,
+                                       &p_filter->stats);
+}
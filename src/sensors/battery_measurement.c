@@ -8,9 +8,11 @@
 #include "app_error.h"
 #include "app_timer.h"
 #include "battery_measurement.h"
+#include "includes/deadline_timer.h"
 
 // 🛠 Configuration Constants
-#define BATTERY_LEVEL_MEAS_INTERVAL     APP_TIMER_TICKS(60000)  // Battery check every 30s
+#define BATTERY_LEVEL_MEAS_INTERVAL     60000   // Battery check every 60s
+#define BATTERY_LEVEL_MEAS_SLACK        30000   // May run up to 30s late, on another wake-up
 #define ADC_REF_VOLTAGE_IN_MILLIVOLTS   600   // Internal reference voltage (600mV)
 #define ADC_PRE_SCALING_COMPENSATION    6     // 1/6 prescaler for up to 3.6V
 #define BATTERY_MAX_MILLIVOLTS 3000  // ✅ AA Batteries Full (3.0V)
@@ -20,7 +22,7 @@
 #define BATTERY_ADC_CHANNEL             0
 
 // 🔄 Battery measurement timer
-APP_TIMER_DEF(m_battery_timer_id);
+static deadline_timer_id_t m_battery_timer_id;
 
 // 🔋 Battery State
 static uint8_t m_battery_level_percent = 100;
@@ -44,14 +46,14 @@ void battery_monitoring_init(void)
     saadc_init();
 
     // ✅ Create Timer for Periodic Measurement
-    err_code = app_timer_create(&m_battery_timer_id,
-                                APP_TIMER_MODE_REPEATED,
-                                battery_level_meas_timeout_handler);
+    err_code = deadline_timer_create(&m_battery_timer_id,
+                                     DEADLINE_TIMER_MODE_REPEATED,
+                                     BATTERY_LEVEL_MEAS_SLACK,
+                                     battery_level_meas_timeout_handler);
     APP_ERROR_CHECK(err_code);
 
     // ✅ Start Battery Measurement Timer (Every BATTERY_LEVEL_MEAS_INTERVAL s)
-    err_code = app_timer_start(m_battery_timer_id, BATTERY_LEVEL_MEAS_INTERVAL, NULL);
-    APP_ERROR_CHECK(err_code);
+    deadline_timer_start(m_battery_timer_id, BATTERY_LEVEL_MEAS_INTERVAL, NULL);
 
     // ✅ Perform Initial Measurement
     battery_level_measure();
@@ -170,7 +172,7 @@ uint16_t get_battery_voltage(void)
 void battery_monitoring_uninit(void)
 {
     // ✅ Stop Timer
-    app_timer_stop(m_battery_timer_id);
+    deadline_timer_stop(m_battery_timer_id);
 
     // ✅ Uninitialize SAADC
     if (adc_initialized) {
@@ -0,0 +1,142 @@
+/**
+ * @file reed_data_source.c
+ * @brief Implementation of the Reed Sensor Data Source
+ */
+
+#include "reed_data_source.h"
+#include "reed_sensor.h"
+#include "includes/data_bus.h"
+#include "includes/deadline_timer.h"
+#include "app_timer.h"
+#include "nrf_log.h"
+#include "app_error.h"
+
+static deadline_timer_id_t m_window_timer;
+
+static data_source_config_t m_config;
+static bool m_running = false;
+
+// State at the end of the previous window
+static uint32_t m_prev_pulses = 0;
+static uint32_t m_prev_pulse_ticks = 0;
+static bool m_have_reference = false;
+static uint32_t m_pulse_rate_mhz = 0;  // Pulses per 1000 s
+
+/**
+ * @brief Pulse rate over the pulses of one window
+ *
+ * Measured between the first and last accepted pulse edge, so the result
+ * does not depend on where the window boundaries fall.
+ */
+static uint32_t pulse_rate_mhz(uint32_t pulses, uint32_t period_ticks) {
+    if (period_ticks == 0) {
+        return 0;
+    }
+    return (uint32_t)(((uint64_t)pulses * 1000 * REED_TIMER_TICKS_PER_S) / period_ticks);
+}
+
+/**
+ * @brief Aggregation window handler, the only CPU work of this source
+ */
+static void window_timer_handler(void * p_context) {
+    uint32_t pulses;
+    uint32_t last_pulse_ticks;
+
+    if (!m_running || !reed_sensor_measurement_read(&pulses, &last_pulse_ticks)) {
+        return;
+    }
+
+    uint32_t new_pulses = pulses - m_prev_pulses;
+    uint32_t since_last_ms = (uint32_t)(((uint64_t)(reed_sensor_measurement_now() - last_pulse_ticks) * 1000) /
+                                        REED_TIMER_TICKS_PER_S);
+
+    if (new_pulses > 0) {
+        if (m_have_reference) {
+            m_pulse_rate_mhz = pulse_rate_mhz(new_pulses, last_pulse_ticks - m_prev_pulse_ticks);
+        }
+        // The first pulse after a stop only sets the reference edge
+        m_have_reference = true;
+    } else if (!m_have_reference || since_last_ms >= REED_STOP_TIMEOUT_MS) {
+        m_pulse_rate_mhz = 0;
+        m_have_reference = false;
+    } else {
+        // No pulse yet: the rate is at most one pulse over the time since the last one
+        uint32_t bound = (uint32_t)(1000000UL / (since_last_ms ? since_last_ms : 1));
+        if (m_pulse_rate_mhz > bound) {
+            m_pulse_rate_mhz = bound;
+        }
+    }
+
+    m_prev_pulses = pulses;
+    m_prev_pulse_ticks = last_pulse_ticks;
+
+    uint8_t cadence = (uint8_t)((m_pulse_rate_mhz * 60) / (1000 * REED_PULSES_PER_CRANK_REV));
+    uint16_t speed_kmh_x100 = (uint16_t)(((uint64_t)m_pulse_rate_mhz * REED_DISTANCE_PER_PULSE_MM * 36) / 100000);
+
+    NRF_LOG_DEBUG("🧲 Reed: %d pulses, %d RPM, %d.%02d km/h", new_pulses, cadence,
+                  speed_kmh_x100 / 100, speed_kmh_x100 % 100);
+
+    // No power from a reed switch, the data manager only takes cadence from this source
+    if (m_config.data_callback != NULL) {
+        m_config.data_callback(0, cadence, app_timer_cnt_get());
+    }
+    data_bus_publish_speed(speed_kmh_x100);
+}
+
+static bool reed_source_init(data_source_config_t* config) {
+    if (config == NULL || config->type != DATA_SOURCE_REED) {
+        NRF_LOG_ERROR("Invalid reed sensor configuration");
+        return false;
+    }
+
+    m_config = *config;
+
+    uint32_t err_code = deadline_timer_create(&m_window_timer, DEADLINE_TIMER_MODE_REPEATED,
+                                              REED_WINDOW_SLACK_MS, window_timer_handler);
+    APP_ERROR_CHECK(err_code);
+
+    NRF_LOG_INFO("Reed Sensor Data Source: Initialized");
+    return true;
+}
+
+static bool reed_source_start(void) {
+    if (!reed_sensor_measurement_start(REED_DEBOUNCE_MS)) {
+        return false;
+    }
+
+    m_have_reference = false;
+    m_pulse_rate_mhz = 0;
+    (void)reed_sensor_measurement_read(&m_prev_pulses, &m_prev_pulse_ticks);
+
+    deadline_timer_start(m_window_timer, REED_WINDOW_MS, NULL);
+
+    m_running = true;
+    return true;
+}
+
+static void reed_source_stop(void) {
+    m_running = false;
+    deadline_timer_stop(m_window_timer);
+    reed_sensor_measurement_stop();
+    NRF_LOG_INFO("🛑 Reed Sensor Data Source: Stopped");
+}
+
+/**
+ * @brief A wired sensor has no link to lose, a stopped crank reports zero cadence
+ */
+static bool reed_source_is_active(void) {
+    return m_running;
+}
+
+// Define the reed sensor data source interface
+static const data_source_interface_t reed_source_interface = {
+    .init = reed_source_init,
+    .start = reed_source_start,
+    .stop = reed_source_stop,
+    .is_active = reed_source_is_active
+};
+
+// Public function to get the reed sensor interface
+const data_source_interface_t* reed_data_source_get_interface(void) {
+    return &reed_source_interface;
+}
@@ -0,0 +1,28 @@
+/**
+ * @file reed_data_source.h
+ * @brief Reed Sensor Cadence / Speed Data Source
+ *
+ * Zero-radio data source: counts reed switch pulses in hardware and
+ * reports cadence and speed once per aggregation window.
+ */
+
+#ifndef REED_DATA_SOURCE_H
+#define REED_DATA_SOURCE_H
+
+#include "includes/data_source.h"
+
+#define REED_WINDOW_MS               1000  // CPU wakes once per window, not per pulse
+#define REED_WINDOW_SLACK_MS         100   // Rates come from pulse edges, a late window only delays the report
+#define REED_DEBOUNCE_MS             10    // Contact bounce is ignored for this long after a pulse (max 100 Hz)
+#define REED_STOP_TIMEOUT_MS         3000  // Report zero after this long without a pulse
+#define REED_PULSES_PER_CRANK_REV    1     // Magnet on the crank; use the gear ratio for a flywheel magnet
+#define REED_DISTANCE_PER_PULSE_MM   2096  // Virtual wheel travel per pulse (700x23c circumference)
+
+/**
+ * @brief Get the reed sensor data source interface
+ *
+ * @return data_source_interface_t* Pointer to the reed sensor data source interface
+ */
+const data_source_interface_t* reed_data_source_get_interface(void);
+
+#endif /* REED_DATA_SOURCE_H */
@@ -1,9 +1,27 @@
 #include "reed_sensor.h"
 #include "app_error.h"
 #include "nrf_log.h"
+#include "nrfx_timer.h"
+#include "nrfx_ppi.h"
+#include "app_util_platform.h"
 
 static reed_sensor_callback_t sensor_callback = NULL;
 
+// Hardware pulse measurement, no CPU involvement per pulse:
+//   reed IN event -> counter COUNT + timestamp CAPTURE0  (gated channel)
+//   reed IN event -> gate group DISABLE + debounce START (gated channel)
+//   debounce COMPARE0 -> gate group ENABLE, debounce timer stops and clears itself
+static const nrfx_timer_t m_debounce_timer = NRFX_TIMER_INSTANCE(REED_DEBOUNCE_TIMER_INSTANCE);
+static const nrfx_timer_t m_counter_timer = NRFX_TIMER_INSTANCE(REED_COUNTER_TIMER_INSTANCE);
+static const nrfx_timer_t m_timestamp_timer = NRFX_TIMER_INSTANCE(REED_TIMESTAMP_TIMER_INSTANCE);
+
+static nrf_ppi_channel_t m_ppi_count;
+static nrf_ppi_channel_t m_ppi_gate;
+static nrf_ppi_channel_t m_ppi_reopen;
+static nrf_ppi_channel_group_t m_ppi_group;
+
+static bool m_measuring = false;
+
 void reed_switch_handler(nrf_drv_gpiote_pin_t pin, nrf_gpiote_polarity_t action)
 {
     NRF_LOG_INFO("🚴 Flywheel movement detected!");
@@ -14,6 +32,11 @@ void reed_switch_handler(nrf_drv_gpiote_pin_t pin, nrf_gpiote_polarity_t action)
     }
 }
 
+// Timers only run from PPI, their interrupts are never enabled
+static void reed_timer_handler(nrf_timer_event_t event_type, void * p_context)
+{
+}
+
 void reed_sensor_init(reed_sensor_callback_t callback)
 {
     ret_code_t err_code;
@@ -29,12 +52,16 @@ void reed_sensor_init(reed_sensor_callback_t callback)
 
 void reed_sensor_enable(void)
 {
-    nrf_drv_gpiote_in_config_t config = GPIOTE_CONFIG_IN_SENSE_HITOLO(true);
+    // The pin can only have one GPIOTE configuration
+    reed_sensor_measurement_stop();
+
+    // PORT event, an IN event channel would keep the high frequency clock running in System ON
+    nrf_drv_gpiote_in_config_t config = GPIOTE_CONFIG_IN_SENSE_HITOLO(false);
     config.pull = NRF_GPIO_PIN_PULLUP;
 
     ret_code_t err_code = nrf_drv_gpiote_in_init(REED_SWITCH_PIN, &config, reed_switch_handler);
     APP_ERROR_CHECK(err_code);
-    
+
     nrf_drv_gpiote_in_event_enable(REED_SWITCH_PIN, true);
 
     NRF_LOG_INFO("✅ Reed sensor enabled for wake-up.");
@@ -47,3 +74,132 @@ void reed_sensor_disable(void)
 
     NRF_LOG_INFO("🚫 Reed sensor disabled to save power.");
 }
+
+bool reed_sensor_measurement_start(uint16_t debounce_ms)
+{
+    ret_code_t err_code;
+
+    if (m_measuring) {
+        return true;
+    }
+
+    // GPIOTE channel with event only, no interrupt per pulse
+    nrf_drv_gpiote_in_config_t in_config = GPIOTE_CONFIG_IN_SENSE_HITOLO(true);
+    in_config.pull = NRF_GPIO_PIN_PULLUP;
+    err_code = nrf_drv_gpiote_in_init(REED_SWITCH_PIN, &in_config, NULL);
+    if (err_code != NRF_SUCCESS) {
+        NRF_LOG_ERROR("🚨 Reed: GPIOTE init failed: 0x%08X", err_code);
+        return false;
+    }
+
+    nrfx_timer_config_t timer_config = {
+        .frequency          = REED_TIMER_FREQUENCY,
+        .mode               = NRF_TIMER_MODE_TIMER,
+        .bit_width          = NRF_TIMER_BIT_WIDTH_32,
+        .interrupt_priority = APP_IRQ_PRIORITY_LOWEST,
+        .p_context          = NULL,
+    };
+
+    // Debounce one-shot
+    err_code = nrfx_timer_init(&m_debounce_timer, &timer_config, reed_timer_handler);
+    APP_ERROR_CHECK(err_code);
+    nrfx_timer_extended_compare(&m_debounce_timer, NRF_TIMER_CC_CHANNEL0,
+                                ((uint32_t)debounce_ms * REED_TIMER_TICKS_PER_S) / 1000,
+                                NRF_TIMER_SHORT_COMPARE0_STOP_MASK | NRF_TIMER_SHORT_COMPARE0_CLEAR_MASK,
+                                false);
+
+    // Free-running timestamp of the last accepted pulse
+    err_code = nrfx_timer_init(&m_timestamp_timer, &timer_config, reed_timer_handler);
+    APP_ERROR_CHECK(err_code);
+
+    // Pulse counter
+    timer_config.mode = NRF_TIMER_MODE_COUNTER;
+    err_code = nrfx_timer_init(&m_counter_timer, &timer_config, reed_timer_handler);
+    APP_ERROR_CHECK(err_code);
+
+    uint32_t reed_evt = nrf_drv_gpiote_in_event_addr_get(REED_SWITCH_PIN);
+
+    APP_ERROR_CHECK(nrfx_ppi_channel_alloc(&m_ppi_count));
+    APP_ERROR_CHECK(nrfx_ppi_channel_alloc(&m_ppi_gate));
+    APP_ERROR_CHECK(nrfx_ppi_channel_alloc(&m_ppi_reopen));
+    APP_ERROR_CHECK(nrfx_ppi_group_alloc(&m_ppi_group));
+
+    APP_ERROR_CHECK(nrfx_ppi_channel_assign(m_ppi_count, reed_evt,
+                                            nrfx_timer_task_address_get(&m_counter_timer, NRF_TIMER_TASK_COUNT)));
+    APP_ERROR_CHECK(nrfx_ppi_channel_fork_assign(m_ppi_count,
+                                                 nrfx_timer_capture_task_address_get(&m_timestamp_timer, NRF_TIMER_CC_CHANNEL0)));
+
+    APP_ERROR_CHECK(nrfx_ppi_channel_assign(m_ppi_gate, reed_evt,
+                                            nrfx_ppi_task_addr_group_disable_get(m_ppi_group)));
+    APP_ERROR_CHECK(nrfx_ppi_channel_fork_assign(m_ppi_gate,
+                                                 nrfx_timer_task_address_get(&m_debounce_timer, NRF_TIMER_TASK_START)));
+
+    APP_ERROR_CHECK(nrfx_ppi_channel_assign(m_ppi_reopen,
+                                            nrfx_timer_compare_event_address_get(&m_debounce_timer, NRF_TIMER_CC_CHANNEL0),
+                                            nrfx_ppi_task_addr_group_enable_get(m_ppi_group)));
+
+    APP_ERROR_CHECK(nrfx_ppi_channel_include_in_group(m_ppi_count, m_ppi_group));
+    APP_ERROR_CHECK(nrfx_ppi_channel_include_in_group(m_ppi_gate, m_ppi_group));
+
+    nrfx_timer_enable(&m_counter_timer);
+    nrfx_timer_enable(&m_timestamp_timer);
+    // The debounce timer is started by PPI only
+
+    APP_ERROR_CHECK(nrfx_ppi_channel_enable(m_ppi_reopen));
+    APP_ERROR_CHECK(nrfx_ppi_group_enable(m_ppi_group));
+
+    nrf_drv_gpiote_in_event_enable(REED_SWITCH_PIN, false);
+
+    m_measuring = true;
+    NRF_LOG_INFO("✅ Reed sensor measurement started (debounce %d ms)", debounce_ms);
+    return true;
+}
+
+void reed_sensor_measurement_stop(void)
+{
+    if (!m_measuring) {
+        return;
+    }
+
+    nrf_drv_gpiote_in_event_disable(REED_SWITCH_PIN);
+    nrf_drv_gpiote_in_uninit(REED_SWITCH_PIN);
+
+    (void)nrfx_ppi_group_disable(m_ppi_group);
+    (void)nrfx_ppi_channel_disable(m_ppi_reopen);
+    (void)nrfx_ppi_channel_free(m_ppi_count);
+    (void)nrfx_ppi_channel_free(m_ppi_gate);
+    (void)nrfx_ppi_channel_free(m_ppi_reopen);
+    (void)nrfx_ppi_group_free(m_ppi_group);
+
+    nrfx_timer_uninit(&m_debounce_timer);
+    nrfx_timer_uninit(&m_counter_timer);
+    nrfx_timer_uninit(&m_timestamp_timer);
+
+    m_measuring = false;
+    NRF_LOG_INFO("🚫 Reed sensor measurement stopped");
+}
+
+bool reed_sensor_measurement_read(uint32_t *p_pulses, uint32_t *p_last_pulse_ticks)
+{
+    if (!m_measuring) {
+        return false;
+    }
+
+    // A pulse between the two reads would pair a new count with an old timestamp
+    uint32_t pulses;
+    do {
+        pulses = nrfx_timer_capture(&m_counter_timer, NRF_TIMER_CC_CHANNEL0);
+        *p_last_pulse_ticks = nrfx_timer_capture_get(&m_timestamp_timer, NRF_TIMER_CC_CHANNEL0);
+    } while (pulses != nrfx_timer_capture(&m_counter_timer, NRF_TIMER_CC_CHANNEL0));
+
+    *p_pulses = pulses;
+    return true;
+}
+
+uint32_t reed_sensor_measurement_now(void)
+{
+    if (!m_measuring) {
+        return 0;
+    }
+    return nrfx_timer_capture(&m_timestamp_timer, NRF_TIMER_CC_CHANNEL1);
+}
@@ -2,6 +2,7 @@
 #define REED_SENSOR_H
 
 #include <stdint.h>
+#include <stdbool.h>
 #include "nrf_drv_gpiote.h"
 #include "boards.h"
 
@@ -15,6 +16,13 @@
 
 #define REED_SWITCH_PIN PIN_REED_SENSOR
 
+// Timers used by the pulse measurement, TIMER0 belongs to the SoftDevice and TIMER4 to NFC
+#define REED_DEBOUNCE_TIMER_INSTANCE  1
+#define REED_COUNTER_TIMER_INSTANCE   2
+#define REED_TIMESTAMP_TIMER_INSTANCE 3
+#define REED_TIMER_FREQUENCY          NRF_TIMER_FREQ_31250Hz
+#define REED_TIMER_TICKS_PER_S        31250  // 32-bit timestamps wrap after 38 hours
+
 // Define function pointer type for callback
 typedef void (*reed_sensor_callback_t)(void);
 
@@ -23,4 +31,15 @@ void reed_sensor_init(reed_sensor_callback_t callback);
 void reed_sensor_enable(void);
 void reed_sensor_disable(void);
 
+// Hardware pulse measurement, GPIOTE -> PPI -> TIMER without an interrupt per pulse.
+// Pulses within debounce_ms of an accepted pulse are ignored.
+bool reed_sensor_measurement_start(uint16_t debounce_ms);
+void reed_sensor_measurement_stop(void);
+
+// Total accepted pulses and the timestamp of the last one, in REED_TIMER_TICKS_PER_S units
+bool reed_sensor_measurement_read(uint32_t *p_pulses, uint32_t *p_last_pulse_ticks);
+
+// Current time on the timestamp timer
+uint32_t reed_sensor_measurement_now(void);
+
 #endif // REED_SENSOR_H
@@ -0,0 +1,37 @@
+/**
+ * @file trace_log.c
+ * @brief Implementation of the Binary Trace Log
+ */
+
+#include "includes/trace_log.h"
+
+#if TRACE_LOG_ENABLED
+
+#include "app_timer.h"
+#include "app_util.h"
+#include "app_util_platform.h"
+
+STATIC_ASSERT((TRACE_LOG_ENTRIES & (TRACE_LOG_ENTRIES - 1)) == 0);
+
+static trace_log_t m_trace_log;
+
+void trace_log_write(uint32_t id, uint32_t arg0, uint32_t arg1) {
+    uint32_t slot;
+
+    // Only the slot is claimed under the lock, the entry is filled outside
+    CRITICAL_REGION_ENTER();
+    slot = m_trace_log.next++ & (TRACE_LOG_ENTRIES - 1);
+    CRITICAL_REGION_EXIT();
+
+    trace_log_entry_t *p_entry = &m_trace_log.entries[slot];
+    p_entry->ticks = app_timer_cnt_get();
+    p_entry->id = id;
+    p_entry->args[0] = arg0;
+    p_entry->args[1] = arg1;
+}
+
+const trace_log_t* trace_log_get(void) {
+    return &m_trace_log;
+}
+
+#endif // TRACE_LOG_ENABLED
@@ -26,6 +26,15 @@ void get_hardware_revision(char *hw_rev_str, size_t len)
     }
 }
 
+/**@brief Function to get an ANT+ device number derived from the chip ID. */
+uint16_t get_ant_device_number(void)
+{
+    uint16_t device_number = (uint16_t)(NRF_FICR->DEVICEID[0] & 0xFFFF);
+
+    // 0 is the search wildcard, a receiver could not pair with it
+    return (device_number != 0) ? device_number : 1;
+}
+
 /**@brief Function to get the firmware version. */
 void get_firmware_version(char *version_str, size_t len)
 {
@@ -17,4 +17,7 @@ void get_hardware_revision(char *hw_rev_str, size_t len);
 
 void get_firmware_version(char *version_str, size_t len);
 
+/**@brief Function to get an ANT+ device number derived from the chip ID, never 0 (wildcard). */
+uint16_t get_ant_device_number(void);
+
 #endif // DEVICE_INFO_H__
@@ -0,0 +1,136 @@
+/**
+ * @file virtual_speed.c
+ * @brief Implementation of the Virtual Speed Model
+ */
+
+#include "includes/virtual_speed.h"
+#include <string.h>
+#include "app_timer.h"
+#include "includes/timer_ticks.h"
+#include "ble_custom_config.h"
+#include "nrf_log.h"
+
+#define AIR_DENSITY_KG_M3   1.226f  // Sea level, 15 °C
+#define GRAVITY_M_S2        9.81f
+#define SOLVER_MAX_SPEED_MS 40.0f   // 144 km/h, upper bound of the search
+#define SOLVER_ITERATIONS   24      // Bisection down to ~2 um/s
+
+// Distance numerator units per metre: 0.01 km/h times 1 ms
+#define SPEED_MS_PER_METRE  360000UL
+
+// Speed in 0.01 km/h at every VIRTUAL_SPEED_TABLE_STEP_W watts
+static uint16_t m_speed_table[VIRTUAL_SPEED_TABLE_LEN];
+
+static virtual_speed_t m_state;
+static uint32_t m_distance_rem = 0;  // Distance below one metre, 0.01 km/h * ms
+static uint32_t m_elapsed_ms = 0;    // Moving time below one second
+static uint32_t m_last_sample_ticks = 0;
+static bool m_started = false;
+
+/**
+ * @brief Solve P = Crr*m*g*v + 0.5*rho*CdA*v^3 for v
+ *
+ * The power curve rises monotonically with speed, so bisection always
+ * converges. Only used while building the table.
+ */
+static float solve_speed_ms(float power, float rolling, float aero) {
+    float lo = 0.0f;
+    float hi = SOLVER_MAX_SPEED_MS;
+
+    if (rolling * hi + aero * hi * hi * hi <= power) {
+        return hi;
+    }
+
+    for (uint8_t i = 0; i < SOLVER_ITERATIONS; i++) {
+        float mid = 0.5f * (lo + hi);
+        if (rolling * mid + aero * mid * mid * mid < power) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    return 0.5f * (lo + hi);
+}
+
+void virtual_speed_init(void) {
+    uint16_t mass_kg_x10 = m_rider_mass_kg_x10 ? m_rider_mass_kg_x10 : VIRTUAL_SPEED_DEFAULT_MASS_KG_X10;
+    uint16_t cda_x10000 = m_cda_x10000 ? m_cda_x10000 : VIRTUAL_SPEED_DEFAULT_CDA_X10000;
+    uint16_t crr_x100000 = m_crr_x100000 ? m_crr_x100000 : VIRTUAL_SPEED_DEFAULT_CRR_X100000;
+
+    float rolling = ((float)crr_x100000 / 100000.0f) * ((float)mass_kg_x10 / 10.0f) * GRAVITY_M_S2;
+    float aero = 0.5f * AIR_DENSITY_KG_M3 * ((float)cda_x10000 / 10000.0f);
+
+    for (uint16_t i = 0; i < VIRTUAL_SPEED_TABLE_LEN; i++) {
+        float speed_ms = solve_speed_ms((float)(i * VIRTUAL_SPEED_TABLE_STEP_W), rolling, aero);
+        m_speed_table[i] = (uint16_t)(speed_ms * 360.0f + 0.5f);  // m/s -> 0.01 km/h
+    }
+
+    virtual_speed_reset();
+
+    NRF_LOG_INFO("🚲 Virtual Speed: mass %d.%d kg, CdA 0.%04d, Crr 0.%05d, 200 W = %d.%02d km/h",
+                 mass_kg_x10 / 10, mass_kg_x10 % 10, cda_x10000, crr_x100000,
+                 virtual_speed_from_power(200) / 100, virtual_speed_from_power(200) % 100);
+}
+
+uint16_t virtual_speed_from_power(uint16_t power_watts) {
+    if (power_watts >= VIRTUAL_SPEED_TABLE_MAX_W) {
+        return m_speed_table[VIRTUAL_SPEED_TABLE_LEN - 1];
+    }
+
+    // Linear interpolation between the two surrounding entries
+    uint16_t index = power_watts / VIRTUAL_SPEED_TABLE_STEP_W;
+    uint16_t frac = power_watts % VIRTUAL_SPEED_TABLE_STEP_W;
+    uint16_t lo = m_speed_table[index];
+    uint16_t hi = m_speed_table[index + 1];
+
+    return (uint16_t)(lo + (((uint32_t)(hi - lo) * frac) / VIRTUAL_SPEED_TABLE_STEP_W));
+}
+
+/**
+ * @brief Accumulate distance and time at the previous speed, then take the new one
+ */
+static void advance(uint16_t speed_kmh_x100) {
+    uint32_t now = app_timer_cnt_get();
+
+    if (m_started) {
+        uint32_t dt_ms = TICKS_TO_MS(app_timer_cnt_diff_compute(now, m_last_sample_ticks));
+
+        // The previous speed holds until this sample, but not through a long gap
+        if (dt_ms > VIRTUAL_SPEED_GAP_MS) {
+            dt_ms = VIRTUAL_SPEED_GAP_MS;
+        }
+
+        if (m_state.speed_kmh_x100 > 0) {
+            m_distance_rem += (uint32_t)m_state.speed_kmh_x100 * dt_ms;
+            m_state.distance_m += m_distance_rem / SPEED_MS_PER_METRE;
+            m_distance_rem %= SPEED_MS_PER_METRE;
+
+            m_elapsed_ms += dt_ms;
+            m_state.elapsed_s += m_elapsed_ms / 1000;
+            m_elapsed_ms %= 1000;
+        }
+    }
+
+    m_started = true;
+    m_last_sample_ticks = now;
+    m_state.speed_kmh_x100 = speed_kmh_x100;
+}
+
+void virtual_speed_update(uint16_t power_watts) {
+    advance(virtual_speed_from_power(power_watts));
+}
+
+void virtual_speed_update_measured(uint16_t speed_kmh_x100) {
+    advance(speed_kmh_x100);
+}
+
+const virtual_speed_t* virtual_speed_get(void) {
+    return &m_state;
+}
+
+void virtual_speed_reset(void) {
+    memset(&m_state, 0, sizeof(m_state));
+    m_distance_rem = 0;
+    m_elapsed_ms = 0;
+    m_started = false;
+}
@@ -0,0 +1,241 @@
+/**
+ * @file deadline_timer_sim.c
+ * @brief Host simulation of the deadline timer scheduler (src/includes/deadline_timer.h)
+ *
+ * Runs src/deadline_timer.c on a simulated RTC with the timers the firmware
+ * creates, using their periods and slacks, and counts how often the single
+ * wake timer fires. Every scenario runs twice: with the configured slacks
+ * and with every slack set to 0, which is what separate app_timers did.
+ * Timers start at different times, as they do after boot, so only the
+ * slack lines their expiries up.
+ *
+ * Build and run from the repository root:
+ *     cc -O2 -std=c11 -Itools/host/include -Isrc tools/host/deadline_timer_sim.c src/deadline_timer.c -o deadline_timer_sim
+ *     ./deadline_timer_sim
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "includes/deadline_timer.h"
+#include "app_timer.h"
+
+#define SCENARIO_S          600
+#define KEISER_PACKET_MS    320   // KEISER_M3I_ADV_INTERVAL_MS
+
+uint32_t host_timer_ticks = 0;
+
+/**
+ * @brief Firmware timers, periods and slacks as in the source files
+ */
+typedef enum {
+    SIM_BRIDGE_OUTPUT,      // ble_bridge.c OUTPUT_PERIOD_MS
+    SIM_BRIDGE_INACTIVITY,  // ble_bridge.c INACTIVITY_CHECK_MS
+    SIM_FTMS_TRAINING,      // ble_ftms.c FTMS_INACTIVITY_TIMEOUT_MS, restarted every output tick
+    SIM_KEISER_TIMEOUT,     // keiser_m3i_data_source.h KEISER_M3I_ADV_TIMEOUT_MS, restarted per packet
+    SIM_BATTERY_SERVICE,    // ble_setup.c battery level service
+    SIM_BATTERY_MEAS,       // battery_measurement.c BATTERY_LEVEL_MEAS_INTERVAL
+    SIM_UPTIME_FOLD,        // diagnostics.c UPTIME_FOLD_MS
+    SIM_TIMER_COUNT
+} sim_timer_t;
+
+typedef struct {
+    const char *name;
+    deadline_timer_mode_t mode;
+    uint32_t timeout_ms;
+    uint32_t slack_ms;
+    uint32_t start_ms;   // Time into the scenario the timer is first started
+} sim_timer_def_t;
+
+static const sim_timer_def_t m_defs[SIM_TIMER_COUNT] = {
+    [SIM_BRIDGE_OUTPUT]     = { "bridge output",     DEADLINE_TIMER_MODE_REPEATED,    250,    0,     2345 },
+    [SIM_BRIDGE_INACTIVITY] = { "bridge inactivity", DEADLINE_TIMER_MODE_REPEATED,    2000,   1000,  2345 },
+    [SIM_FTMS_TRAINING]     = { "FTMS training",     DEADLINE_TIMER_MODE_SINGLE_SHOT, 5000,   500,   0    },
+    [SIM_KEISER_TIMEOUT]    = { "Keiser timeout",    DEADLINE_TIMER_MODE_SINGLE_SHOT, 1000,   250,   2110 },
+    [SIM_BATTERY_SERVICE]   = { "battery service",   DEADLINE_TIMER_MODE_REPEATED,    120000, 30000, 1730 },
+    [SIM_BATTERY_MEAS]      = { "battery measure",   DEADLINE_TIMER_MODE_REPEATED,    60000,  30000, 15   },
+    [SIM_UPTIME_FOLD]       = { "uptime fold",       DEADLINE_TIMER_MODE_REPEATED,    256000, 60000, 0    },
+};
+
+/**
+ * @brief One set of timers, created with or without slack
+ */
+typedef struct {
+    deadline_timer_id_t ids[SIM_TIMER_COUNT];
+    uint32_t expiries[SIM_TIMER_COUNT];
+} sim_set_t;
+
+typedef struct {
+    sim_set_t *p_set;
+    sim_timer_t timer;
+} sim_context_t;
+
+static sim_set_t m_with_slack;
+static sim_set_t m_without_slack;
+static sim_context_t m_contexts[2][SIM_TIMER_COUNT];
+
+// The single app_timer the scheduler multiplexes
+static app_timer_t *mp_wake_timer = NULL;
+static uint32_t m_wake_count = 0;
+
+ret_code_t app_timer_create(app_timer_id_t const *p_timer_id, app_timer_mode_t mode,
+                            app_timer_timeout_handler_t timeout_handler) {
+    app_timer_t *p_timer = *p_timer_id;
+    p_timer->handler = timeout_handler;
+    p_timer->mode = mode;
+    p_timer->running = false;
+    mp_wake_timer = p_timer;
+    return NRF_SUCCESS;
+}
+
+ret_code_t app_timer_start(app_timer_id_t timer_id, uint32_t timeout_ticks, void *p_context) {
+    timer_id->p_context = p_context;
+    timer_id->expiry = host_timer_ticks + timeout_ticks;
+    timer_id->period = timeout_ticks;
+    timer_id->running = true;
+    return NRF_SUCCESS;
+}
+
+ret_code_t app_timer_stop(app_timer_id_t timer_id) {
+    timer_id->running = false;
+    return NRF_SUCCESS;
+}
+
+static void sim_start(sim_set_t *p_set, sim_timer_t timer) {
+    sim_context_t *p_context = &m_contexts[p_set == &m_without_slack][timer];
+    p_context->p_set = p_set;
+    p_context->timer = timer;
+    deadline_timer_start(p_set->ids[timer], m_defs[timer].timeout_ms, p_context);
+}
+
+/**
+ * @brief Count the expiry, the bridge output also restarts the FTMS timer like ble_ftms_tick()
+ */
+static void sim_handler(void *p_context) {
+    sim_context_t *p_sim = p_context;
+
+    p_sim->p_set->expiries[p_sim->timer]++;
+    if (p_sim->timer == SIM_BRIDGE_OUTPUT) {
+        sim_start(p_sim->p_set, SIM_FTMS_TRAINING);
+    }
+}
+
+static void create_set(sim_set_t *p_set, bool slack) {
+    for (uint8_t i = 0; i < SIM_TIMER_COUNT; i++) {
+        uint32_t err_code = deadline_timer_create(&p_set->ids[i], m_defs[i].mode,
+                                                  slack ? m_defs[i].slack_ms : 0, sim_handler);
+        APP_ERROR_CHECK(err_code);
+    }
+}
+
+static bool earlier(uint32_t a, uint32_t b) {
+    return (int32_t)(a - b) < 0;
+}
+
+/**
+ * @brief Run one scenario and print the wake-ups
+ *
+ * @param running Timers started at their start_ms into the scenario
+ * @return uint32_t Wake-ups during the scenario
+ */
+static uint32_t run(sim_set_t *p_set, const char *title, uint32_t running) {
+    for (uint8_t i = 0; i < SIM_TIMER_COUNT; i++) {
+        deadline_timer_stop(m_with_slack.ids[i]);
+        deadline_timer_stop(m_without_slack.ids[i]);
+        p_set->expiries[i] = 0;
+    }
+
+    // The last wake of the previous scenario finds nothing to do, let it pass uncounted
+    if (mp_wake_timer->running) {
+        host_timer_ticks = mp_wake_timer->expiry;
+        mp_wake_timer->running = false;
+        mp_wake_timer->handler(mp_wake_timer->p_context);
+    }
+
+    uint32_t begin = host_timer_ticks;
+    uint32_t end = begin + APP_TIMER_TICKS(SCENARIO_S * 1000);
+    bool keiser = (running & (1u << SIM_KEISER_TIMEOUT)) != 0;
+    uint32_t next_packet = begin + APP_TIMER_TICKS(m_defs[SIM_KEISER_TIMEOUT].start_ms);
+    uint32_t pending = running & ~(1u << SIM_KEISER_TIMEOUT);  // Packets start the Keiser timeout
+    uint32_t wakeups_at_start = m_wake_count;
+
+    for (;;) {
+        // Earliest of a timer start, the next Keiser packet and the wake timer
+        uint32_t next = end;
+        int8_t start = -1;
+        bool packet = false;
+        bool wake = false;
+
+        for (uint8_t i = 0; i < SIM_TIMER_COUNT; i++) {
+            uint32_t at = begin + APP_TIMER_TICKS(m_defs[i].start_ms);
+            if ((pending & (1u << i)) && earlier(at, next)) {
+                next = at;
+                start = i;
+            }
+        }
+        if (keiser && earlier(next_packet, next)) {
+            next = next_packet;
+            start = -1;
+            packet = true;
+        }
+        if (mp_wake_timer->running && earlier(mp_wake_timer->expiry, next)) {
+            next = mp_wake_timer->expiry;
+            start = -1;
+            packet = false;
+            wake = true;
+        }
+        host_timer_ticks = next;
+
+        if (start >= 0) {
+            pending &= ~(1u << start);
+            sim_start(p_set, (sim_timer_t)start);
+        } else if (packet) {
+            sim_start(p_set, SIM_KEISER_TIMEOUT);  // Every packet restarts the data timeout
+            next_packet += APP_TIMER_TICKS(KEISER_PACKET_MS);
+        } else if (wake) {
+            mp_wake_timer->running = false;
+            m_wake_count++;
+            mp_wake_timer->handler(mp_wake_timer->p_context);
+        } else {
+            break;
+        }
+    }
+
+    uint32_t wakeups = m_wake_count - wakeups_at_start;
+    uint32_t expiries = 0;
+
+    printf("%s, %s\n", title, (p_set == &m_with_slack) ? "configured slack" : "no slack");
+    for (uint8_t i = 0; i < SIM_TIMER_COUNT; i++) {
+        if (p_set->expiries[i] != 0) {
+            printf("  %-18s %5u expiries\n", m_defs[i].name, p_set->expiries[i]);
+            expiries += p_set->expiries[i];
+        }
+    }
+    printf("  %u wake-ups for %u expiries in %u s, %.1f wake-ups/min (diagnostics %u last minute)\n\n",
+           wakeups, expiries, SCENARIO_S, wakeups * 60.0 / SCENARIO_S, deadline_timer_wakeups_per_min());
+    return wakeups;
+}
+
+int main(void) {
+    const uint32_t always = (1u << SIM_BATTERY_SERVICE) | (1u << SIM_BATTERY_MEAS) | (1u << SIM_UPTIME_FOLD);
+    const uint32_t riding = always | (1u << SIM_BRIDGE_OUTPUT) | (1u << SIM_BRIDGE_INACTIVITY) |
+                            (1u << SIM_KEISER_TIMEOUT);
+    int failures = 0;
+
+    deadline_timer_init();
+    create_set(&m_with_slack, true);
+    create_set(&m_without_slack, false);
+
+    // With slack every other timer rides along on the output ticks
+    uint32_t wakeups = run(&m_with_slack, "Keiser source, bridge running", riding);
+    uint32_t output_ticks = m_with_slack.expiries[SIM_BRIDGE_OUTPUT];
+    if (wakeups != output_ticks) {
+        printf("MISMATCH: expected one wake-up per output tick (%u)\n\n", output_ticks);
+        failures++;
+    }
+    run(&m_without_slack, "Keiser source, bridge running", riding);
+
+    run(&m_with_slack, "Bridge stopped", always);
+    run(&m_without_slack, "Bridge stopped", always);
+
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
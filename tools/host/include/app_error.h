@@ -0,0 +1,25 @@
+/**
+ * @file app_error.h
+ * @brief Host stand-in for the SDK app_error
+ */
+
+#ifndef HOST_APP_ERROR_H
+#define HOST_APP_ERROR_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+typedef uint32_t ret_code_t;
+
+#define NRF_SUCCESS  0
+
+#define APP_ERROR_CHECK(ERR_CODE)                                             \
+    do {                                                                      \
+        if ((ERR_CODE) != NRF_SUCCESS) {                                      \
+            fprintf(stderr, "%s:%d: error %u\n", __FILE__, __LINE__, (unsigned)(ERR_CODE)); \
+            abort();                                                          \
+        }                                                                     \
+    } while (0)
+
+#endif // HOST_APP_ERROR_H
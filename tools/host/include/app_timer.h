@@ -0,0 +1,63 @@
+/**
+ * @file app_timer.h
+ * @brief Host stand-in for the SDK app_timer
+ *
+ * The RTC is a variable the host program advances, see host_timer_ticks.
+ * Programs that start timers also define app_timer_create/start/stop.
+ */
+
+#ifndef HOST_APP_TIMER_H
+#define HOST_APP_TIMER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "app_error.h"
+
+#define APP_TIMER_CLOCK_FREQ            32768
+#define APP_TIMER_CONFIG_RTC_FREQUENCY  1      // As in pca10056/s340/config/sdk_config.h
+#define RTC_COUNTER_MASK                0x00FFFFFF
+#define APP_TIMER_MIN_TIMEOUT_TICKS     5
+
+#define APP_TIMER_TICKS(MS) \
+    ((uint32_t)((((uint64_t)(MS) * APP_TIMER_CLOCK_FREQ) + 500 * (APP_TIMER_CONFIG_RTC_FREQUENCY + 1)) / \
+                (1000 * (APP_TIMER_CONFIG_RTC_FREQUENCY + 1))))
+
+/** RTC1 counter, defined and advanced by the host program */
+extern uint32_t host_timer_ticks;
+
+static inline uint32_t app_timer_cnt_get(void) {
+    return host_timer_ticks & RTC_COUNTER_MASK;
+}
+
+static inline uint32_t app_timer_cnt_diff_compute(uint32_t ticks_to, uint32_t ticks_from) {
+    return (ticks_to - ticks_from) & RTC_COUNTER_MASK;
+}
+
+typedef void (*app_timer_timeout_handler_t)(void *p_context);
+
+typedef enum {
+    APP_TIMER_MODE_SINGLE_SHOT,
+    APP_TIMER_MODE_REPEATED
+} app_timer_mode_t;
+
+typedef struct {
+    app_timer_timeout_handler_t handler;
+    app_timer_mode_t mode;
+    void *p_context;
+    uint32_t expiry;   // host_timer_ticks of the next expiry
+    uint32_t period;
+    bool running;
+} app_timer_t;
+
+typedef app_timer_t *app_timer_id_t;
+
+#define APP_TIMER_DEF(timer_id)                   \
+    static app_timer_t timer_id##_data;           \
+    static const app_timer_id_t timer_id = &timer_id##_data
+
+ret_code_t app_timer_create(app_timer_id_t const *p_timer_id, app_timer_mode_t mode,
+                            app_timer_timeout_handler_t timeout_handler);
+ret_code_t app_timer_start(app_timer_id_t timer_id, uint32_t timeout_ticks, void *p_context);
+ret_code_t app_timer_stop(app_timer_id_t timer_id);
+
+#endif // HOST_APP_TIMER_H
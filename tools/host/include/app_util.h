@@ -0,0 +1,13 @@
+/**
+ * @file app_util.h
+ * @brief Host stand-in for the SDK app_util
+ */
+
+#ifndef HOST_APP_UTIL_H
+#define HOST_APP_UTIL_H
+
+#define STATIC_ASSERT(EXPR)  _Static_assert((EXPR), #EXPR)
+#define ARRAY_SIZE(arr)      (sizeof(arr) / sizeof((arr)[0]))
+#define CEIL_DIV(A, B)       (((A) + (B) - 1) / (B))
+
+#endif // HOST_APP_UTIL_H
@@ -0,0 +1,12 @@
+/**
+ * @file app_util_platform.h
+ * @brief Host stand-in for the SDK app_util_platform, there are no interrupts to mask
+ */
+
+#ifndef HOST_APP_UTIL_PLATFORM_H
+#define HOST_APP_UTIL_PLATFORM_H
+
+#define CRITICAL_REGION_ENTER()  do {
+#define CRITICAL_REGION_EXIT()   } while (0)
+
+#endif // HOST_APP_UTIL_PLATFORM_H
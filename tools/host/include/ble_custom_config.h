@@ -0,0 +1,17 @@
+/**
+ * @file ble_custom_config.h
+ * @brief Host stand-in for the stored device config
+ *
+ * Only the virtual speed parameters, defined by the host program.
+ */
+
+#ifndef HOST_BLE_CUSTOM_CONFIG_H
+#define HOST_BLE_CUSTOM_CONFIG_H
+
+#include <stdint.h>
+
+extern uint16_t m_rider_mass_kg_x10;
+extern uint16_t m_cda_x10000;
+extern uint16_t m_crr_x100000;
+
+#endif // HOST_BLE_CUSTOM_CONFIG_H
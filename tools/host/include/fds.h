@@ -0,0 +1,92 @@
+/**
+ * @file fds.h
+ * @brief Host stand-in for the SDK Flash Data Storage
+ *
+ * Flash is always empty and every write succeeds without an event.
+ */
+
+#ifndef HOST_FDS_H
+#define HOST_FDS_H
+
+#include <stdint.h>
+#include "app_error.h"
+
+#define FDS_ERR_NOT_FOUND          0x860A
+#define FDS_ERR_NO_SPACE_IN_FLASH  0x8609
+
+typedef enum {
+    FDS_EVT_INIT,
+    FDS_EVT_WRITE,
+    FDS_EVT_UPDATE,
+    FDS_EVT_DEL_RECORD,
+    FDS_EVT_DEL_FILE,
+    FDS_EVT_GC,
+} fds_evt_id_t;
+
+typedef struct {
+    fds_evt_id_t id;
+    ret_code_t result;
+    struct {
+        uint32_t record_id;
+        uint16_t file_id;
+        uint16_t record_key;
+    } write;
+} fds_evt_t;
+
+typedef void (*fds_cb_t)(fds_evt_t const *p_evt);
+
+typedef struct {
+    uint16_t record_key;
+    uint16_t length_words;
+    uint16_t file_id;
+} fds_header_t;
+
+typedef struct {
+    uint32_t record_id;
+} fds_record_desc_t;
+
+typedef struct {
+    uint32_t page;
+} fds_find_token_t;
+
+typedef struct {
+    uint16_t file_id;
+    uint16_t key;
+    struct {
+        void const *p_data;
+        uint32_t length_words;
+    } data;
+} fds_record_t;
+
+typedef struct {
+    fds_header_t const *p_header;
+    void const *p_data;
+} fds_flash_record_t;
+
+static inline ret_code_t fds_register(fds_cb_t cb) { (void)cb; return NRF_SUCCESS; }
+static inline ret_code_t fds_gc(void) { return NRF_SUCCESS; }
+
+static inline ret_code_t fds_record_find(uint16_t file_id, uint16_t key, fds_record_desc_t *p_desc,
+                                         fds_find_token_t *p_token) {
+    (void)file_id; (void)key; (void)p_desc; (void)p_token;
+    return FDS_ERR_NOT_FOUND;
+}
+
+static inline ret_code_t fds_record_open(fds_record_desc_t *p_desc, fds_flash_record_t *p_record) {
+    (void)p_desc; (void)p_record;
+    return FDS_ERR_NOT_FOUND;
+}
+
+static inline ret_code_t fds_record_close(fds_record_desc_t *p_desc) { (void)p_desc; return NRF_SUCCESS; }
+
+static inline ret_code_t fds_record_write(fds_record_desc_t *p_desc, fds_record_t const *p_record) {
+    (void)p_desc; (void)p_record;
+    return NRF_SUCCESS;
+}
+
+static inline ret_code_t fds_record_update(fds_record_desc_t *p_desc, fds_record_t const *p_record) {
+    (void)p_desc; (void)p_record;
+    return NRF_SUCCESS;
+}
+
+#endif // HOST_FDS_H
@@ -0,0 +1,14 @@
+/**
+ * @file nrf_log.h
+ * @brief Host stand-in for the SDK logger, everything is dropped
+ */
+
+#ifndef HOST_NRF_LOG_H
+#define HOST_NRF_LOG_H
+
+#define NRF_LOG_ERROR(...)    do { } while (0)
+#define NRF_LOG_WARNING(...)  do { } while (0)
+#define NRF_LOG_INFO(...)     do { } while (0)
+#define NRF_LOG_DEBUG(...)    do { } while (0)
+
+#endif // HOST_NRF_LOG_H
@@ -0,0 +1,13 @@
+/**
+ * @file sdk_errors.h
+ * @brief Host stand-in for the SDK error codes
+ */
+
+#ifndef HOST_SDK_ERRORS_H
+#define HOST_SDK_ERRORS_H
+
+#include "app_error.h"
+
+#define NRF_ERROR_NO_MEM  4
+
+#endif // HOST_SDK_ERRORS_H
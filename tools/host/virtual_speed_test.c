@@ -0,0 +1,168 @@
+/**
+ * @file virtual_speed_test.c
+ * @brief Host check of the virtual speed model (src/includes/virtual_speed.h)
+ *
+ * Compares the table speed at every whole watt with a double-precision
+ * solution of P = Crr*m*g*v + 0.5*rho*CdA*v^3, then feeds a synthetic ride
+ * at the 4 Hz bridge output rate and compares distance and moving time with
+ * the same integration done in double precision. Runs once with the
+ * defaults and once with stored parameters, then checks that a measured
+ * wheel speed is integrated the same way.
+ *
+ * Build and run from the repository root:
+ *     cc -O2 -std=c11 -Itools/host/include -Isrc tools/host/virtual_speed_test.c src/virtual_speed.c -o virtual_speed_test -lm
+ *     ./virtual_speed_test
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "includes/virtual_speed.h"
+#include "app_timer.h"
+
+#define RIDE_S              3600
+#define SAMPLES_PER_S       4
+#define SAMPLE_MS           (1000 / SAMPLES_PER_S)
+#define SPEED_TOLERANCE     20     // 0.01 km/h, worst in the first table step where speed rises fastest
+#define DISTANCE_TOLERANCE  0.001  // Relative
+
+uint32_t host_timer_ticks = 0;
+
+uint16_t m_rider_mass_kg_x10 = 0;
+uint16_t m_cda_x10000 = 0;
+uint16_t m_crr_x100000 = 0;
+
+/**
+ * @brief Reference speed in m/s, bisection in double precision
+ */
+static double reference_speed_ms(double power, double rolling, double aero) {
+    double lo = 0.0;
+    double hi = 40.0;  // Same upper bound as the model
+
+    if (power <= 0.0) {
+        return 0.0;
+    }
+    if (rolling * hi + aero * hi * hi * hi <= power) {
+        return hi;
+    }
+
+    for (int i = 0; i < 100; i++) {
+        double mid = 0.5 * (lo + hi);
+        if (rolling * mid + aero * mid * mid * mid < power) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    return 0.5 * (lo + hi);
+}
+
+/**
+ * @brief Steady riding with surges and a stop, plus noise
+ */
+static uint16_t ride_power(uint32_t t_s, uint32_t *p_seed) {
+    *p_seed = *p_seed * 1103515245u + 12345u;
+    int32_t noise = (int32_t)((*p_seed >> 16) % 31) - 15;
+    int32_t base;
+
+    if (t_s < 600) {
+        base = 150;
+    } else if (t_s < 1800) {
+        base = ((t_s / 60) % 2) ? 350 : 180;
+    } else if (t_s < 1900) {
+        base = 0;  // Stopped
+    } else {
+        base = ((t_s % 300) < 15) ? 1100 : 220;
+    }
+
+    int32_t watts = (base > 0) ? base + noise : 0;
+    return (uint16_t)((watts < 0) ? 0 : watts);
+}
+
+static int run(uint16_t mass_kg_x10, uint16_t cda_x10000, uint16_t crr_x100000) {
+    m_rider_mass_kg_x10 = mass_kg_x10;
+    m_cda_x10000 = cda_x10000;
+    m_crr_x100000 = crr_x100000;
+    virtual_speed_init();
+
+    double mass = (mass_kg_x10 ? mass_kg_x10 : VIRTUAL_SPEED_DEFAULT_MASS_KG_X10) / 10.0;
+    double cda = (cda_x10000 ? cda_x10000 : VIRTUAL_SPEED_DEFAULT_CDA_X10000) / 10000.0;
+    double crr = (crr_x100000 ? crr_x100000 : VIRTUAL_SPEED_DEFAULT_CRR_X100000) / 100000.0;
+    double rolling = crr * mass * 9.81;
+    double aero = 0.5 * 1.226 * cda;
+    int failures = 0;
+
+    printf("mass %.1f kg, CdA %.4f, Crr %.5f\n", mass, cda, crr);
+
+    // Table against the exact solution at every whole watt
+    int max_error = 0;
+    uint16_t worst_w = 0;
+    for (uint16_t watts = 0; watts <= VIRTUAL_SPEED_TABLE_MAX_W; watts++) {
+        long expected = lround(reference_speed_ms(watts, rolling, aero) * 360.0);
+        int error = abs((int)(virtual_speed_from_power(watts) - expected));
+        if (error > max_error) {
+            max_error = error;
+            worst_w = watts;
+        }
+    }
+    int ok = max_error <= SPEED_TOLERANCE;
+    printf("  speed      max error %d (0.01 km/h) at %u W  %s\n", max_error, worst_w, ok ? "ok" : "MISMATCH");
+    failures += ok ? 0 : 1;
+
+    // Distance and moving time, each speed held until the next sample
+    uint32_t seed = 1;
+    double distance = 0.0;
+    double moving_s = 0.0;
+    double speed_ms = 0.0;
+    for (uint32_t i = 0; i < RIDE_S * SAMPLES_PER_S; i++) {
+        uint16_t watts = ride_power(i / SAMPLES_PER_S, &seed);
+
+        if (i > 0) {
+            distance += speed_ms * (SAMPLE_MS / 1000.0);
+            moving_s += (speed_ms > 0.0) ? SAMPLE_MS / 1000.0 : 0.0;
+        }
+        virtual_speed_update(watts);
+        speed_ms = reference_speed_ms(watts, rolling, aero);
+
+        host_timer_ticks += APP_TIMER_TICKS(SAMPLE_MS);
+    }
+
+    const virtual_speed_t *p_state = virtual_speed_get();
+    ok = fabs(p_state->distance_m - distance) <= 1.0 + distance * DISTANCE_TOLERANCE;
+    printf("  distance   %u m  reference %.1f m  %s\n", p_state->distance_m, distance, ok ? "ok" : "MISMATCH");
+    failures += ok ? 0 : 1;
+
+    ok = fabs(p_state->elapsed_s - moving_s) <= 1.0;
+    printf("  moving     %u s  reference %.1f s  %s\n", p_state->elapsed_s, moving_s, ok ? "ok" : "MISMATCH");
+    failures += ok ? 0 : 1;
+
+    return failures;
+}
+
+/**
+ * @brief Ten minutes at a measured 30 km/h cover 5 km
+ */
+static int run_measured(void) {
+    virtual_speed_reset();
+
+    for (uint32_t i = 0; i <= 600 * SAMPLES_PER_S; i++) {
+        virtual_speed_update_measured(3000);
+        host_timer_ticks += APP_TIMER_TICKS(SAMPLE_MS);
+    }
+
+    const virtual_speed_t *p_state = virtual_speed_get();
+    int ok = (p_state->distance_m == 5000) && (p_state->elapsed_s == 600);
+    printf("measured 30 km/h for 600 s\n  distance   %u m  moving %u s  %s\n",
+           p_state->distance_m, p_state->elapsed_s, ok ? "ok" : "MISMATCH");
+    return ok ? 0 : 1;
+}
+
+int main(void) {
+    int failures = 0;
+
+    failures += run(0, 0, 0);          // Defaults
+    failures += run(950, 2500, 300);   // Heavier rider in the drops on fast tyres
+    failures += run_measured();
+
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
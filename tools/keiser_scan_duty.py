@@ -0,0 +1,80 @@
+#!/usr/bin/env python3
+"""Estimate the radio-on time of the Keiser M3i scan scheduler (src/keiser/keiser_m3i_data_source.h).
+
+Simulates the bike advertising every KEISER_M3I_ADV_INTERVAL_MS plus a
+random advDelay, and the scanner in both modes. Wide mode listens for the
+window of every scan interval. Locked mode pauses after each packet from
+the target and resumes KEISER_SCAN_LOCK_GUARD_MS before the next expected
+advertising event; a lost packet keeps the radio on until the one after.
+
+Packet loss stands in for interference and the other bikes of a gym, the
+bike clock drift for a cheap crystal. The current defaults to nRF52840
+product specification figures and can be replaced with a measurement:
+    keiser_scan_duty.py --rx-ma 5.2 --loss 0.1
+
+Usage:
+    keiser_scan_duty.py [--guard-ms 5 10 15 20 ...] [--loss 0.05]
+"""
+
+import argparse
+import random
+
+ADV_INTERVAL_MS = 320    # KEISER_M3I_ADV_INTERVAL_MS
+ADV_DELAY_MAX_MS = 10    # Random advDelay added by the bike to every advertising event
+ADV_AIR_TIME_MS = 1      # One ADV_IND with manufacturer data, rounded up
+WIDE_INTERVAL_MS = 100   # KEISER_SCAN_WIDE_INTERVAL_MS
+WIDE_WINDOW_MS = 100     # KEISER_SCAN_WIDE_WINDOW_MS
+
+
+def simulate_locked(guard_ms, args, rng):
+    """Radio-on fraction and the fraction of advertising events missed"""
+    scale = 1 + args.drift_ppm / 1e6
+    t = 0.0       # Last packet received
+    adv = 0.0     # Current advertising event
+    on_ms = 0.0
+    events = 0
+    missed = 0
+
+    while adv < args.seconds * 1000:
+        resume = t + ADV_INTERVAL_MS - guard_ms + args.resume_latency_ms
+        # Events before the resume pass unheard, the scanner is paused
+        while True:
+            adv += (ADV_INTERVAL_MS + rng.uniform(0, ADV_DELAY_MAX_MS)) * scale
+            events += 1
+            if adv >= resume and rng.random() >= args.loss:
+                break
+            missed += 1
+        end = adv + ADV_AIR_TIME_MS
+        on_ms += end - max(resume, t)
+        t = end
+
+    return on_ms / t, missed / events
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--guard-ms", type=float, nargs="+", default=[5, 10, 15, 20, 30],
+                        help="resume lead times to compare (KEISER_SCAN_LOCK_GUARD_MS)")
+    parser.add_argument("--loss", type=float, default=0.05, help="probability a packet is not received")
+    parser.add_argument("--drift-ppm", type=float, default=50, help="bike clock error, positive is slow")
+    parser.add_argument("--resume-latency-ms", type=float, default=0.5,
+                        help="from the resume timer to the radio listening")
+    parser.add_argument("--rx-ma", type=float, default=6.0,
+                        help="current while scanning: radio RX 4.6 mA on DC/DC, CPU and HFXO")
+    parser.add_argument("--seconds", type=float, default=3600, help="simulated riding time")
+    parser.add_argument("--seed", type=int, default=1)
+    args = parser.parse_args()
+
+    wide = WIDE_WINDOW_MS / WIDE_INTERVAL_MS
+    print("%10s %12s %10s %10s" % ("mode", "radio on %", "avg mA", "missed %"))
+    print("%10s %12.1f %10.2f %10.1f" % ("wide", 100 * wide, wide * args.rx_ma, 100 * args.loss))
+
+    for guard_ms in args.guard_ms:
+        rng = random.Random(args.seed)
+        on, missed = simulate_locked(guard_ms, args, rng)
+        print("%10s %12.1f %10.2f %10.1f"
+              % ("lock %gms" % guard_ms, 100 * on, on * args.rx_ma, 100 * missed))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,88 @@
+#!/usr/bin/env python3
+"""Estimate the energy and wake latency of the ANT+ presence wake (src/includes/presence_wake.h).
+
+Simulates the listening loop on the host: every interval the chip opens a
+search window of PRESENCE_WAKE_LISTEN_MS, the rest of the time it idles in
+System ON with the RTC running. Riders start pedalling at random times,
+the meter is heard by the first window that is open while it transmits.
+
+The currents default to nRF52840 product specification figures and can be
+replaced with measurements, e.g. from a PPK2 on the board:
+    presence_energy.py --rx-ma 5.2 --idle-ua 2.9 --battery-mah 400
+
+Usage:
+    presence_energy.py [--interval 10 30 60 ...] [--listen-ms 300]
+"""
+
+import argparse
+import random
+
+MSG_PERIOD_S = 8182 / 32768  # BPWR_MSG_PERIOD, the meter transmits about 4 times per second
+
+
+def simulate(interval_s, args, rng):
+    """Average current in uA while listening, and the wake latencies"""
+    listen_s = args.listen_ms / 1000
+    rate = args.rides_per_day / 86400
+    listening_s = 0.0  # Time in the loop, rides excluded
+    windows = 0
+    latencies = []
+
+    while listening_s < args.days * 86400:
+        # One stretch of listening, from the end of a ride to the next rider
+        arrival = rng.expovariate(rate)
+        t = 0.0
+        while True:
+            windows += 1
+            if arrival < t + listen_s:
+                # A meter already transmitting is heard within one message period of the open
+                heard = max(arrival, t) + rng.uniform(0, MSG_PERIOD_S)
+                if heard <= t + listen_s:
+                    latencies.append(heard - arrival)
+                    listening_s += heard
+                    break
+            t += interval_s
+
+    charge_uc = windows * (args.rx_ma * 1000 * listen_s + args.wake_uc)
+    charge_uc += (listening_s - windows * listen_s) * args.idle_ua
+    return charge_uc / listening_s, latencies
+
+
+def percentile(values, fraction):
+    if not values:
+        return float("nan")
+    ordered = sorted(values)
+    return ordered[min(len(ordered) - 1, int(fraction * len(ordered)))]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--interval", type=float, nargs="+", default=[5, 10, 20, 30, 60, 120],
+                        help="listen intervals to compare, s (PRESENCE_WAKE_INTERVAL_MS / 1000)")
+    parser.add_argument("--listen-ms", type=float, default=300, help="search window (PRESENCE_WAKE_LISTEN_MS)")
+    parser.add_argument("--rx-ma", type=float, default=6.0,
+                        help="current while searching: radio RX 4.6 mA on DC/DC, CPU and HFXO")
+    parser.add_argument("--wake-uc", type=float, default=10.0,
+                        help="charge per wake outside the window: HFXO start, channel open and close")
+    parser.add_argument("--idle-ua", type=float, default=3.2, help="System ON idle, RTC running, all RAM retained")
+    parser.add_argument("--off-ua", type=float, default=0.5, help="System OFF with the no-init section retained")
+    parser.add_argument("--battery-mah", type=float, default=400)
+    parser.add_argument("--rides-per-day", type=float, default=1)
+    parser.add_argument("--days", type=float, default=30, help="simulated listening time, rides excluded")
+    parser.add_argument("--seed", type=int, default=1)
+    args = parser.parse_args()
+
+    print("System OFF (reed wake only): %.1f uA, %.0f days on %.0f mAh"
+          % (args.off_ua, args.battery_mah * 1000 / args.off_ua / 24, args.battery_mah))
+    print("%10s %10s %10s %12s %12s" % ("interval s", "avg uA", "days idle", "wake mean s", "wake p95 s"))
+
+    for interval_s in args.interval:
+        rng = random.Random(args.seed)
+        avg_ua, latencies = simulate(interval_s, args, rng)
+        mean = sum(latencies) / len(latencies) if latencies else float("nan")
+        print("%10g %10.1f %10.0f %12.1f %12.1f"
+              % (interval_s, avg_ua, args.battery_mah * 1000 / avg_ua / 24, mean, percentile(latencies, 0.95)))
+
+
+if __name__ == "__main__":
+    main()
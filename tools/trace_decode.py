@@ -0,0 +1,77 @@
+#!/usr/bin/env python3
+"""Decode a binary trace ring dump (src/includes/trace_log.h) with the firmware ELF.
+
+The event ID of every entry is the offset of its format string in the
+.trace_fmt section of the ELF, which is extracted with objcopy.
+
+The dump is the raw trace_log_t, either read from the diagnostics
+service (characteristic 0x1643) or saved with a debugger, e.g.
+    JLinkExe: savebin trace.bin <address of m_trace_log> <sizeof(trace_log_t)>
+
+Usage:
+    trace_decode.py _build/nrf52840_xxaa.out trace.bin
+"""
+
+import argparse
+import os
+import re
+import struct
+import subprocess
+import sys
+import tempfile
+
+TICKS_PER_S = 32768 // 2  # app_timer runs RTC1 with APP_TIMER_CONFIG_RTC_FREQUENCY 1
+ENTRY = struct.Struct("<IIII")
+PLACEHOLDER = re.compile(r"%[-+ 0#]*\d*(?:\.\d+)?[diuxXc]")
+
+
+def load_formats(elf, objcopy):
+    with tempfile.TemporaryDirectory() as tmp:
+        out = os.path.join(tmp, "trace_fmt.bin")
+        subprocess.run([objcopy, "--dump-section", ".trace_fmt=" + out, elf], check=True)
+        with open(out, "rb") as f:
+            return f.read()
+
+
+def format_at(formats, offset):
+    end = formats.find(b"\0", offset)
+    if offset >= len(formats) or end < 0:
+        return None
+    return formats[offset:end].decode("utf-8", errors="replace")
+
+
+def decode(formats, dump):
+    (written,) = struct.unpack_from("<I", dump, 0)
+    entries = (len(dump) - 4) // ENTRY.size
+    count = min(written, entries)
+    first = written - count
+
+    for seq in range(first, written):
+        ticks, fmt_id, arg0, arg1 = ENTRY.unpack_from(dump, 4 + (seq % entries) * ENTRY.size)
+        fmt = format_at(formats, fmt_id)
+        if fmt is None:
+            text = "<unknown event 0x%X> 0x%X 0x%X" % (fmt_id, arg0, arg1)
+        else:
+            args = (arg0, arg1)[:len(PLACEHOLDER.findall(fmt))]
+            text = PLACEHOLDER.sub(lambda m: m.group(0).replace("u", "d").replace("i", "d"), fmt) % args
+        print("%6u %9.4f  %s" % (seq, ticks / TICKS_PER_S, text))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("elf", help="firmware ELF the dump was taken from")
+    parser.add_argument("dump", help="raw trace_log_t dump")
+    parser.add_argument("--objcopy", default="arm-none-eabi-objcopy")
+    args = parser.parse_args()
+
+    formats = load_formats(args.elf, args.objcopy)
+    with open(args.dump, "rb") as f:
+        dump = f.read()
+    if len(dump) < 4 + ENTRY.size:
+        sys.exit("dump too short")
+
+    decode(formats, dump)
+
+
+if __name__ == "__main__":
+    main()